@@ -0,0 +1,304 @@
+/*******************************************************************************
+** benchMIToolbox.c
+** Benchmark driver for the mutual information toolbox
+**
+** Sweeps the vector length, arity and skew of the inputs across the public
+** kernels, and writes one JSON record per configuration to stdout with the
+** time per sample and the bytes allocated per call. It must be linked
+** against objects compiled with -DUSE_ALLOC_HOOKS (see make bench).
+**
+** usage: bench.out [maxVectorLength] [maxArity]
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/Entropy.h"
+#include "MIToolbox/MutualInformation.h"
+#include "MIToolbox/RenyiEntropy.h"
+#include "MIToolbox/RenyiMutualInformation.h"
+#include "MIToolbox/WeightedEntropy.h"
+#include "MIToolbox/WeightedMutualInformation.h"
+
+/* Each configuration is repeated until it has run for this long */
+#define MIN_SECONDS 0.2
+#define MIN_REPETITIONS 3
+/* Largest histogram (in cells) a configuration may allocate */
+#define MAX_CELLS (1 << 26)
+/* Largest vectorLength * arity for the quadratic numberOfUniqueValues */
+#define MAX_UNIQUE_WORK 1e10
+
+enum kernels {
+  ENTROPY, MUTUAL_INFORMATION, CONDITIONAL_MUTUAL_INFORMATION,
+  RENYI_ENTROPY, RENYI_MI_DIVERGENCE, COLLISION_ENTROPY,
+  COLLISION_MI_DIVERGENCE, MIN_ENTROPY, MIN_MI_DIVERGENCE, WEIGHTED_ENTROPY,
+  WEIGHTED_MUTUAL_INFORMATION, MERGE_ARRAYS, NORMALISE_ARRAY,
+  NUMBER_OF_UNIQUE_VALUES, NUM_KERNELS
+};
+
+static const char *kernelNames[NUM_KERNELS] = {
+  "calcEntropy", "calcMutualInformation", "calcConditionalMutualInformation",
+  "calcRenyiEntropy", "calcRenyiMIDivergence", "calcCollisionEntropy",
+  "calcCollisionMIDivergence", "calcMinEntropy", "calcMinMIDivergence", "calcWeightedEntropy",
+  "calcWeightedMutualInformation", "mergeArrays", "normaliseArray",
+  "numberOfUniqueValues"
+};
+
+/* number of variables whose joint histogram the kernel allocates */
+static const int kernelVariables[NUM_KERNELS] = {1, 2, 3, 1, 2, 1, 2, 1, 2, 1, 2, 2, 1, 1};
+
+static const char *skewNames[2] = {"uniform", "zipf"};
+
+typedef struct benchData
+{
+  uint *firstVector;
+  uint *secondVector;
+  uint *thirdVector;
+  uint *outputVector;
+  double *weightVector;
+  double *doubleVector;
+  double *scratchVector;
+  int vectorLength;
+} BenchData;
+
+static double bytesAllocated = 0.0;
+static volatile double sink = 0.0;
+
+void *hookedCalloc(size_t numElements, size_t sizeOfElement) {
+  bytesAllocated += (double) numElements * sizeOfElement;
+  return calloc(numElements,sizeOfElement);
+}
+
+void hookedFree(void *pointer) {
+  free(pointer);
+}
+
+static double now(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC,&time);
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/*******************************************************************************
+** xorshift generator, so the data is the same on every platform.
+*******************************************************************************/
+static unsigned long nextRandom(unsigned long *state) {
+  unsigned long x = *state;
+  x ^= (x << 13) & 0xFFFFFFFFUL;
+  x ^= x >> 17;
+  x ^= (x << 5) & 0xFFFFFFFFUL;
+  *state = x & 0xFFFFFFFFUL;
+  return *state;
+}
+
+static double nextUniform(unsigned long *state) {
+  return nextRandom(state) / 4294967296.0;
+}
+
+/*******************************************************************************
+** Fills vector with states in [0,arity), either uniformly or from a Zipf
+** distribution with exponent 1.
+*******************************************************************************/
+static void generateVector(uint *vector, int vectorLength, int arity, int skew, unsigned long *state) {
+  double *cumulative;
+  double u;
+  int i, low, high, middle;
+
+  if (skew == 0) {
+    for (i = 0; i < vectorLength; i++) {
+      vector[i] = (uint) (nextUniform(state) * arity);
+    }
+    return;
+  }
+
+  cumulative = (double *) calloc(arity,sizeof(double));
+  cumulative[0] = 1.0;
+  for (i = 1; i < arity; i++) {
+    cumulative[i] = cumulative[i-1] + 1.0 / (i + 1);
+  }
+  for (i = 0; i < vectorLength; i++) {
+    u = nextUniform(state) * cumulative[arity-1];
+    low = 0;
+    high = arity - 1;
+    while (low < high) {
+      middle = (low + high) / 2;
+      if (cumulative[middle] < u) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    vector[i] = low;
+  }
+  free(cumulative);
+}/*generateVector(uint *,int,int,int,unsigned long *)*/
+
+static void runKernel(int kernel, BenchData *data) {
+  int n = data->vectorLength;
+
+  switch (kernel) {
+    case ENTROPY:
+      sink += calcEntropy(data->firstVector,n);
+      break;
+    case MUTUAL_INFORMATION:
+      sink += calcMutualInformation(data->firstVector,data->secondVector,n);
+      break;
+    case CONDITIONAL_MUTUAL_INFORMATION:
+      sink += calcConditionalMutualInformation(data->firstVector,data->secondVector,data->thirdVector,n);
+      break;
+    /* alpha 2 and infinity dispatch to the count based functions below */
+    case RENYI_ENTROPY:
+      sink += calcRenyiEntropy(1.5,data->firstVector,n);
+      break;
+    case RENYI_MI_DIVERGENCE:
+      sink += calcRenyiMIDivergence(1.5,data->firstVector,data->secondVector,n);
+      break;
+    case COLLISION_ENTROPY:
+      sink += calcCollisionEntropy(data->firstVector,n);
+      break;
+    case COLLISION_MI_DIVERGENCE:
+      sink += calcCollisionMIDivergence(data->firstVector,data->secondVector,n);
+      break;
+    case MIN_ENTROPY:
+      sink += calcMinEntropy(data->firstVector,n);
+      break;
+    case MIN_MI_DIVERGENCE:
+      sink += calcMinMIDivergence(data->firstVector,data->secondVector,n);
+      break;
+    case WEIGHTED_ENTROPY:
+      sink += calcWeightedEntropy(data->firstVector,data->weightVector,n);
+      break;
+    case WEIGHTED_MUTUAL_INFORMATION:
+      sink += calcWeightedMutualInformation(data->firstVector,data->secondVector,data->weightVector,n);
+      break;
+    case MERGE_ARRAYS:
+      sink += mergeArrays(data->firstVector,data->secondVector,data->outputVector,n);
+      break;
+    case NORMALISE_ARRAY:
+      sink += normaliseArray(data->doubleVector,data->outputVector,n);
+      break;
+    case NUMBER_OF_UNIQUE_VALUES:
+      /* numberOfUniqueValues overwrites its input */
+      sink += numberOfUniqueValues(data->scratchVector,n);
+      break;
+  }
+}/*runKernel(int,BenchData *)*/
+
+static int skipKernel(int kernel, int vectorLength, int arity) {
+  double cells = pow(arity,kernelVariables[kernel]);
+
+  if (kernel == CONDITIONAL_MUTUAL_INFORMATION) {
+    /* the merged YZ variable is conditioned on, giving an arity^3 histogram */
+    cells = pow(arity,3);
+  }
+  if (cells > MAX_CELLS) {
+    return 1;
+  }
+  if ((kernel == NUMBER_OF_UNIQUE_VALUES) && ((double) vectorLength * arity > MAX_UNIQUE_WORK)) {
+    return 1;
+  }
+  return 0;
+}/*skipKernel(int,int,int)*/
+
+static void benchmark(int kernel, BenchData *data, int arity, int skew, int *first) {
+  double elapsed = 0.0;
+  double start, callBytes = 0.0;
+  int repetitions = 0;
+
+  while ((elapsed < MIN_SECONDS) || (repetitions < MIN_REPETITIONS)) {
+    if (kernel == NUMBER_OF_UNIQUE_VALUES) {
+      memcpy(data->scratchVector,data->doubleVector,data->vectorLength * sizeof(double));
+    }
+    bytesAllocated = 0.0;
+    start = now();
+    runKernel(kernel,data);
+    elapsed += now() - start;
+    callBytes = bytesAllocated;
+    repetitions++;
+  }
+
+  printf("%s  {\"kernel\": \"%s\", \"vectorLength\": %d, \"arity\": %d, \"skew\": \"%s\", "
+         "\"repetitions\": %d, \"nsPerSample\": %.4f, \"bytesAllocated\": %.0f}",
+         *first ? "" : ",\n", kernelNames[kernel], data->vectorLength, arity, skewNames[skew],
+         repetitions, elapsed * 1e9 / repetitions / data->vectorLength, callBytes);
+  fflush(stdout);
+  *first = 0;
+}/*benchmark(int,BenchData *,int,int,int *)*/
+
+int main(int argc, char *argv[]) {
+  static const double lengths[] = {1e3, 1e4, 1e5, 1e6, 1e7, 1e8};
+  static const int arities[] = {2, 10, 100, 1000, 10000, 100000};
+  double maxLength = argc > 1 ? atof(argv[1]) : 1e7;
+  int maxArity = argc > 2 ? atoi(argv[2]) : 100000;
+  unsigned long state = 2463534242UL;
+  BenchData data;
+  int l, a, skew, kernel, i, first = 1;
+
+  printf("[\n");
+  for (l = 0; l < (int) (sizeof(lengths) / sizeof(lengths[0])); l++) {
+    if (lengths[l] > maxLength) {
+      break;
+    }
+    data.vectorLength = (int) lengths[l];
+    data.firstVector = (uint *) calloc(data.vectorLength,sizeof(uint));
+    data.secondVector = (uint *) calloc(data.vectorLength,sizeof(uint));
+    data.thirdVector = (uint *) calloc(data.vectorLength,sizeof(uint));
+    data.outputVector = (uint *) calloc(data.vectorLength,sizeof(uint));
+    data.weightVector = (double *) calloc(data.vectorLength,sizeof(double));
+    data.doubleVector = (double *) calloc(data.vectorLength,sizeof(double));
+    data.scratchVector = (double *) calloc(data.vectorLength,sizeof(double));
+    if ((data.firstVector == NULL) || (data.secondVector == NULL) || (data.thirdVector == NULL) || (data.outputVector == NULL)
+        || (data.weightVector == NULL) || (data.doubleVector == NULL) || (data.scratchVector == NULL)) {
+      fprintf(stderr, "Failed to allocate vectors of length %d\n", data.vectorLength);
+      return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < data.vectorLength; i++) {
+      data.weightVector[i] = nextUniform(&state);
+    }
+
+    for (a = 0; a < (int) (sizeof(arities) / sizeof(arities[0])); a++) {
+      if ((arities[a] > maxArity) || (arities[a] > data.vectorLength)) {
+        break;
+      }
+      for (skew = 0; skew < 2; skew++) {
+        generateVector(data.firstVector,data.vectorLength,arities[a],skew,&state);
+        generateVector(data.secondVector,data.vectorLength,arities[a],skew,&state);
+        generateVector(data.thirdVector,data.vectorLength,arities[a],skew,&state);
+        for (i = 0; i < data.vectorLength; i++) {
+          data.doubleVector[i] = data.firstVector[i] + 0.5;
+        }
+
+        for (kernel = 0; kernel < NUM_KERNELS; kernel++) {
+          if (!skipKernel(kernel,data.vectorLength,arities[a])) {
+            benchmark(kernel,&data,arities[a],skew,&first);
+          }
+        }
+      }
+    }
+
+    free(data.firstVector);
+    free(data.secondVector);
+    free(data.thirdVector);
+    free(data.outputVector);
+    free(data.weightVector);
+    free(data.doubleVector);
+    free(data.scratchVector);
+  }
+  printf("\n]\n");
+
+  return EXIT_SUCCESS;
+}/*main(int, char **)*/
@@ -92,6 +92,44 @@ int discAndMergeArraysArities(double *firstVector, int numFirstStates, double *s
 int mergeMultipleArrays(double *inputMatrix, uint *outputVector, int matrixWidth, int vectorLength);
 int mergeMultipleArraysArities(double *inputMatrix, uint *outputVector, int matrixWidth, int *arities, int vectorLength);
 
+/*******************************************************************************
+** compactMergeArrays writes the joint state of the two arrays to the output
+** vector as 0-based codes numbered in order of first appearance, and returns
+** the number of joint states which occur. Unlike mergeArrays it never
+** allocates a map over every possible joint state, switching to a hash table
+** when there are more possible states than samples.
+**
+** compactMergeMultipleArrays does the same for all the columns of a fortran
+** style (column-major) matrix in a single pass, rather than merging them
+** pairwise.
+**
+** the length of the vectors must be the same and equal to vectorLength
+** outputVector may be one of the inputs
+*******************************************************************************/
+int compactMergeArrays(uint *firstVector, uint *secondVector, uint *outputVector, int vectorLength);
+int compactMergeMultipleArrays(uint *inputMatrix, uint *outputVector, int matrixWidth, int vectorLength);
+
+/*******************************************************************************
+** The Uint and Uint8 versions of mergeMultipleArrays and
+** mergeMultipleArraysArities take matrices which already hold integer states
+** from 0, so no column is discretised or copied. They write 0-based joint
+** states to outputVector and return the number of states they can take.
+**
+** Each row's joint state is its mixed radix key
+** x_0 + arity_0 * (x_1 + arity_1 * (x_2 + ...)), when there are at most
+** vectorLength possible states (or INT_MAX for the Arities versions).
+** Otherwise the states are compacted as in compactMergeMultipleArrays, and
+** the number of states which occur is returned.
+** The Arities versions return -1 if a column has more states than its arity.
+**
+** the length of the columns must be the same and equal to vectorLength
+** matrixWidth = the number of columns in the matrix
+*******************************************************************************/
+int mergeMultipleArraysUint(uint *inputMatrix, uint *outputVector, int matrixWidth, int vectorLength);
+int mergeMultipleArraysUint8(unsigned char *inputMatrix, uint *outputVector, int matrixWidth, int vectorLength);
+int mergeMultipleArraysAritiesUint(uint *inputMatrix, uint *outputVector, int matrixWidth, int *arities, int vectorLength);
+int mergeMultipleArraysAritiesUint8(unsigned char *inputMatrix, uint *outputVector, int matrixWidth, int *arities, int vectorLength);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,110 @@
+/*******************************************************************************
+** BatchInformation.h
+** Part of the mutual information toolbox
+**
+** Contains functions to calculate the mutual information I(X_j;Y), and the
+** conditional mutual information I(X_j;Y|Z), of every column X_j of a
+** feature matrix with the same target Y and condition Z. Everything which
+** depends only on Y and Z is calculated once, each column needs a single
+** counting pass, and the columns are processed in parallel when compiled
+** with OpenMP. The training fold mutual informations used in
+** cross-validation are found by subtracting each held out fold's histogram
+** from the full histogram. For multiple targets the samples are streamed in
+** blocks, and each block of the features updates the histograms of every
+** target while it is in cache.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __BatchInformation_H
+#define __BatchInformation_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** calcMutualInformationBatch writes I(X_j;Y) in log base LOG_BASE for each
+** column j of the fortran style (column-major) featureMatrix into
+** outputVector.
+**
+** featureMatrix has numSamples rows and numFeatures columns,
+** length(targetVector) == numSamples and
+** length(outputVector) == numFeatures, otherwise there will be a
+** segmentation fault
+*******************************************************************************/
+void calcMutualInformationBatch(uint *featureMatrix, uint *targetVector, int numSamples, int numFeatures, double *outputVector);
+
+/*******************************************************************************
+** calcConditionalMutualInformationBatch writes I(X_j;Y|Z) in log base
+** LOG_BASE for each column j of featureMatrix into outputVector. The joint
+** state YZ and the H(YZ) and H(Z) terms are calculated once, and the H(XZ)
+** term of each column is summed out of its (X,YZ) histogram.
+**
+** length(targetVector) == length(conditionVector) == numSamples
+*******************************************************************************/
+void calcConditionalMutualInformationBatch(uint *featureMatrix, uint *targetVector, uint *conditionVector,
+                                           int numSamples, int numFeatures, double *outputVector);
+
+/*******************************************************************************
+** calcMutualInformationFoldBatch writes I(X_j;Y) in log base LOG_BASE
+** calculated on each training fold, i.e. on all the samples except those
+** with foldVector[i] == k, for each column j of featureMatrix. The value for
+** fold k and column j is written to outputMatrix[k + numFolds*j]. Each
+** column is counted once into per-fold histograms, and each training fold
+** histogram is the full histogram minus that fold's histogram.
+**
+** foldVector[i] < numFolds,
+** length(foldVector) == numSamples and
+** length(outputMatrix) == numFolds * numFeatures, otherwise there will be a
+** segmentation fault
+*******************************************************************************/
+void calcMutualInformationFoldBatch(uint *featureMatrix, uint *targetVector, uint *foldVector,
+                                    int numSamples, int numFeatures, int numFolds, double *outputMatrix);
+
+/*******************************************************************************
+** calcMutualInformationMultiTarget writes I(X;Y_t) in log base LOG_BASE for
+** each of the numTargets vectors in targetVectors into outputVector.
+**
+** length(targetVectors[t]) == vectorLength and
+** length(outputVector) == numTargets
+*******************************************************************************/
+void calcMutualInformationMultiTarget(uint *dataVector, uint **targetVectors, int numTargets, int vectorLength,
+                                      double *outputVector);
+
+/*******************************************************************************
+** calcMutualInformationMultiTargetBatch writes I(X_j;Y_t) in log base
+** LOG_BASE for each column j of featureMatrix and column t of the fortran
+** style targetMatrix into outputMatrix[j + numFeatures*t], i.e. a
+** numFeatures x numTargets column-major matrix.
+**
+** targetMatrix has numSamples rows and numTargets columns and
+** length(outputMatrix) == numFeatures * numTargets
+*******************************************************************************/
+void calcMutualInformationMultiTargetBatch(uint *featureMatrix, uint *targetMatrix, int numSamples, int numFeatures,
+                                           int numTargets, double *outputMatrix);
+
+/*******************************************************************************
+** calcPairwiseMutualInformation writes I(X_i;X_j) in log base LOG_BASE for
+** every pair of columns of featureMatrix into outputMatrix[i + numFeatures*j].
+** The blocks of pairs below the diagonal are not counted, and are copied
+** from the blocks above it.
+**
+** length(outputMatrix) == numFeatures * numFeatures
+*******************************************************************************/
+void calcPairwiseMutualInformation(uint *featureMatrix, int numSamples, int numFeatures, double *outputMatrix);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,69 @@
+/*******************************************************************************
+** BiasCorrection.h
+** Part of the mutual information toolbox
+**
+** Contains bias corrected estimates of the entropy, mutual information and
+** conditional mutual information, using the Miller-Madow correction or the
+** leave-one-out jackknife. Removing a sample only changes the counts of the
+** states it falls in, and every sample in the same joint state gives the
+** same leave-one-out estimate, so the jackknife is calculated from the
+** integer histograms in O(states) rather than with n recalculations.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __BiasCorrection_H
+#define __BiasCorrection_H
+
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/JointCounts.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** The Miller-Madow estimates add (m - 1)/2n nats to each plug-in entropy,
+** where m is the number of occupied states, so I(X;Y) is corrected by
+** (m_x + m_y - m_xy - 1)/2n and I(X;Y|Z) by (m_xz + m_yz - m_xyz - m_z)/2n.
+**
+** The jackknife estimates are n*plugin - (n-1)*mean(leave-one-out plugin).
+** They fall back to the plug-in estimate when there are fewer than two
+** samples.
+**
+** All the estimates are in log base LOG_BASE, and may be negative.
+**
+** length(vectors) == vectorLength otherwise there will be a segmentation
+** fault
+*******************************************************************************/
+double calcMillerMadowEntropy(uint *dataVector, int vectorLength);
+double calcMillerMadowMutualInformation(uint *dataVector, uint *targetVector, int vectorLength);
+double calcMillerMadowConditionalMutualInformation(uint *dataVector, uint *targetVector, uint *conditionVector, int vectorLength);
+
+double calcJackknifeEntropy(uint *dataVector, int vectorLength);
+double calcJackknifeMutualInformation(uint *dataVector, uint *targetVector, int vectorLength);
+double calcJackknifeConditionalMutualInformation(uint *dataVector, uint *targetVector, uint *conditionVector, int vectorLength);
+
+/*******************************************************************************
+** The same estimates calculated from a JointCounts, following the
+** conventions of the counts functions in JointCounts.h.
+*******************************************************************************/
+double countsMillerMadowEntropy(JointCounts counts);
+double countsMillerMadowMutualInformation(JointCounts counts);
+double countsMillerMadowConditionalMutualInformation(JointCounts counts);
+
+double countsJackknifeEntropy(JointCounts counts);
+double countsJackknifeMutualInformation(JointCounts counts);
+double countsJackknifeConditionalMutualInformation(JointCounts counts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -59,6 +59,32 @@ typedef struct wpState
   int numStates;
 } WeightedProbState;
 
+typedef struct wsSum
+{
+  double count;
+  double weight;
+} WeightedStateSum;
+
+/*******************************************************************************
+** A WeightedWorkspace holds the count and the weight sum of each state
+** interleaved, so the hot states of a weighted calculation share a cache
+** line. It is reused across calls, and only grows when it sees more states.
+** The joint state (x,y) is stored at jointStates[x + numFirstStates*y].
+*******************************************************************************/
+typedef struct wwState
+{
+  WeightedStateSum *jointStates;
+  int numJointStates;
+  WeightedStateSum *firstStates;
+  int numFirstStates;
+  WeightedStateSum *secondStates;
+  int numSecondStates;
+  int jointCapacity;
+  int firstCapacity;
+  int secondCapacity;
+  double length;
+} WeightedWorkspace;
+
 /*******************************************************************************
 ** calculateJointProbability returns the joint probability vector of two vectors
 ** and the marginal probability vectors in a struct.
@@ -126,6 +152,25 @@ WeightedProbState calculateWeightedProbability(uint *dataVector, double *weightV
 *******************************************************************************/
 WeightedProbState discAndCalcWeightedProbability(double *dataVector, double *weightVector, int vectorLength);
 
+/*******************************************************************************
+** createWeightedWorkspace returns an empty workspace, which must be freed
+** with freeWeightedWorkspace.
+**
+** calculateWeightedWorkspace fills the workspace with the counts and weight
+** sums of the joint states of firstVector and secondVector in one pass,
+** allocating only if there are more states than in any previous call.
+** secondVector may be NULL, in which case it has a single state.
+*******************************************************************************/
+WeightedWorkspace createWeightedWorkspace(void);
+void calculateWeightedWorkspace(WeightedWorkspace *workspace, uint *firstVector, uint *secondVector, double *weightVector, int vectorLength);
+
+/*******************************************************************************
+** sumWeightLogCount returns \sum_s weight(s) \log count(s) over the states
+** with a non-zero count, and totalWeight the sum of weights. These are the
+** terms the workspace entropies and mutual informations are built from.
+*******************************************************************************/
+double sumWeightLogCount(WeightedStateSum *states, int numStates, double *totalWeight);
+
 /*******************************************************************************
 ** Frees the struct members and sets all pointers to NULL.
 *******************************************************************************/
@@ -133,6 +178,7 @@ void freeProbabilityState(ProbabilityState state);
 void freeJointProbabilityState(JointProbabilityState state);
 void freeWeightedProbState(WeightedProbState state);
 void freeWeightedJointProbState(WeightedJointProbState state);
+void freeWeightedWorkspace(WeightedWorkspace workspace);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,53 @@
+/*******************************************************************************
+** ChowLiuTree.h
+** Part of the mutual information toolbox
+**
+** Contains functions to build the Chow-Liu dependency tree of the columns of
+** a feature matrix, i.e. the maximum spanning tree of the complete graph
+** weighted by the pairwise mutual information I(X_i;X_j). The tree can be
+** built with Prim's algorithm on the full pairwise matrix, or with Boruvka's
+** algorithm streaming blocks of the matrix, so that the p x p matrix is never
+** stored for very wide data.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __ChowLiuTree_H
+#define __ChowLiuTree_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** Both functions write the tree rooted at column 0 into parentVector, where
+** parentVector[j] is the parent of column j and parentVector[0] == -1, and
+** return the total weight of the tree in log base LOG_BASE.
+**
+** calcChowLiuTree stores the numFeatures x numFeatures pairwise matrix.
+**
+** calcChowLiuTreeStreaming stores blockSize x numFeatures of the matrix at a
+** time (a blockSize below 1 uses 64), and recalculates the mutual
+** informations between the components in each of its O(log numFeatures)
+** rounds.
+**
+** featureMatrix is a fortran style (column-major) matrix with numSamples
+** rows and numFeatures columns, and length(parentVector) == numFeatures,
+** otherwise there will be a segmentation fault
+*******************************************************************************/
+double calcChowLiuTree(uint *featureMatrix, int numSamples, int numFeatures, int *parentVector);
+double calcChowLiuTreeStreaming(uint *featureMatrix, int numSamples, int numFeatures, int blockSize, int *parentVector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,58 @@
+/*******************************************************************************
+** DataReader.h
+** Part of the mutual information toolbox
+**
+** Contains functions to read CSV and LibSVM files directly into a
+** DiscreteMatrix. Each column is dictionary encoded while parsing, so the
+** result is ready for the uint functions without a separate discretisation
+** pass. When compiled with OpenMP the file is split into byte ranges which
+** are parsed in parallel.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __DataReader_H
+#define __DataReader_H
+
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/DiscreteMatrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** readCSVFile reads a delimited file into matrix. Each field is treated as a
+** categorical token (after trimming whitespace), and the tokens in each
+** column are numbered from 0 in the order they first appear in the file.
+** If hasHeader is non-zero the first line is skipped. Quoted fields are not
+** supported.
+**
+** Returns 0 on success, and -1 if the file can't be read or the rows
+** have different numbers of fields.
+*******************************************************************************/
+int readCSVFile(const char *fileName, char delimiter, int hasHeader, DiscreteMatrix *matrix);
+
+/*******************************************************************************
+** readLibSVMFile reads a LibSVM format file ("label index:value ...") into
+** matrix. Column 0 holds the label, and column j holds feature index j.
+** In the feature columns state 0 is the value zero, which includes any
+** feature missing from a line, and the other values are numbered from 1 in
+** the order they first appear.
+**
+** Returns 0 on success, and -1 if the file can't be read or is malformed.
+*******************************************************************************/
+int readLibSVMFile(const char *fileName, DiscreteMatrix *matrix);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,125 @@
+/*******************************************************************************
+** DiscreteMatrix.h
+** Part of the mutual information toolbox
+**
+** Contains a column-major matrix of discrete features with their arities,
+** and functions to write it to and memory map it from a columnar binary file
+** so it can be used without parsing or discretising the data again.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __DiscreteMatrix_H
+#define __DiscreteMatrix_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** A fortran style (column-major) matrix of states, where feature j is
+** matrix[j*numSamples .. (j+1)*numSamples - 1] and takes values in
+** [0, arities[j]).
+*******************************************************************************/
+typedef struct dmState
+{
+  uint *matrix;
+  int *arities;
+  int numSamples;
+  int numFeatures;
+} DiscreteMatrix;
+
+/*******************************************************************************
+** A DiscreteMatrix file mapped into memory. Each column is stored with a
+** code width of 1, 2 or 4 bytes, and columns with width 4 can be passed
+** straight to the uint functions without copying. Columns with width 1 or 2
+** can be read in place through mappedColumnUint8 or mappedColumnUint16.
+*******************************************************************************/
+typedef struct mmState
+{
+  unsigned char *mapping;
+  size_t mappingLength;
+  unsigned char **columns;
+  int *codeWidths;
+  int *arities;
+  int numSamples;
+  int numFeatures;
+} MappedMatrix;
+
+/*******************************************************************************
+** The file format is a 32 byte header, followed by a 16 byte descriptor
+** per column, followed by the column blocks, each aligned to 64 bytes.
+**
+** header:     char[8] magic "MITXDMAT", uint32 version, uint32 byte order
+**             marker 0x01020304, uint32 numSamples, uint32 numFeatures,
+**             8 bytes reserved.
+** descriptor: uint32 arity, uint32 codeWidth, uint32 offset low word,
+**             uint32 offset high word.
+**
+** All values are in native byte order so the columns can be used in place,
+** and a file written on a machine with a different byte order is rejected.
+*******************************************************************************/
+
+/*******************************************************************************
+** writeDiscreteMatrix writes matrix to fileName. If compact is non-zero
+** each column uses the smallest code width which holds its arity, otherwise
+** every column is stored as uint so it can be used without copying.
+** Returns 0 on success and -1 on failure, including when a column holds a
+** code which is not below its arity, in which case nothing is written.
+*******************************************************************************/
+int writeDiscreteMatrix(const char *fileName, DiscreteMatrix matrix, int compact);
+
+/*******************************************************************************
+** mapDiscreteMatrix memory maps fileName into matrix, returning 0 on
+** success and -1 if the file can't be read or is malformed, including when
+** a column holds a code which is not below its stored arity. Checking the
+** codes reads every column once.
+** mapDiscreteMatrixUnvalidated skips the code check, so it only touches the
+** pages which are later used. It is unsafe on untrusted files, as code
+** which sizes a count array from the stored arity will write out of bounds
+** on a code outside it.
+** The mapping is private, so writing to a column doesn't change the file.
+*******************************************************************************/
+int mapDiscreteMatrix(const char *fileName, MappedMatrix *matrix);
+int mapDiscreteMatrixUnvalidated(const char *fileName, MappedMatrix *matrix);
+
+/*******************************************************************************
+** mappedColumn returns the column as a uint vector without copying, or
+** NULL if the column is stored with a narrower code width.
+** mappedColumnUint8 and mappedColumnUint16 do the same for columns with a
+** code width of 1 and 2.
+** copyMappedColumn widens any column into outputVector, which must have
+** numSamples elements.
+*******************************************************************************/
+uint *mappedColumn(MappedMatrix matrix, int column);
+unsigned char *mappedColumnUint8(MappedMatrix matrix, int column);
+unsigned short *mappedColumnUint16(MappedMatrix matrix, int column);
+void copyMappedColumn(MappedMatrix matrix, int column, uint *outputVector);
+
+/*******************************************************************************
+** generateMappedIntIndices returns the same 2D representation as
+** generateIntIndices, pointing into the mapping. It returns NULL if any
+** column is stored with a code width narrower than uint.
+*******************************************************************************/
+uint **generateMappedIntIndices(MappedMatrix matrix);
+
+/*******************************************************************************
+** Frees the struct members, and unmaps the file.
+*******************************************************************************/
+void freeDiscreteMatrix(DiscreteMatrix matrix);
+void unmapDiscreteMatrix(MappedMatrix matrix);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
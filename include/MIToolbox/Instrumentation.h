@@ -0,0 +1,105 @@
+/*******************************************************************************
+** Instrumentation.h
+** Part of the mutual information toolbox
+**
+** Contains optional per-thread counters which record how many calls were
+** made, how many samples and histogram cells they processed, how many bytes
+** they allocated, and how long they spent in each phase (discretisation,
+** finding the number of states, counting, evaluating the logs, and
+** allocation). The library records into them only when compiled with
+** MITOOLBOX_INSTRUMENT defined (see make instrument), otherwise the
+** INSTRUMENT_* macros expand to nothing and the counters stay at zero.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __Instrumentation_H
+#define __Instrumentation_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum instrumentPhase
+{
+  NORMALISE_PHASE, MAX_STATE_PHASE, COUNTING_PHASE, LOG_PHASE, ALLOC_PHASE,
+  NUM_INSTRUMENT_PHASES
+} InstrumentPhase;
+
+/*******************************************************************************
+** calls counts the top-level calculations (e.g. calcMutualInformation, but
+** not the calcConditionalEntropy calls made inside
+** calcConditionalMutualInformation), and samples is the sum of their
+** vectorLengths. cells counts the histogram cells allocated, and
+** phaseSeconds holds the time spent in each phase, excluding any phase
+** nested inside it.
+*******************************************************************************/
+typedef struct icState
+{
+  unsigned long calls;
+  unsigned long allocations;
+  double samples;
+  double cells;
+  double bytesAllocated;
+  double phaseSeconds[NUM_INSTRUMENT_PHASES];
+} InstrumentCounters;
+
+/*******************************************************************************
+** Called at the end of every top-level calculation on the thread which made
+** it, with the name of the function and the counters for that call alone.
+*******************************************************************************/
+typedef void (*InstrumentCallback)(const char *functionName, const InstrumentCounters *callCounters, void *userData);
+
+/*******************************************************************************
+** snapshotInstrumentCounters copies the counters of the calling thread into
+** counters, and resetInstrumentCounters sets them to zero.
+*******************************************************************************/
+void snapshotInstrumentCounters(InstrumentCounters *counters);
+void resetInstrumentCounters(void);
+
+/*******************************************************************************
+** Sets the callback for all threads, or removes it if callback is NULL. It
+** should not be changed while another thread is calculating.
+*******************************************************************************/
+void setInstrumentCallback(InstrumentCallback callback, void *userData);
+
+/*******************************************************************************
+** Recording functions used by the INSTRUMENT_* macros.
+*******************************************************************************/
+void instrumentEnter(const char *functionName, int vectorLength);
+void instrumentExit(void);
+void instrumentPhaseBegin(InstrumentPhase phase);
+void instrumentPhaseEnd(void);
+void instrumentCells(double cells);
+void instrumentAllocation(double bytes);
+
+#ifdef MITOOLBOX_INSTRUMENT
+  #define INSTRUMENT_ENTER(name,length) instrumentEnter(name,length)
+  #define INSTRUMENT_EXIT() instrumentExit()
+  #define INSTRUMENT_PHASE_BEGIN(phase) instrumentPhaseBegin(phase)
+  #define INSTRUMENT_PHASE_END() instrumentPhaseEnd()
+  #define INSTRUMENT_CELLS(cells) instrumentCells(cells)
+  #define INSTRUMENT_ALLOCATION(bytes) instrumentAllocation(bytes)
+#else
+  #define INSTRUMENT_ENTER(name,length) ((void) 0)
+  #define INSTRUMENT_EXIT() ((void) 0)
+  #define INSTRUMENT_PHASE_BEGIN(phase) ((void) 0)
+  #define INSTRUMENT_PHASE_END() ((void) 0)
+  #define INSTRUMENT_CELLS(cells) ((void) 0)
+  #define INSTRUMENT_ALLOCATION(bytes) ((void) 0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,112 @@
+/*******************************************************************************
+** JointCounts.h
+** Part of the mutual information toolbox
+**
+** Contains a mergeable integer histogram over up to three variables X, Y & Z,
+** which can be built from chunks of data, merged across chunks or processes,
+** serialised into a flat byte buffer, and used to calculate H(X), H(X,Y),
+** H(X|Y), I(X;Y) and I(X;Y|Z).
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __JointCounts_H
+#define __JointCounts_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** The count of the state (x,y,z) is stored at
+** jointCounts[x + numFirstStates*(y + numSecondStates*z)].
+** Unused variables have a single state. The counts are 32-bit, as in the
+** serialised form, so a JointCounts holds at most UINT_MAX samples.
+*******************************************************************************/
+typedef struct jcState
+{
+  uint *jointCounts;
+  int numJointStates;
+  int numFirstStates;
+  int numSecondStates;
+  int numConditionStates;
+  uint numSamples;
+} JointCounts;
+
+/*******************************************************************************
+** calculateJointCounts counts the joint states of firstVector, secondVector
+** and conditionVector. Any of the vectors may be NULL, in which case that
+** variable has a single state. Passing all NULLs with vectorLength == 0
+** creates an empty JointCounts. If the joint table would have more than
+** INT_MAX states it returns an empty JointCounts with jointCounts == NULL and
+** every state count 0. The counts functions treat it as having no samples,
+** and it can be accumulated into, merged and serialised like any other.
+**
+** length(vectors) == vectorLength otherwise there will be a segmentation fault
+*******************************************************************************/
+JointCounts calculateJointCounts(uint *firstVector, uint *secondVector, uint *conditionVector, int vectorLength);
+
+/*******************************************************************************
+** accumulateJointCounts adds the joint states of another chunk of data into
+** counts, growing the number of states of each variable if necessary.
+** A NULL vector is treated as a vector of zeros.
+** Returns 0 on success, or -1 leaving counts unchanged if the grown table
+** would have more than INT_MAX states, or the counts would pass UINT_MAX
+** samples.
+*******************************************************************************/
+int accumulateJointCounts(JointCounts *counts, uint *firstVector, uint *secondVector, uint *conditionVector, int vectorLength);
+
+/*******************************************************************************
+** mergeJointCounts adds the counts in source into destination. If the
+** arities differ the destination is grown to the larger arity of each
+** variable, so states line up as long as both were coded the same way.
+** Returns 0 on success, or -1 leaving destination unchanged if the grown
+** table would have more than INT_MAX states, or the merged counts would pass
+** UINT_MAX samples.
+*******************************************************************************/
+int mergeJointCounts(JointCounts *destination, JointCounts source);
+
+/*******************************************************************************
+** Serialisation to a flat buffer of little-endian 32-bit words, suitable
+** for pipes, shared memory or files.
+** serialisedJointCountsSize returns the number of bytes required.
+** serialiseJointCounts writes the counts into buffer and returns the number
+** of bytes written.
+** deserialiseJointCounts reads a buffer written by serialiseJointCounts,
+** returning 0 on success and -1 if the buffer is truncated or malformed,
+** including when the counts don't sum to the number of samples.
+*******************************************************************************/
+size_t serialisedJointCountsSize(JointCounts counts);
+size_t serialiseJointCounts(JointCounts counts, unsigned char *buffer);
+int deserialiseJointCounts(unsigned char *buffer, size_t bufferLength, JointCounts *counts);
+
+/*******************************************************************************
+** Functions which calculate information theoretic quantities in log base
+** LOG_BASE from the counts. The entropies and I(X;Y) ignore the condition
+** variable, and H(X) ignores the second variable.
+*******************************************************************************/
+double countsEntropy(JointCounts counts);
+double countsJointEntropy(JointCounts counts);
+double countsConditionalEntropy(JointCounts counts);
+double countsMutualInformation(JointCounts counts);
+double countsConditionalMutualInformation(JointCounts counts);
+
+/*******************************************************************************
+** Frees the struct members.
+*******************************************************************************/
+void freeJointCounts(JointCounts counts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
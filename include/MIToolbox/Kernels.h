@@ -0,0 +1,89 @@
+/*******************************************************************************
+** Kernels.h
+** Part of the mutual information toolbox
+**
+** Contains the inner loops used by the probability, entropy and mutual
+** information functions. On x86 the loops are compiled once per instruction
+** set (SSE4.2, AVX2, AVX-512) and the best variant the CPU supports is chosen
+** when the library is loaded. The variant can be forced with the
+** MITOOLBOX_KERNELS environment variable or setKernelVariant, e.g. to
+** validate against the scalar loops.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __Kernels_H
+#define __Kernels_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** The ISA variants are only built by the Makefile on x86 C builds. Define
+** MITOOLBOX_SCALAR_ONLY when compiling src/Kernels.c by hand to use just the
+** scalar loops.
+*******************************************************************************/
+#if defined(C_IMPLEMENTATION) && !defined(MITOOLBOX_SCALAR_ONLY) && \
+    defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define MITOOLBOX_MULTI_ISA
+#endif
+
+typedef struct ktState
+{
+  const char *name;
+  /* returns max(vector) + 1 */
+  int (*maxState)(uint *vector, int vectorLength);
+  /* writes floor(inputVector) to outputVector, and its min and max */
+  void (*floorArray)(double *inputVector, int *outputVector, int vectorLength, int *minVal, int *maxVal);
+  /* writes inputVector - offset to outputVector */
+  void (*offsetArray)(int *inputVector, uint *outputVector, int vectorLength, int offset);
+  /* writes firstVector + secondVector * numFirstStates to outputVector */
+  void (*jointIndices)(uint *firstVector, uint *secondVector, int numFirstStates, uint *outputVector, int vectorLength);
+  /* adds the state counts of the vectors to the (zeroed) count arrays */
+  void (*countStates)(uint *vector, int vectorLength, int *counts);
+  void (*countJointStates)(uint *firstVector, uint *secondVector, int numFirstStates, int vectorLength,
+                           int *firstCounts, int *secondCounts, int *jointCounts);
+  /* writes counts / length to probabilities */
+  void (*countsToProbabilities)(int *counts, double *probabilities, int numStates, double length);
+  /* natural log reductions used by entropy, condEntropy and mi */
+  double (*entropySum)(double *probabilities, int numStates);
+  double (*condEntropySum)(double *jointProbabilities, double *secondProbabilities, int numFirstStates, int numJointStates);
+  double (*miSum)(double *jointProbabilities, double *firstProbabilities, double *secondProbabilities,
+                  int numFirstStates, int numJointStates);
+  /* natural log reductions used by wEntropy, wCondEntropy and wmi */
+  double (*weightedEntropySum)(double *probabilities, double *weights, int numStates);
+  double (*weightedCondEntropySum)(double *jointProbabilities, double *jointWeights, double *secondProbabilities,
+                                   int numFirstStates, int numJointStates);
+  double (*weightedMISum)(double *jointProbabilities, double *jointWeights, double *firstProbabilities,
+                          double *secondProbabilities, int numFirstStates, int numJointStates);
+} KernelTable;
+
+/*******************************************************************************
+** The kernels in use, which is never NULL.
+*******************************************************************************/
+extern const KernelTable *activeKernels;
+
+/*******************************************************************************
+** setKernelVariant switches to the named variant ("scalar", "sse4.2", "avx2"
+** or "avx512f"), returning 0 on success and -1 if the variant is unknown,
+** not built, or not supported by the CPU. It should not be called while
+** another thread is calculating. kernelVariant returns the current name.
+*******************************************************************************/
+int setKernelVariant(const char *variantName);
+const char *kernelVariant(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
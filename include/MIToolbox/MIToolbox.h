@@ -2,11 +2,13 @@
 ** MIToolbox.h
 ** Provides the header files and #defines to ensure compatibility with MATLAB
 ** and C/C++. By default it compiles to MATLAB, if COMPILE_C is defined it
-** links to the C memory allocation functions.
+** links to the C memory allocation functions, or to hookedCalloc/hookedFree
+** if USE_ALLOC_HOOKS is also defined.
 **
 ** Author: Adam Pocock
 ** Created: 17/2/2010
 ** Modified: 24/06/2011 - added log base #define
+** Modified: 18/10/2026 - added allocation hooks for benchmarking
 **
 **  Copyright 2010-2017 Adam Pocock, The University Of Manchester
 **  www.cs.manchester.ac.uk
@@ -31,8 +33,16 @@ typedef unsigned int uint;
   #define C_IMPLEMENTATION
   #include <stdio.h>
   #include <stdlib.h>
-  #define CALLOC_FUNC(a,b) calloc(a,b)
-  #define FREE_FUNC(a) free(a)
+  #ifdef USE_ALLOC_HOOKS
+    /* Allocation hooks must be supplied by the program linking MIToolbox */
+    void *hookedCalloc(size_t numElements, size_t sizeOfElement);
+    void hookedFree(void *pointer);
+    #define CALLOC_FUNC(a,b) hookedCalloc(a,b)
+    #define FREE_FUNC(a) hookedFree(a)
+  #else
+    #define CALLOC_FUNC(a,b) calloc(a,b)
+    #define FREE_FUNC(a) free(a)
+  #endif
 #elif defined(COMPILE_R)
   #define R_IMPLEMENTATION
   #include "R.h"
@@ -0,0 +1,59 @@
+/*******************************************************************************
+** MultiInformation.h
+** Part of the mutual information toolbox
+**
+** Contains functions to calculate the multi-information (total
+** correlation), the interaction information, and the sums of the entropies
+** of every subset of a set of variables. The N-way histogram of the
+** variables is counted once, and the histogram of each subset is found by
+** summing out axes of a larger histogram, so the data is only read to
+** build the first one.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __MultiInformation_H
+#define __MultiInformation_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** The variables are the columns of the fortran style (column-major)
+** dataMatrix, which has vectorLength rows and numVariables columns. All the
+** values are in log base LOG_BASE.
+**
+** calcMultiInformation returns the total correlation
+** \sum_i H(X_i) - H(X_1,...,X_N).
+**
+** calcInteractionInformation returns the co-information
+** -\sum_{S} (-1)^{|S|} H(X_S) over the non-empty subsets S, which is
+** I(X;Y) for two variables and I(X;Y) - I(X;Y|Z) for three.
+**
+** calcSubsetEntropySums writes \sum_{|S| = k} H(X_S) to outputVector[k-1]
+** for k = 1...numVariables.
+**
+** The last two visit all 2^numVariables subsets. The histograms are dense
+** while they have few cells relative to the samples, and otherwise hold
+** only the occupied joint states.
+**
+** length(outputVector) == numVariables
+*******************************************************************************/
+double calcMultiInformation(uint *dataMatrix, int vectorLength, int numVariables);
+double calcInteractionInformation(uint *dataMatrix, int vectorLength, int numVariables);
+void calcSubsetEntropySums(uint *dataMatrix, int vectorLength, int numVariables, double *outputVector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
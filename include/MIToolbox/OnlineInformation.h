@@ -0,0 +1,118 @@
+/*******************************************************************************
+** OnlineInformation.h
+** Part of the mutual information toolbox
+**
+** Contains streaming accumulators for the entropy H(X), the mutual
+** information I(X;Y) and the conditional mutual information I(X;Y|Z).
+** Samples can be added and removed in O(1), so the accumulators can track
+** a sliding window. The number of states grows on demand.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __OnlineInformation_H
+#define __OnlineInformation_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** Each accumulator stores the integer counts for every marginal it needs.
+** Adding or removing a sample updates the counts in O(1), and the value is
+** calculated from the counts when it is requested, in probability buffers
+** which are allocated by the first value call and reused until the number
+** of states grows.
+*******************************************************************************/
+typedef struct oeState
+{
+  uint *counts;
+  double *probabilities;
+  int numStates;
+  uint numSamples;
+} OnlineEntropy;
+
+typedef struct omiState
+{
+  uint *jointCounts;
+  uint *firstCounts;
+  uint *secondCounts;
+  double *jointProbabilities;
+  double *firstProbabilities;
+  double *secondProbabilities;
+  int numFirstStates;
+  int numSecondStates;
+  uint numSamples;
+} OnlineMI;
+
+typedef struct ocmiState
+{
+  uint *jointCounts;
+  uint *firstCondCounts;
+  uint *secondCondCounts;
+  uint *condCounts;
+  double *jointProbabilities;
+  double *secondProbabilities;
+  int numFirstStates;
+  int numSecondStates;
+  int numConditionStates;
+  uint numSamples;
+} OnlineCMI;
+
+/*******************************************************************************
+** createOnline* allocates an empty accumulator. The number of states is a
+** hint, and grows automatically when a larger state is added. Hints whose
+** table would have more than INT_MAX states are ignored.
+*******************************************************************************/
+OnlineEntropy createOnlineEntropy(int numStates);
+OnlineMI createOnlineMI(int numFirstStates, int numSecondStates);
+OnlineCMI createOnlineCMI(int numFirstStates, int numSecondStates, int numConditionStates);
+
+/*******************************************************************************
+** online*Add adds a single sample to the accumulator, returning 0 on success
+** and -1 if a value is INT_MAX or larger, or the count table would need more
+** than INT_MAX states. The accumulator is unchanged on failure.
+** online*Remove removes a single sample, returning 0 on success and -1 if
+** that sample is not present in the accumulator.
+*******************************************************************************/
+int onlineEntropyAdd(OnlineEntropy *accumulator, uint dataValue);
+int onlineEntropyRemove(OnlineEntropy *accumulator, uint dataValue);
+int onlineMIAdd(OnlineMI *accumulator, uint dataValue, uint targetValue);
+int onlineMIRemove(OnlineMI *accumulator, uint dataValue, uint targetValue);
+int onlineCMIAdd(OnlineCMI *accumulator, uint dataValue, uint targetValue, uint conditionValue);
+int onlineCMIRemove(OnlineCMI *accumulator, uint dataValue, uint targetValue, uint conditionValue);
+
+/*******************************************************************************
+** online*Value returns the log base LOG_BASE value of H(X), I(X;Y) or
+** I(X;Y|Z) for the samples currently in the accumulator, in time linear in
+** the number of states. H(X) and I(X;Y) use the same probabilities and sums
+** as calcEntropy and calcMutualInformation, so they return exactly the same
+** value on those samples, however the window was built up. I(X;Y|Z) is
+** H(X|Z) - H(X|YZ) as in calcConditionalMutualInformation, which numbers the
+** YZ states by first appearance, so it can differ from that in the last bits.
+*******************************************************************************/
+double onlineEntropyValue(OnlineEntropy *accumulator);
+double onlineMIValue(OnlineMI *accumulator);
+double onlineCMIValue(OnlineCMI *accumulator);
+
+/*******************************************************************************
+** Frees the struct members.
+*******************************************************************************/
+void freeOnlineEntropy(OnlineEntropy accumulator);
+void freeOnlineMI(OnlineMI accumulator);
+void freeOnlineCMI(OnlineCMI accumulator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -46,11 +46,41 @@ double discAndCalcRenyiEntropy(double alpha, double *dataVector, int vectorLengt
 double calcJointRenyiEntropy(double alpha, uint *firstVector, uint *secondVector, int vectorLength);
 double discAndCalcJointRenyiEntropy(double alpha, double *firstVector, double *secondVector, int vectorLength);
 
+/*******************************************************************************
+** The collision entropy H_2(X) and the min-entropy H_\infty(X) calculated
+** from sum(c^2) and max(c) of the integer state counts, without a pow or log
+** per state. The alpha functions use these automatically when alpha == 2 or
+** alpha == HUGE_VAL.
+*******************************************************************************/
+double calcCollisionEntropy(uint *dataVector, int vectorLength);
+double calcJointCollisionEntropy(uint *firstVector, uint *secondVector, int vectorLength);
+double calcMinEntropy(uint *dataVector, int vectorLength);
+double calcJointMinEntropy(uint *firstVector, uint *secondVector, int vectorLength);
+
+/*******************************************************************************
+** The multi alpha functions write the Renyi entropy for each of the numAlphas
+** values in alphas into outputVector, building the histogram only once.
+**
+** length(alphas) == length(outputVector) == numAlphas
+*******************************************************************************/
+void calcMultiAlphaRenyiEntropy(double *alphas, int numAlphas, uint *dataVector, int vectorLength, double *outputVector);
+void discAndCalcMultiAlphaRenyiEntropy(double *alphas, int numAlphas, double *dataVector, int vectorLength, double *outputVector);
+void calcMultiAlphaJointRenyiEntropy(double *alphas, int numAlphas, uint *firstVector, uint *secondVector, int vectorLength, double *outputVector);
+void discAndCalcMultiAlphaJointRenyiEntropy(double *alphas, int numAlphas, double *firstVector, double *secondVector, int vectorLength, double *outputVector);
+
 /*******************************************************************************
 ** Inner functions which operate on state structs.
 *******************************************************************************/
 double renyiEntropy(ProbabilityState state, double alpha);
 double jointRenyiEntropy(JointProbabilityState state, double alpha);
+void multiAlphaRenyiEntropy(ProbabilityState state, double *alphas, int numAlphas, double *outputVector);
+void multiAlphaJointRenyiEntropy(JointProbabilityState state, double *alphas, int numAlphas, double *outputVector);
+
+/*******************************************************************************
+** Returns value^alpha, using repeated multiplication when alpha is an
+** integer, and pow otherwise.
+*******************************************************************************/
+double alphaPower(double value, double alpha);
 
 #ifdef __cplusplus
 }
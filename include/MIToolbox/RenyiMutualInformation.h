@@ -37,6 +37,14 @@ extern "C" {
 double calcRenyiMIDivergence(double alpha, uint *dataVector, uint *targetVector, int vectorLength);
 double discAndCalcRenyiMIDivergence(double alpha, double *dataVector, double *targetVector, int vectorLength);
 
+/*******************************************************************************
+** The alpha = 2 and alpha = \infty divergences calculated from the integer
+** joint counts, without a pow or log per state. The alpha functions use
+** these automatically when alpha == 2 or alpha == HUGE_VAL.
+*******************************************************************************/
+double calcCollisionMIDivergence(uint *dataVector, uint *targetVector, int vectorLength);
+double calcMinMIDivergence(uint *dataVector, uint *targetVector, int vectorLength);
+
 /****************************************************************************** 
 ** This function returns a different value to the alpha divergence mutual 
 ** information, and thus is not a correct mutual information.
@@ -45,10 +53,23 @@ double discAndCalcRenyiMIDivergence(double alpha, double *dataVector, double *ta
 double calcRenyiMIJoint(double alpha, uint *dataVector, uint *targetVector, int vectorLength);
 double discAndCalcRenyiMIJoint(double alpha, double *dataVector, double *targetVector, int vectorLength);
 
+/*******************************************************************************
+** The multi alpha functions write the value for each of the numAlphas values
+** in alphas into outputVector, from a single joint histogram.
+**
+** length(alphas) == length(outputVector) == numAlphas
+*******************************************************************************/
+void calcMultiAlphaRenyiMIDivergence(double *alphas, int numAlphas, uint *dataVector, uint *targetVector, int vectorLength, double *outputVector);
+void discAndCalcMultiAlphaRenyiMIDivergence(double *alphas, int numAlphas, double *dataVector, double *targetVector, int vectorLength, double *outputVector);
+void calcMultiAlphaRenyiMIJoint(double *alphas, int numAlphas, uint *dataVector, uint *targetVector, int vectorLength, double *outputVector);
+void discAndCalcMultiAlphaRenyiMIJoint(double *alphas, int numAlphas, double *dataVector, double *targetVector, int vectorLength, double *outputVector);
+
 /*******************************************************************************
 ** Inner functions which operate on state structs.
 *******************************************************************************/
 double renyiMI(JointProbabilityState state, double alpha);
+void multiAlphaRenyiMI(JointProbabilityState state, double *alphas, int numAlphas, double *outputVector);
+void multiAlphaRenyiMIJoint(JointProbabilityState state, double *alphas, int numAlphas, double *outputVector);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,89 @@
+/*******************************************************************************
+** Resampling.h
+** Part of the mutual information toolbox
+**
+** Contains permutation tests for the mutual information, and bootstrap
+** confidence intervals for the entropy, mutual information and conditional
+** mutual information. The marginal histograms are unchanged by permuting a
+** variable, so each permutation only recounts the joint histogram, and each
+** bootstrap replicate redraws the counts of the occupied joint states
+** without touching the samples. Replicates are generated from a seeded
+** generator and run in parallel when compiled with OpenMP, and a given seed
+** gives the same answer for any number of threads.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __Resampling_H
+#define __Resampling_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ptState
+{
+  double mutualInformation;
+  double pValue;
+  int numPermutations;
+} PermutationTest;
+
+/*******************************************************************************
+** calcMutualInformationPermutationTest returns I(X;Y) in log base LOG_BASE
+** with its permutation p-value, (1 + r) / (1 + m), where r of the m
+** replicates with a permuted targetVector had at least the observed I(X;Y).
+**
+** At most numPermutations replicates are run, in blocks. After each block
+** the test stops if the p-value is more than 3 binomial standard errors
+** above or below threshold, and numPermutations in the result is the number
+** which were run. A threshold <= 0 runs them all.
+**
+** length(dataVector) == length(targetVector) == vectorLength otherwise there
+** will be a segmentation fault
+*******************************************************************************/
+PermutationTest calcMutualInformationPermutationTest(uint *dataVector, uint *targetVector, int vectorLength,
+                                                     int numPermutations, double threshold, unsigned long seed);
+
+typedef struct ciState
+{
+  double estimate;
+  double lower;
+  double upper;
+} ConfidenceInterval;
+
+/*******************************************************************************
+** The bootstrap functions return the plug-in estimate in log base LOG_BASE
+** with a percentile confidence interval containing the central confidence
+** (e.g. 0.95) of numReplicates Poisson bootstrap replicates. confidence must
+** be in (0,1), and otherwise, or if numReplicates < 1, the interval is just
+** the estimate.
+**
+** Giving each sample a Poisson(1) weight makes the count of a joint state
+** with c samples Poisson(c), so each replicate costs one draw per occupied
+** joint state rather than one per sample.
+**
+** length(vectors) == vectorLength otherwise there will be a segmentation
+** fault
+*******************************************************************************/
+ConfidenceInterval calcEntropyBootstrap(uint *dataVector, int vectorLength,
+                                        int numReplicates, double confidence, unsigned long seed);
+ConfidenceInterval calcMutualInformationBootstrap(uint *dataVector, uint *targetVector, int vectorLength,
+                                                  int numReplicates, double confidence, unsigned long seed);
+ConfidenceInterval calcConditionalMutualInformationBootstrap(uint *dataVector, uint *targetVector, uint *conditionVector,
+                                                             int vectorLength, int numReplicates, double confidence,
+                                                             unsigned long seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,52 @@
+/*******************************************************************************
+** SegmentedInformation.h
+** Part of the mutual information toolbox
+**
+** Contains functions to calculate H(X), I(X;Y) and H(X|Y) separately within
+** each segment of the samples, given a vector of segment ids (e.g. a
+** customer segment). All the segments are counted in a single pass over the
+** data, and the values are calculated in parallel across segments when
+** compiled with OpenMP.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __SegmentedInformation_H
+#define __SegmentedInformation_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** Each function writes the value for the samples with segmentVector[i] == s
+** to outputVector[s], in log base LOG_BASE. Segments with no samples are
+** given 0. The states of each variable are shared across the segments, so
+** the values are the same as slicing out each segment and calling
+** calcEntropy, calcMutualInformation or calcConditionalEntropy.
+**
+** segmentVector[i] < numSegments,
+** length(vectors) == vectorLength and
+** length(outputVector) == numSegments, otherwise there will be a
+** segmentation fault
+*******************************************************************************/
+void calcSegmentedEntropy(uint *dataVector, uint *segmentVector, int vectorLength,
+                          int numSegments, double *outputVector);
+void calcSegmentedMutualInformation(uint *dataVector, uint *targetVector, uint *segmentVector, int vectorLength,
+                                    int numSegments, double *outputVector);
+void calcSegmentedConditionalEntropy(uint *dataVector, uint *conditionVector, uint *segmentVector, int vectorLength,
+                                     int numSegments, double *outputVector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
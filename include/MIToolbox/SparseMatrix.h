@@ -0,0 +1,85 @@
+/*******************************************************************************
+** SparseMatrix.h
+** Part of the mutual information toolbox
+**
+** Contains a compressed sparse column (CSC) matrix of discrete features, and
+** functions to calculate the mutual information of sparse features with a
+** dense target, and between pairs of sparse features. State 0 is implicit,
+** so the cost is proportional to the number of non-zeros rather than the
+** number of samples.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __SparseMatrix_H
+#define __SparseMatrix_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** The non-zero states of column j are values[columnPointers[j] ..
+** columnPointers[j+1] - 1], in rows rowIndices[columnPointers[j] ..
+** columnPointers[j+1] - 1]. The row indices must be increasing within each
+** column, and every other entry of the column is state 0.
+*******************************************************************************/
+typedef struct smState
+{
+  uint *values;
+  int *rowIndices;
+  int *columnPointers;
+  int numRows;
+  int numColumns;
+} SparseMatrix;
+
+/*******************************************************************************
+** compressSparseMatrix builds a SparseMatrix from a fortran style
+** (column-major) matrix, dropping all the zero states.
+*******************************************************************************/
+SparseMatrix compressSparseMatrix(uint *featureMatrix, int numRows, int numColumns);
+
+/*******************************************************************************
+** calcSparseMutualInformation returns the log base LOG_BASE mutual
+** information between column and targetVector, I(X;Y).
+**
+** length(targetVector) == matrix.numRows otherwise there will be a
+** segmentation fault
+*******************************************************************************/
+double calcSparseMutualInformation(SparseMatrix matrix, int column, uint *targetVector);
+
+/*******************************************************************************
+** calcSparseMutualInformationTarget writes I(X_j;Y) for every column j into
+** outputVector, which must have matrix.numColumns elements. The target
+** marginal is calculated once, and columns are processed in parallel when
+** compiled with OpenMP.
+*******************************************************************************/
+void calcSparseMutualInformationTarget(SparseMatrix matrix, uint *targetVector, double *outputVector);
+
+/*******************************************************************************
+** calcSparsePairwiseMutualInformation returns I(X_i;X_j) between two
+** columns. calcSparsePairwiseMutualInformationMatrix writes all the pairs
+** into the fortran style numColumns x numColumns outputMatrix.
+*******************************************************************************/
+double calcSparsePairwiseMutualInformation(SparseMatrix matrix, int firstColumn, int secondColumn);
+void calcSparsePairwiseMutualInformationMatrix(SparseMatrix matrix, double *outputMatrix);
+
+/*******************************************************************************
+** Frees the struct members.
+*******************************************************************************/
+void freeSparseMatrix(SparseMatrix matrix);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,61 @@
+/*******************************************************************************
+** TimeSeriesInformation.h
+** Part of the mutual information toolbox
+**
+** Contains functions to calculate the time lagged mutual information
+** I(X_{t-l};Y_t) and the transfer entropy from X to Y of two time series.
+** The lagged variables are read at an offset into the series rather than
+** copied, and a sweep over many lags counts every lag's histogram in one
+** blocked pass over the series, in parallel across lags when compiled with
+** OpenMP.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __TimeSeriesInformation_H
+#define __TimeSeriesInformation_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** calcLaggedMutualInformation returns I(X_{t-lag};Y_t) in log base LOG_BASE,
+** over the vectorLength - lag times t where both are defined. It returns 0
+** if lag < 0 or lag >= vectorLength.
+**
+** calcLaggedMutualInformationSweep writes I(X_{t-l};Y_t) for
+** l = 1...maxLag to outputVector[l-1].
+**
+** length(sourceVector) == length(targetVector) == vectorLength and
+** length(outputVector) == maxLag, otherwise there will be a segmentation
+** fault
+*******************************************************************************/
+double calcLaggedMutualInformation(uint *sourceVector, uint *targetVector, int vectorLength, int lag);
+void calcLaggedMutualInformationSweep(uint *sourceVector, uint *targetVector, int vectorLength, int maxLag,
+                                      double *outputVector);
+
+/*******************************************************************************
+** calcTransferEntropy returns the transfer entropy from X to Y in log base
+** LOG_BASE,
+**   TE = I(Y_t ; X_{t-sourceLag} | Y_{t-1},...,Y_{t-historyLength}),
+** over the times t where all the variables are defined. The target history
+** is merged into a single state, and the other variables are offsets into
+** the series. It returns 0 if sourceLag or historyLength is below 1, or
+** there are no such times.
+*******************************************************************************/
+double calcTransferEntropy(uint *sourceVector, uint *targetVector, int vectorLength, int sourceLag, int historyLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
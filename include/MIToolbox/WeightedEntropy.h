@@ -53,11 +53,24 @@ double calcWeightedConditionalEntropy(uint *dataVector, uint *conditionVector, d
 double discAndCalcWeightedConditionalEntropy(double *dataVector, double *conditionVector, double *weightVector, int vectorLength);
 
 /*******************************************************************************
-** Inner functions which operate on state structs.
+** The workspace functions return the same values as calcWeightedEntropy and
+** calcWeightedConditionalEntropy, accumulating into workspace so repeated
+** calls (e.g. one per boosting round with new weights) allocate nothing
+** once it has grown to the number of states. The workspace is created with
+** createWeightedWorkspace and must not be shared between threads.
+*******************************************************************************/
+double calcWorkspaceWeightedEntropy(WeightedWorkspace *workspace, uint *dataVector, double *weightVector, int vectorLength);
+double calcWorkspaceWeightedConditionalEntropy(WeightedWorkspace *workspace, uint *dataVector, uint *conditionVector, double *weightVector, int vectorLength);
+
+/*******************************************************************************
+** Inner functions which operate on state structs. The workspace functions
+** return H_w(X) and H_w(X|Y) of the first and second variables.
 *******************************************************************************/
 double wEntropy(WeightedProbState state);
 double wJointEntropy(WeightedJointProbState state);
 double wCondEntropy(WeightedJointProbState state);
+double workspaceWEntropy(WeightedWorkspace workspace);
+double workspaceWCondEntropy(WeightedWorkspace workspace);
 
 #ifdef __cplusplus
 }
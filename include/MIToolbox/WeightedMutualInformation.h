@@ -46,10 +46,51 @@ double discAndCalcWeightedMutualInformation(double *dataVector, double *targetVe
 double calcWeightedConditionalMutualInformation(uint *dataVector, uint *targetVector, uint *conditionVector, double *weightVector, int vectorLength);
 double discAndCalcWeightedConditionalMutualInformation(double *dataVector, double *targetVector, double *conditionVector, double *weightVector, int vectorLength);
 
+/*******************************************************************************
+** calcWorkspaceWeightedMutualInformation returns the same value as
+** calcWeightedMutualInformation, accumulating into workspace so repeated
+** calls with new weights allocate nothing (see WeightedEntropy.h).
+*******************************************************************************/
+double calcWorkspaceWeightedMutualInformation(WeightedWorkspace *workspace, uint *dataVector, uint *targetVector, double *weightVector, int vectorLength);
+
+/*******************************************************************************
+** A WeightedMIBatch stores the joint state of every sample of each feature
+** with a target, and the pointwise mutual information
+** \log n c(x,y) / (c(x)c(y)) of each joint state, neither of which depends
+** on the weights. Feature j's joint states are
+** jointIndices[j*numSamples .. (j+1)*numSamples - 1], which index
+** pointwiseMI + tableOffsets[j].
+*******************************************************************************/
+typedef struct wbState
+{
+  uint *jointIndices;
+  double *pointwiseMI;
+  size_t *tableOffsets;
+  int numSamples;
+  int numFeatures;
+} WeightedMIBatch;
+
+/*******************************************************************************
+** createWeightedMIBatch builds the batch from a fortran style (column-major)
+** featureMatrix with numSamples rows and numFeatures columns.
+**
+** calcWeightedMIBatch writes I_w(X_j;Y) for each feature j into outputVector
+** (length numFeatures), the same value as calcWeightedMutualInformation.
+** As the joint states are fixed each call (e.g. each boosting round) is a
+** single weighted sum over the samples per feature, in parallel across
+** features when compiled with OpenMP, and it allocates nothing.
+**
+** length(weightVector) == numSamples otherwise it will segmentation fault
+*******************************************************************************/
+WeightedMIBatch createWeightedMIBatch(uint *featureMatrix, uint *targetVector, int numSamples, int numFeatures);
+void calcWeightedMIBatch(WeightedMIBatch batch, double *weightVector, double *outputVector);
+void freeWeightedMIBatch(WeightedMIBatch batch);
+
 /*******************************************************************************
 ** Inner functions which operate on state structs.
 *******************************************************************************/
 double wmi(WeightedJointProbState state);
+double workspaceWMI(WeightedWorkspace workspace);
 
 #ifdef __cplusplus
 }
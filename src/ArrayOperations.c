@@ -16,11 +16,20 @@
  *******************************************************************************/
 
 #include <errno.h>
+#include <limits.h>
+#include <stdint.h>
 #include "MIToolbox/MIToolbox.h"
 #include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/Instrumentation.h"
+#include "MIToolbox/Kernels.h"
 
 void* checkedCalloc(size_t vectorLength, size_t sizeOfType) {
-    void *allocated = CALLOC_FUNC(vectorLength, sizeOfType);
+    void *allocated;
+
+    INSTRUMENT_PHASE_BEGIN(ALLOC_PHASE);
+    allocated = CALLOC_FUNC(vectorLength, sizeOfType);
+    INSTRUMENT_PHASE_END();
+    INSTRUMENT_ALLOCATION((double) vectorLength * sizeOfType);
     if(allocated == NULL) {
 #ifdef MEX_IMPLEMENTATION
         /* This call returns control to Matlab, with the associated error message */
@@ -89,14 +98,11 @@ double **generateDoubleIndices(double *featureMatrix, uint noOfSamples, uint noO
 }
 
 int maxState(uint *vector, int vectorLength) {
-    int i, max;
-    max = 0;
-    for (i = 0; i < vectorLength; i++) {
-        if (vector[i] > max) {
-            max = vector[i];
-        }
-    }
-    return max + 1;
+    int numStates;
+    INSTRUMENT_PHASE_BEGIN(MAX_STATE_PHASE);
+    numStates = activeKernels->maxState(vector,vectorLength);
+    INSTRUMENT_PHASE_END();
+    return numStates;
 }
 
 int numberOfUniqueValues(double *featureVector, int vectorLength) {
@@ -107,6 +113,7 @@ int numberOfUniqueValues(double *featureVector, int vectorLength) {
     int j = 0;
     int i;
 
+    INSTRUMENT_PHASE_BEGIN(NORMALISE_PHASE);
     for (i = 0; i < vectorLength; i++) {
         found = 0;
         j = 0;
@@ -123,6 +130,7 @@ int numberOfUniqueValues(double *featureVector, int vectorLength) {
             featureVector[i] = (double) uniqueValues;
         }
     }/*for vectorlength*/
+    INSTRUMENT_PHASE_END();
 
     FREE_FUNC(valuesArray);
     valuesArray = NULL;
@@ -142,34 +150,20 @@ int numberOfUniqueValues(double *featureVector, int vectorLength) {
 int normaliseArray(double *inputVector, uint *outputVector, int vectorLength) {
     int minVal = 0;
     int maxVal = 0;
-    int currentValue;
-    int i;
 
+    INSTRUMENT_PHASE_BEGIN(NORMALISE_PHASE);
     if (vectorLength > 0) {
         int* tempVector = (int*) checkedCalloc(vectorLength,sizeof(int));
-        minVal = (int) floor(inputVector[0]);
-        maxVal = (int) floor(inputVector[0]);
-
-        for (i = 0; i < vectorLength; i++) {
-            currentValue = (int) floor(inputVector[i]);
-            tempVector[i] = currentValue;
-
-            if (currentValue < minVal) {
-                minVal = currentValue;
-            } else if (currentValue > maxVal) {
-                maxVal = currentValue;
-            }
-        }/*for loop over vector*/
 
-        for (i = 0; i < vectorLength; i++) {
-            outputVector[i] = tempVector[i] - minVal;
-        }
+        activeKernels->floorArray(inputVector,tempVector,vectorLength,&minVal,&maxVal);
+        activeKernels->offsetArray(tempVector,outputVector,vectorLength,minVal);
 
         maxVal = (maxVal - minVal) + 1;
 
         FREE_FUNC(tempVector);
         tempVector = NULL;
     }
+    INSTRUMENT_PHASE_END();
 
     return maxVal;
 }/*normaliseArray(double*,double*,int)*/
@@ -189,14 +183,19 @@ int mergeArrays(uint *firstVector, uint *secondVector, uint *outputVector, int v
     int stateCount = 1;
     int i, curIndex;
 
+    INSTRUMENT_CELLS((double) firstNumStates * secondNumStates);
+    INSTRUMENT_PHASE_BEGIN(COUNTING_PHASE);
+    /* The joint indices are calculated in place, so outputVector may alias the inputs */
+    activeKernels->jointIndices(firstVector,secondVector,firstNumStates,outputVector,vectorLength);
     for (i = 0; i < vectorLength; i++) {
-        curIndex = firstVector[i] + (secondVector[i] * firstNumStates);
+        curIndex = outputVector[i];
         if (stateMap[curIndex] == 0) {
             stateMap[curIndex] = stateCount;
             stateCount++;
         }
         outputVector[i] = stateMap[curIndex];
     }
+    INSTRUMENT_PHASE_END();
 
     FREE_FUNC(stateMap);
     stateMap = NULL;
@@ -340,3 +339,326 @@ int mergeMultipleArraysArities(double *inputMatrix, uint *outputVector, int matr
     return currentNumStates;
 }/*mergeMultipleArraysArities(double *, double *, int, int)*/
 
+#define UINT64_CONSTANT(high,low) (((uint64_t) (high) << 32) | (uint64_t) (low))
+
+/* Rows per block of the key pass, and the length above which it runs in parallel */
+#define MERGE_BLOCK_LENGTH 4096
+#define PARALLEL_MERGE_LENGTH 65536
+
+/*******************************************************************************
+** The columns being merged, which are either uint or unsigned char.
+*******************************************************************************/
+typedef struct mcState
+{
+    uint **columns;
+    unsigned char **byteColumns;
+    int numColumns;
+} MergeColumns;
+
+/* splitmix64 finaliser, so sequential keys spread over the table */
+static uint64_t mixKey(uint64_t key) {
+    key ^= key >> 30;
+    key *= UINT64_CONSTANT(0xbf58476dUL,0x1ce4e5b9UL);
+    key ^= key >> 27;
+    key *= UINT64_CONSTANT(0x94d049bbUL,0x133111ebUL);
+    key ^= key >> 31;
+    return key;
+}/*mixKey(uint64_t)*/
+
+static uint columnValue(MergeColumns *merge, int column, int row) {
+    return merge->columns != NULL ? merge->columns[column][row] : merge->byteColumns[column][row];
+}/*columnValue(MergeColumns *,int,int)*/
+
+static int sameRow(MergeColumns *merge, int firstRow, int secondRow) {
+    int j;
+
+    for (j = 0; j < merge->numColumns; j++) {
+        if (columnValue(merge,j,firstRow) != columnValue(merge,j,secondRow)) {
+            return 0;
+        }
+    }
+    return 1;
+}/*sameRow(MergeColumns *,int,int)*/
+
+static int byteMaxState(unsigned char *vector, int vectorLength) {
+    int max = 0;
+    int i;
+
+    for (i = 0; i < vectorLength; i++) {
+        max = vector[i] > max ? vector[i] : max;
+    }
+    return vectorLength > 0 ? max + 1 : 0;
+}/*byteMaxState(unsigned char *,int)*/
+
+/*******************************************************************************
+** Replaces each key with its 0-based code in order of first appearance using
+** an open addressing hash table, and returns the number of distinct keys.
+** If rows is not NULL the keys are hashes of the rows, and rows with equal
+** hashes are compared state by state.
+*******************************************************************************/
+static int relabelKeys(uint64_t *keys, MergeColumns *rows, int vectorLength) {
+    size_t tableSize = 16;
+    size_t mask, slot;
+    uint64_t *tableKeys;
+    uint *tableCodes;
+    int *tableRows = NULL;
+    int stateCount = 0;
+    int i;
+
+    while (tableSize < 2 * (size_t) vectorLength) {
+        tableSize *= 2;
+    }
+    mask = tableSize - 1;
+    tableKeys = (uint64_t *) checkedCalloc(tableSize,sizeof(uint64_t));
+    tableCodes = (uint *) checkedCalloc(tableSize,sizeof(uint));
+    if (rows != NULL) {
+        tableRows = (int *) checkedCalloc(tableSize,sizeof(int));
+    }
+
+    /* tableCodes holds code + 1, so 0 marks an empty slot */
+    for (i = 0; i < vectorLength; i++) {
+        slot = mixKey(keys[i]) & mask;
+        while ((tableCodes[slot] != 0) &&
+               ((tableKeys[slot] != keys[i]) || ((rows != NULL) && !sameRow(rows,tableRows[slot],i)))) {
+            slot = (slot + 1) & mask;
+        }
+        if (tableCodes[slot] == 0) {
+            tableKeys[slot] = keys[i];
+            tableCodes[slot] = ++stateCount;
+            if (rows != NULL) {
+                tableRows[slot] = i;
+            }
+        }
+        keys[i] = tableCodes[slot] - 1;
+    }
+
+    FREE_FUNC(tableKeys);
+    FREE_FUNC(tableCodes);
+    if (tableRows != NULL) {
+        FREE_FUNC(tableRows);
+    }
+    tableKeys = NULL;
+    tableCodes = NULL;
+    tableRows = NULL;
+
+    return stateCount;
+}/*relabelKeys(uint64_t *,MergeColumns *,int)*/
+
+/*******************************************************************************
+** Writes the mixed radix key (or the row hash if strides is NULL) of rows
+** [start,end) into keys. Each block of rows stays in cache while every
+** column is added into it.
+*******************************************************************************/
+static void blockKeys(MergeColumns *merge, uint64_t *strides, uint64_t *keys, int start, int end) {
+    uint *column;
+    unsigned char *byteColumn;
+    int i, j;
+
+    for (i = start; i < end; i++) {
+        keys[i] = 0;
+    }
+    for (j = 0; j < merge->numColumns; j++) {
+        if (merge->columns != NULL) {
+            column = merge->columns[j];
+            if (strides != NULL) {
+                for (i = start; i < end; i++) {
+                    keys[i] += column[i] * strides[j];
+                }
+            } else {
+                for (i = start; i < end; i++) {
+                    keys[i] = mixKey(keys[i] + column[i]);
+                }
+            }
+        } else {
+            byteColumn = merge->byteColumns[j];
+            if (strides != NULL) {
+                for (i = start; i < end; i++) {
+                    keys[i] += byteColumn[i] * strides[j];
+                }
+            } else {
+                for (i = start; i < end; i++) {
+                    keys[i] = mixKey(keys[i] + byteColumn[i]);
+                }
+            }
+        }
+    }
+}/*blockKeys(MergeColumns *,uint64_t *,uint64_t *,int,int)*/
+
+/*******************************************************************************
+** Builds a mixed radix key for each row when the product of the arities fits
+** in 64 bits, and a row hash otherwise, in parallel over blocks of rows.
+**
+** If the product is at most keyLimit the keys are written out as the codes
+** and the product is returned. Otherwise the keys are relabelled to 0-based
+** codes in order of first appearance, through a dense map when the product
+** is at most vectorLength (as in mergeArrays) and a hash table when it isn't,
+** and the number of codes is returned.
+**
+** arities may be NULL, in which case they are found from the columns.
+*******************************************************************************/
+static int mergeColumns(MergeColumns *merge, int *arities, uint64_t keyLimit, uint *outputVector, int vectorLength) {
+    uint64_t *keys;
+    uint64_t *strides;
+    uint64_t product = 1;
+    uint64_t arity;
+    uint *stateMap;
+    int fitsKey = 1;
+    int stateCount = 0;
+    int numBlocks = (vectorLength + MERGE_BLOCK_LENGTH - 1) / MERGE_BLOCK_LENGTH;
+    int block, i, j;
+
+    if (vectorLength == 0) {
+        return 0;
+    }
+
+    keys = (uint64_t *) checkedCalloc(vectorLength,sizeof(uint64_t));
+    strides = (uint64_t *) checkedCalloc(merge->numColumns + 1,sizeof(uint64_t));
+
+    INSTRUMENT_PHASE_BEGIN(MAX_STATE_PHASE);
+    for (j = 0; j < merge->numColumns; j++) {
+        if (arities != NULL) {
+            arity = arities[j];
+        } else if (merge->columns != NULL) {
+            arity = maxState(merge->columns[j],vectorLength);
+        } else {
+            arity = byteMaxState(merge->byteColumns[j],vectorLength);
+        }
+        if ((arity > 0) && (arity > ~((uint64_t) 0) / product)) {
+            fitsKey = 0;
+            break;
+        }
+        strides[j] = product;
+        product *= arity;
+    }
+    INSTRUMENT_PHASE_END();
+
+    INSTRUMENT_PHASE_BEGIN(COUNTING_PHASE);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if (vectorLength >= PARALLEL_MERGE_LENGTH)
+#endif
+    for (block = 0; block < numBlocks; block++) {
+        int end = (block + 1) * MERGE_BLOCK_LENGTH;
+        blockKeys(merge,fitsKey ? strides : NULL,keys,block * MERGE_BLOCK_LENGTH,end < vectorLength ? end : vectorLength);
+    }
+
+    if (fitsKey && (product <= keyLimit)) {
+        stateCount = (int) product;
+    } else if (fitsKey && (product <= (uint64_t) vectorLength)) {
+        INSTRUMENT_CELLS((double) product);
+        stateMap = (uint *) checkedCalloc((size_t) product,sizeof(uint));
+        for (i = 0; i < vectorLength; i++) {
+            if (stateMap[keys[i]] == 0) {
+                stateMap[keys[i]] = ++stateCount;
+            }
+            keys[i] = stateMap[keys[i]] - 1;
+        }
+        FREE_FUNC(stateMap);
+        stateMap = NULL;
+    } else {
+        stateCount = relabelKeys(keys,fitsKey ? NULL : merge,vectorLength);
+    }
+
+    /* the inputs are only read before this point, so outputVector may alias them */
+    for (i = 0; i < vectorLength; i++) {
+        outputVector[i] = (uint) keys[i];
+    }
+    INSTRUMENT_PHASE_END();
+
+    FREE_FUNC(keys);
+    FREE_FUNC(strides);
+    keys = NULL;
+    strides = NULL;
+
+    return stateCount;
+}/*mergeColumns(MergeColumns *,int *,uint64_t,uint *,int)*/
+
+int compactMergeArrays(uint *firstVector, uint *secondVector, uint *outputVector, int vectorLength) {
+    MergeColumns merge;
+    uint *columns[2];
+
+    columns[0] = firstVector;
+    columns[1] = secondVector;
+    merge.columns = columns;
+    merge.byteColumns = NULL;
+    merge.numColumns = 2;
+
+    return mergeColumns(&merge,NULL,0,outputVector,vectorLength);
+}/*compactMergeArrays(uint *,uint *,uint *,int)*/
+
+/*******************************************************************************
+** Merges the columns of a fortran style matrix of uint (if inputMatrix is not
+** NULL) or unsigned char (if byteMatrix is not NULL).
+*******************************************************************************/
+static int mergeMatrix(uint *inputMatrix, unsigned char *byteMatrix, int *arities, uint64_t keyLimit,
+                       uint *outputVector, int matrixWidth, int vectorLength) {
+    MergeColumns merge;
+    int stateCount, j;
+
+    merge.columns = NULL;
+    merge.byteColumns = NULL;
+    merge.numColumns = matrixWidth;
+    if (inputMatrix != NULL) {
+        merge.columns = (uint **) checkedCalloc(matrixWidth > 0 ? matrixWidth : 1,sizeof(uint *));
+        for (j = 0; j < matrixWidth; j++) {
+            merge.columns[j] = inputMatrix + (size_t) j * vectorLength;
+        }
+    } else {
+        merge.byteColumns = (unsigned char **) checkedCalloc(matrixWidth > 0 ? matrixWidth : 1,sizeof(unsigned char *));
+        for (j = 0; j < matrixWidth; j++) {
+            merge.byteColumns[j] = byteMatrix + (size_t) j * vectorLength;
+        }
+    }
+
+    stateCount = mergeColumns(&merge,arities,keyLimit,outputVector,vectorLength);
+
+    if (merge.columns != NULL) {
+        FREE_FUNC(merge.columns);
+    } else {
+        FREE_FUNC(merge.byteColumns);
+    }
+    merge.columns = NULL;
+    merge.byteColumns = NULL;
+
+    return stateCount;
+}/*mergeMatrix(uint *,unsigned char *,int *,uint64_t,uint *,int,int)*/
+
+int compactMergeMultipleArrays(uint *inputMatrix, uint *outputVector, int matrixWidth, int vectorLength) {
+    return mergeMatrix(inputMatrix,NULL,NULL,0,outputVector,matrixWidth,vectorLength);
+}/*compactMergeMultipleArrays(uint *,uint *,int,int)*/
+
+int mergeMultipleArraysUint(uint *inputMatrix, uint *outputVector, int matrixWidth, int vectorLength) {
+    return mergeMatrix(inputMatrix,NULL,NULL,(uint64_t) vectorLength,outputVector,matrixWidth,vectorLength);
+}/*mergeMultipleArraysUint(uint *,uint *,int,int)*/
+
+int mergeMultipleArraysUint8(unsigned char *inputMatrix, uint *outputVector, int matrixWidth, int vectorLength) {
+    return mergeMatrix(NULL,inputMatrix,NULL,(uint64_t) vectorLength,outputVector,matrixWidth,vectorLength);
+}/*mergeMultipleArraysUint8(unsigned char *,uint *,int,int)*/
+
+/*******************************************************************************
+** Checks every column is below its arity, as mergeMultipleArraysArities
+** does, before merging with the caller's arities.
+*******************************************************************************/
+static int mergeMatrixArities(uint *inputMatrix, unsigned char *byteMatrix, uint *outputVector, int matrixWidth, int *arities, int vectorLength) {
+    int numStates, j;
+
+    for (j = 0; j < matrixWidth; j++) {
+        if (inputMatrix != NULL) {
+            numStates = maxState(inputMatrix + (size_t) j * vectorLength,vectorLength);
+        } else {
+            numStates = byteMaxState(byteMatrix + (size_t) j * vectorLength,vectorLength);
+        }
+        if ((numStates > arities[j]) || (arities[j] < 1)) {
+            return -1;
+        }
+    }
+
+    return mergeMatrix(inputMatrix,byteMatrix,arities,(uint64_t) INT_MAX,outputVector,matrixWidth,vectorLength);
+}/*mergeMatrixArities(uint *,unsigned char *,uint *,int,int *,int)*/
+
+int mergeMultipleArraysAritiesUint(uint *inputMatrix, uint *outputVector, int matrixWidth, int *arities, int vectorLength) {
+    return mergeMatrixArities(inputMatrix,NULL,outputVector,matrixWidth,arities,vectorLength);
+}/*mergeMultipleArraysAritiesUint(uint *,uint *,int,int *,int)*/
+
+int mergeMultipleArraysAritiesUint8(unsigned char *inputMatrix, uint *outputVector, int matrixWidth, int *arities, int vectorLength) {
+    return mergeMatrixArities(NULL,inputMatrix,outputVector,matrixWidth,arities,vectorLength);
+}/*mergeMultipleArraysAritiesUint8(unsigned char *,uint *,int,int *,int)*/
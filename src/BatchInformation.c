@@ -0,0 +1,645 @@
+/*******************************************************************************
+** BatchInformation.c
+** Part of the mutual information toolbox
+**
+** Contains functions to calculate the mutual information I(X_j;Y), and the
+** conditional mutual information I(X_j;Y|Z), of every column X_j of a
+** feature matrix with the same target Y and condition Z. Everything which
+** depends only on Y and Z is calculated once, each column needs a single
+** counting pass, and the columns are processed in parallel when compiled
+** with OpenMP. The training fold mutual informations used in
+** cross-validation are found by subtracting each held out fold's histogram
+** from the full histogram. For multiple targets the samples are streamed in
+** blocks, and each block of the features updates the histograms of every
+** target while it is in cache.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/BatchInformation.h"
+#include "MIToolbox/Instrumentation.h"
+#include "CountSums.h"
+
+/* The multiple target functions split the work into tasks of this many
+** features and target groups, and stream the samples in blocks of
+** SAMPLE_BLOCK. Each target group has at most TARGET_GROUP_STATES joint
+** states unless a single target has more. */
+#define FEATURE_BLOCK 8
+#define GROUP_BLOCK 4
+#define SAMPLE_BLOCK 4096
+#define TARGET_GROUP_STATES 256
+/* The blocks are shrunk until the histograms of a task have at most this
+** many cells, and pairs which still don't fit are counted one at a time. */
+#define MAX_TASK_STATES (1 << 22)
+
+/*******************************************************************************
+** Finds the number of states of each column, and the largest of them.
+*******************************************************************************/
+static int *columnStates(uint *featureMatrix, int numSamples, int numFeatures, int *maxStates) {
+  int *numStates = (int *) checkedCalloc(numFeatures > 0 ? numFeatures : 1,sizeof(int));
+  int j;
+
+  *maxStates = 1;
+  for (j = 0; j < numFeatures; j++) {
+    numStates[j] = maxState(featureMatrix + (size_t) j * numSamples,numSamples);
+    if (numStates[j] > *maxStates) {
+      *maxStates = numStates[j];
+    }
+  }
+
+  return numStates;
+}/*columnStates(uint *,int,int,int *)*/
+
+/*******************************************************************************
+** Counts each column against the target, summing c(x) out of c(x,y).
+*******************************************************************************/
+void calcMutualInformationBatch(uint *featureMatrix, uint *targetVector, int numSamples, int numFeatures, double *outputVector) {
+  double length = numSamples;
+  double targetSum;
+  int *targetCounts;
+  int *numStates;
+  int numTargetStates, maxStates, i;
+
+  INSTRUMENT_ENTER("calcMutualInformationBatch",numSamples);
+  numTargetStates = maxState(targetVector,numSamples);
+  numStates = columnStates(featureMatrix,numSamples,numFeatures,&maxStates);
+
+  targetCounts = (int *) checkedCalloc(numTargetStates > 0 ? numTargetStates : 1,sizeof(int));
+  for (i = 0; i < numSamples; i++) {
+    targetCounts[targetVector[i]]++;
+  }
+  targetSum = sumCountLogCount(targetCounts,numTargetStates);
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    int *jointCounts = (int *) checkedCalloc((size_t) maxStates * numTargetStates + 1,sizeof(int));
+    int *firstCounts = (int *) checkedCalloc(maxStates,sizeof(int));
+    int *jointRow;
+    uint *column;
+    int numFirstStates, i, j, x, y;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic,4)
+#endif
+    for (j = 0; j < numFeatures; j++) {
+      column = featureMatrix + (size_t) j * numSamples;
+      numFirstStates = numStates[j];
+      memset(jointCounts,0,(size_t) numFirstStates * numTargetStates * sizeof(int));
+      memset(firstCounts,0,numFirstStates * sizeof(int));
+
+      for (i = 0; i < numSamples; i++) {
+        jointCounts[column[i] + numFirstStates * targetVector[i]]++;
+      }
+      /* the column marginal is summed out of the joint rather than counted */
+      for (y = 0; y < numTargetStates; y++) {
+        jointRow = jointCounts + y * numFirstStates;
+        for (x = 0; x < numFirstStates; x++) {
+          firstCounts[x] += jointRow[x];
+        }
+      }
+
+      outputVector[j] = mutualInformationFromSums(length,sumCountLogCount(jointCounts,numFirstStates * numTargetStates),
+                                                  sumCountLogCount(firstCounts,numFirstStates),targetSum);
+    }
+
+    FREE_FUNC(jointCounts);
+    FREE_FUNC(firstCounts);
+  }
+
+  FREE_FUNC(targetCounts);
+  FREE_FUNC(numStates);
+  targetCounts = NULL;
+  numStates = NULL;
+  INSTRUMENT_EXIT();
+}/*calcMutualInformationBatch(uint *,uint *,int,int,double *)*/
+
+/*******************************************************************************
+** Counts each column against the merged YZ states, summing c(x,z) out of
+** c(x,y,z).
+*******************************************************************************/
+void calcConditionalMutualInformationBatch(uint *featureMatrix, uint *targetVector, uint *conditionVector,
+                                           int numSamples, int numFeatures, double *outputVector) {
+  double length = numSamples;
+  double conditionSum, targetConditionSum;
+  uint *mergedVector;
+  int *mergedCounts, *conditionCounts;
+  int *mergedCondition;
+  int *numStates;
+  int numMergedStates, numConditionStates, maxStates, i;
+
+  INSTRUMENT_ENTER("calcConditionalMutualInformationBatch",numSamples);
+  numStates = columnStates(featureMatrix,numSamples,numFeatures,&maxStates);
+  numConditionStates = maxState(conditionVector,numSamples);
+  mergedVector = (uint *) checkedCalloc(numSamples > 0 ? numSamples : 1,sizeof(uint));
+  numMergedStates = compactMergeArrays(targetVector,conditionVector,mergedVector,numSamples);
+
+  /* mergedCondition maps each YZ state to its Z state */
+  mergedCounts = (int *) checkedCalloc(numMergedStates > 0 ? numMergedStates : 1,sizeof(int));
+  mergedCondition = (int *) checkedCalloc(numMergedStates > 0 ? numMergedStates : 1,sizeof(int));
+  conditionCounts = (int *) checkedCalloc(numConditionStates > 0 ? numConditionStates : 1,sizeof(int));
+  for (i = 0; i < numSamples; i++) {
+    mergedCounts[mergedVector[i]]++;
+    mergedCondition[mergedVector[i]] = conditionVector[i];
+    conditionCounts[conditionVector[i]]++;
+  }
+  targetConditionSum = sumCountLogCount(mergedCounts,numMergedStates);
+  conditionSum = sumCountLogCount(conditionCounts,numConditionStates);
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    int *jointCounts = (int *) checkedCalloc((size_t) maxStates * numMergedStates + 1,sizeof(int));
+    int *firstConditionCounts = (int *) checkedCalloc((size_t) maxStates * numConditionStates + 1,sizeof(int));
+    int *jointRow, *firstConditionRow;
+    uint *column;
+    int numFirstStates, i, j, x, yz;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic,4)
+#endif
+    for (j = 0; j < numFeatures; j++) {
+      column = featureMatrix + (size_t) j * numSamples;
+      numFirstStates = numStates[j];
+      memset(jointCounts,0,(size_t) numFirstStates * numMergedStates * sizeof(int));
+      memset(firstConditionCounts,0,(size_t) numFirstStates * numConditionStates * sizeof(int));
+
+      for (i = 0; i < numSamples; i++) {
+        jointCounts[column[i] + numFirstStates * mergedVector[i]]++;
+      }
+      /* c(x,z) is the sum of the c(x,y,z) rows with the same z */
+      for (yz = 0; yz < numMergedStates; yz++) {
+        jointRow = jointCounts + yz * numFirstStates;
+        firstConditionRow = firstConditionCounts + mergedCondition[yz] * numFirstStates;
+        for (x = 0; x < numFirstStates; x++) {
+          firstConditionRow[x] += jointRow[x];
+        }
+      }
+
+      outputVector[j] = conditionalMutualInformationFromSums(length,sumCountLogCount(jointCounts,numFirstStates * numMergedStates),
+                                                             sumCountLogCount(firstConditionCounts,numFirstStates * numConditionStates),
+                                                             targetConditionSum,conditionSum);
+    }
+
+    FREE_FUNC(jointCounts);
+    FREE_FUNC(firstConditionCounts);
+  }
+
+  FREE_FUNC(mergedVector);
+  FREE_FUNC(mergedCounts);
+  FREE_FUNC(mergedCondition);
+  FREE_FUNC(conditionCounts);
+  FREE_FUNC(numStates);
+  mergedVector = NULL;
+  mergedCounts = NULL;
+  mergedCondition = NULL;
+  conditionCounts = NULL;
+  numStates = NULL;
+  INSTRUMENT_EXIT();
+}/*calcConditionalMutualInformationBatch(uint *,uint *,uint *,int,int,double *)*/
+
+/*******************************************************************************
+** The joint histogram of fold k is stored at
+** foldCounts[x + numFirstStates*(y + numTargetStates*k)], and the training
+** fold count of each cell is the sum over the folds minus the fold's count.
+*******************************************************************************/
+void calcMutualInformationFoldBatch(uint *featureMatrix, uint *targetVector, uint *foldVector,
+                                    int numSamples, int numFeatures, int numFolds, double *outputMatrix) {
+  double *targetSums, *trainingLengths;
+  int *targetCounts, *targetFoldCounts;
+  int *numStates;
+  int numTargetStates, maxStates, i, k, y;
+
+  INSTRUMENT_ENTER("calcMutualInformationFoldBatch",numSamples);
+  numTargetStates = maxState(targetVector,numSamples);
+  numStates = columnStates(featureMatrix,numSamples,numFeatures,&maxStates);
+  if (numTargetStates < 1) {
+    numTargetStates = 1;
+  }
+  if (numFolds < 1) {
+    numFolds = 1;
+  }
+
+  /* the target terms depend only on the fold, so are calculated once */
+  targetCounts = (int *) checkedCalloc(numTargetStates,sizeof(int));
+  targetFoldCounts = (int *) checkedCalloc((size_t) numTargetStates * numFolds,sizeof(int));
+  targetSums = (double *) checkedCalloc(numFolds,sizeof(double));
+  trainingLengths = (double *) checkedCalloc(numFolds,sizeof(double));
+  for (i = 0; i < numSamples; i++) {
+    targetCounts[targetVector[i]]++;
+    targetFoldCounts[targetVector[i] + numTargetStates * foldVector[i]]++;
+    trainingLengths[foldVector[i]] += 1.0;
+  }
+  for (k = 0; k < numFolds; k++) {
+    trainingLengths[k] = numSamples - trainingLengths[k];
+    for (y = 0; y < numTargetStates; y++) {
+      targetSums[k] += countLogCount(targetCounts[y] - targetFoldCounts[y + numTargetStates * k]);
+    }
+  }
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    size_t foldStride = (size_t) maxStates * numTargetStates;
+    int *foldCounts = (int *) checkedCalloc(foldStride * numFolds + 1,sizeof(int));
+    int *jointCounts = (int *) checkedCalloc(foldStride + 1,sizeof(int));
+    int *firstCounts = (int *) checkedCalloc(maxStates,sizeof(int));
+    int *foldRow;
+    uint *column;
+    double jointSum, firstSum, length;
+    int numFirstStates, numJointStates, count, i, j, k, x, cell;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic,4)
+#endif
+    for (j = 0; j < numFeatures; j++) {
+      column = featureMatrix + (size_t) j * numSamples;
+      numFirstStates = numStates[j];
+      numJointStates = numFirstStates * numTargetStates;
+      memset(foldCounts,0,(size_t) numJointStates * numFolds * sizeof(int));
+      memset(jointCounts,0,(size_t) numJointStates * sizeof(int));
+
+      for (i = 0; i < numSamples; i++) {
+        foldCounts[column[i] + numFirstStates * targetVector[i] + (size_t) numJointStates * foldVector[i]]++;
+      }
+      for (k = 0; k < numFolds; k++) {
+        foldRow = foldCounts + (size_t) numJointStates * k;
+        for (cell = 0; cell < numJointStates; cell++) {
+          jointCounts[cell] += foldRow[cell];
+        }
+      }
+
+      for (k = 0; k < numFolds; k++) {
+        length = trainingLengths[k];
+        if (length <= 0) {
+          outputMatrix[k + (size_t) numFolds * j] = 0.0;
+          continue;
+        }
+        foldRow = foldCounts + (size_t) numJointStates * k;
+        memset(firstCounts,0,numFirstStates * sizeof(int));
+        jointSum = 0.0;
+        for (cell = 0; cell < numJointStates; cell += numFirstStates) {
+          for (x = 0; x < numFirstStates; x++) {
+            count = jointCounts[cell + x] - foldRow[cell + x];
+            jointSum += countLogCount(count);
+            firstCounts[x] += count;
+          }
+        }
+        firstSum = sumCountLogCount(firstCounts,numFirstStates);
+
+        outputMatrix[k + (size_t) numFolds * j] = mutualInformationFromSums(length,jointSum,firstSum,targetSums[k]);
+      }
+    }
+
+    FREE_FUNC(foldCounts);
+    FREE_FUNC(jointCounts);
+    FREE_FUNC(firstCounts);
+  }
+
+  FREE_FUNC(targetCounts);
+  FREE_FUNC(targetFoldCounts);
+  FREE_FUNC(targetSums);
+  FREE_FUNC(trainingLengths);
+  FREE_FUNC(numStates);
+  targetCounts = NULL;
+  targetFoldCounts = NULL;
+  targetSums = NULL;
+  trainingLengths = NULL;
+  numStates = NULL;
+  INSTRUMENT_EXIT();
+}/*calcMutualInformationFoldBatch(uint *,uint *,uint *,int,int,int,double *)*/
+
+/*******************************************************************************
+** Lays out the histograms of each block of groupBlock groups one after
+** another, writing the start of each group and returning the largest number
+** of states in a block.
+*******************************************************************************/
+static int layoutGroupBlocks(int *groupStates, int numGroups, int groupBlock, int *groupStarts) {
+  int blockStates = 0;
+  int g;
+
+  for (g = 0; g < numGroups; g++) {
+    groupStarts[g] = (g % groupBlock == 0) ? 0 : groupStarts[g-1] + groupStates[g-1];
+    if (groupStarts[g] + groupStates[g] > blockStates) {
+      blockStates = groupStarts[g] + groupStates[g];
+    }
+  }
+
+  return blockStates;
+}/*layoutGroupBlocks(int *,int,int,int *)*/
+
+/*******************************************************************************
+** Calculates each (feature, target) pair on its own, for arities whose group
+** histograms don't fit in MAX_TASK_STATES. The joint states of a pair are
+** compacted to those which occur, so a pair needs O(numSamples) memory
+** whatever the arities.
+*******************************************************************************/
+static void pairMutualInformation(uint *featureMatrix, uint **targetVectors, int numSamples, int numFeatures,
+                                  int numTargets, int symmetric, int *numStates, int maxStates,
+                                  double *targetSums, double *outputMatrix) {
+  double length = numSamples;
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    uint *mergedVector = (uint *) checkedCalloc(numSamples > 0 ? numSamples : 1,sizeof(uint));
+    int *mergedCounts = (int *) checkedCalloc(numSamples > 0 ? numSamples : 1,sizeof(int));
+    int *firstCounts = (int *) checkedCalloc(maxStates,sizeof(int));
+    uint *column;
+    double firstSum;
+    int numMergedStates, i, j, t;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic,1)
+#endif
+    for (j = 0; j < numFeatures; j++) {
+      column = featureMatrix + (size_t) j * numSamples;
+      memset(firstCounts,0,numStates[j] * sizeof(int));
+      for (i = 0; i < numSamples; i++) {
+        firstCounts[column[i]]++;
+      }
+      firstSum = sumCountLogCount(firstCounts,numStates[j]);
+
+      for (t = symmetric ? j : 0; t < numTargets; t++) {
+        numMergedStates = compactMergeArrays(column,targetVectors[t],mergedVector,numSamples);
+        memset(mergedCounts,0,numMergedStates * sizeof(int));
+        for (i = 0; i < numSamples; i++) {
+          mergedCounts[mergedVector[i]]++;
+        }
+        outputMatrix[j + (size_t) numFeatures * t] = mutualInformationFromSums(length,
+                                                       sumCountLogCount(mergedCounts,numMergedStates),
+                                                       firstSum,targetSums[t]);
+      }
+    }
+
+    FREE_FUNC(mergedVector);
+    FREE_FUNC(mergedCounts);
+    FREE_FUNC(firstCounts);
+  }
+}/*pairMutualInformation(uint *,uint **,int,int,int,int,int *,int,double *,double *)*/
+
+/*******************************************************************************
+** Consecutive targets are packed into groups whose joint state has at most
+** TARGET_GROUP_STATES states, so each sample makes one histogram increment
+** per group rather than one per target (e.g. 8 binary labels per group).
+** Each target's histogram is then summed out of its group's histogram.
+**
+** Each task is a block of up to FEATURE_BLOCK features and a block of up to
+** GROUP_BLOCK groups, halved until the histograms of a task fit in
+** MAX_TASK_STATES. A feature keeps one histogram per group in the block,
+** with the (x,g) state stored at numFirstStates*(groupStarts[g] + g) + x,
+** and the histograms of a feature follow each other in stateStride steps.
+**
+** When symmetric is set the targets are the features, so the tasks with
+** every feature after every target are skipped and copied from the
+** transposed pairs.
+*******************************************************************************/
+static void multiTargetMutualInformation(uint *featureMatrix, uint **targetVectors, int numSamples, int numFeatures,
+                                         int numTargets, int symmetric, double *outputMatrix) {
+  double length = numSamples;
+  double *targetSums;
+  int *targetCounts;
+  int *numStates, *numTargetStates, *targetStrides;
+  int *groupFirstTargets, *groupStates, *groupStarts;
+  int maxStates, maxTargetStates, blockStates, numGroups, numFeatureBlocks, numGroupBlocks, i, t;
+  int featureBlock, groupBlock;
+
+  numStates = columnStates(featureMatrix,numSamples,numFeatures,&maxStates);
+  numTargetStates = (int *) checkedCalloc(numTargets,sizeof(int));
+  targetStrides = (int *) checkedCalloc(numTargets,sizeof(int));
+  targetSums = (double *) checkedCalloc(numTargets,sizeof(double));
+  groupFirstTargets = (int *) checkedCalloc(numTargets + 1,sizeof(int));
+  groupStates = (int *) checkedCalloc(numTargets,sizeof(int));
+  groupStarts = (int *) checkedCalloc(numTargets,sizeof(int));
+
+  /* the target terms are the same for every feature, so are calculated once */
+  maxTargetStates = 1;
+  numGroups = 0;
+  for (t = 0; t < numTargets; t++) {
+    numTargetStates[t] = maxState(targetVectors[t],numSamples);
+    if (numTargetStates[t] < 1) {
+      numTargetStates[t] = 1;
+    }
+    if (numTargetStates[t] > maxTargetStates) {
+      maxTargetStates = numTargetStates[t];
+    }
+    targetCounts = (int *) checkedCalloc(numTargetStates[t],sizeof(int));
+    for (i = 0; i < numSamples; i++) {
+      targetCounts[targetVectors[t][i]]++;
+    }
+    targetSums[t] = sumCountLogCount(targetCounts,numTargetStates[t]);
+    FREE_FUNC(targetCounts);
+
+    if ((numGroups == 0) || ((double) groupStates[numGroups-1] * numTargetStates[t] > TARGET_GROUP_STATES)) {
+      groupFirstTargets[numGroups] = t;
+      groupStates[numGroups] = 1;
+      numGroups++;
+    }
+    targetStrides[t] = groupStates[numGroups-1];
+    groupStates[numGroups-1] *= numTargetStates[t];
+  }
+  groupFirstTargets[numGroups] = numTargets;
+  targetCounts = NULL;
+
+  featureBlock = FEATURE_BLOCK;
+  groupBlock = GROUP_BLOCK;
+  blockStates = layoutGroupBlocks(groupStates,numGroups,groupBlock,groupStarts);
+  while (((double) maxStates * blockStates * featureBlock > MAX_TASK_STATES) && (groupBlock * featureBlock > 1)) {
+    if (featureBlock > 1) {
+      featureBlock /= 2;
+    } else {
+      groupBlock /= 2;
+      blockStates = layoutGroupBlocks(groupStates,numGroups,groupBlock,groupStarts);
+    }
+  }
+
+  numFeatureBlocks = (numFeatures + featureBlock - 1) / featureBlock;
+  numGroupBlocks = (numGroups + groupBlock - 1) / groupBlock;
+  if ((double) maxStates * blockStates > MAX_TASK_STATES) {
+    pairMutualInformation(featureMatrix,targetVectors,numSamples,numFeatures,numTargets,symmetric,
+                          numStates,maxStates,targetSums,outputMatrix);
+    numFeatureBlocks = 0;
+  }
+
+#ifdef _OPENMP
+  #pragma omp parallel if (numFeatureBlocks > 0)
+#endif
+  {
+    size_t stateStride = (size_t) maxStates * blockStates;
+    int *jointCounts = (int *) checkedCalloc(numFeatureBlocks > 0 ? stateStride * featureBlock + 1 : 1,sizeof(int));
+    int *targetJointCounts = (int *) checkedCalloc(numFeatureBlocks > 0 ? (size_t) maxStates * maxTargetStates : 1,sizeof(int));
+    int *firstCounts = (int *) checkedCalloc(maxStates,sizeof(int));
+    int *sampleRows = (int *) checkedCalloc((size_t) SAMPLE_BLOCK * groupBlock,sizeof(int));
+    int *table, *targetRow, *rows;
+    uint *column;
+    double firstSum;
+    int numBlockGroups, task, firstFeature, lastFeature, firstGroup, lastGroup;
+    int blockStart, blockEnd, numFirstStates, row, i, j, t, g, x, y;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic,1)
+#endif
+    for (task = 0; task < numFeatureBlocks * numGroupBlocks; task++) {
+      firstFeature = (task / numGroupBlocks) * featureBlock;
+      lastFeature = firstFeature + featureBlock < numFeatures ? firstFeature + featureBlock : numFeatures;
+      firstGroup = (task % numGroupBlocks) * groupBlock;
+      lastGroup = firstGroup + groupBlock < numGroups ? firstGroup + groupBlock : numGroups;
+      numBlockGroups = lastGroup - firstGroup;
+      if (symmetric && (firstFeature >= groupFirstTargets[lastGroup])) {
+        continue;
+      }
+      memset(jointCounts,0,stateStride * (lastFeature - firstFeature) * sizeof(int));
+
+      for (blockStart = 0; blockStart < numSamples; blockStart += SAMPLE_BLOCK) {
+        blockEnd = blockStart + SAMPLE_BLOCK < numSamples ? blockStart + SAMPLE_BLOCK : numSamples;
+        /* the group states of the block are shared by all the features */
+        for (i = blockStart; i < blockEnd; i++) {
+          rows = sampleRows + (i - blockStart) * numBlockGroups;
+          for (g = firstGroup; g < lastGroup; g++) {
+            row = groupStarts[g];
+            for (t = groupFirstTargets[g]; t < groupFirstTargets[g+1]; t++) {
+              row += targetStrides[t] * targetVectors[t][i];
+            }
+            rows[g - firstGroup] = row;
+          }
+        }
+        for (j = firstFeature; j < lastFeature; j++) {
+          column = featureMatrix + (size_t) j * numSamples;
+          numFirstStates = numStates[j];
+          table = jointCounts + stateStride * (j - firstFeature);
+          for (i = blockStart; i < blockEnd; i++) {
+            x = column[i];
+            rows = sampleRows + (i - blockStart) * numBlockGroups;
+            for (g = 0; g < numBlockGroups; g++) {
+              table[numFirstStates * rows[g] + x]++;
+            }
+          }
+        }
+      }
+
+      for (j = firstFeature; j < lastFeature; j++) {
+        numFirstStates = numStates[j];
+        /* the column marginal is summed out of the first group's histogram */
+        table = jointCounts + stateStride * (j - firstFeature) + (size_t) numFirstStates * groupStarts[firstGroup];
+        memset(firstCounts,0,numFirstStates * sizeof(int));
+        for (row = 0; row < groupStates[firstGroup]; row++) {
+          for (x = 0; x < numFirstStates; x++) {
+            firstCounts[x] += table[x + numFirstStates * row];
+          }
+        }
+        firstSum = sumCountLogCount(firstCounts,numFirstStates);
+
+        for (g = firstGroup; g < lastGroup; g++) {
+          table = jointCounts + stateStride * (j - firstFeature) + (size_t) numFirstStates * groupStarts[g];
+          for (t = groupFirstTargets[g]; t < groupFirstTargets[g+1]; t++) {
+            memset(targetJointCounts,0,(size_t) numFirstStates * numTargetStates[t] * sizeof(int));
+            for (row = 0; row < groupStates[g]; row++) {
+              y = (row / targetStrides[t]) % numTargetStates[t];
+              targetRow = targetJointCounts + numFirstStates * y;
+              for (x = 0; x < numFirstStates; x++) {
+                targetRow[x] += table[x + numFirstStates * row];
+              }
+            }
+            outputMatrix[j + (size_t) numFeatures * t] = mutualInformationFromSums(length,
+                                                           sumCountLogCount(targetJointCounts,numFirstStates * numTargetStates[t]),
+                                                           firstSum,targetSums[t]);
+          }
+        }
+      }
+    }
+
+    FREE_FUNC(jointCounts);
+    FREE_FUNC(targetJointCounts);
+    FREE_FUNC(firstCounts);
+    FREE_FUNC(sampleRows);
+  }
+
+  if (symmetric) {
+    for (t = 0; t < numTargets; t++) {
+      for (i = t + 1; i < numFeatures; i++) {
+        outputMatrix[i + (size_t) numFeatures * t] = outputMatrix[t + (size_t) numFeatures * i];
+      }
+    }
+  }
+
+  FREE_FUNC(numStates);
+  FREE_FUNC(numTargetStates);
+  FREE_FUNC(targetStrides);
+  FREE_FUNC(targetSums);
+  FREE_FUNC(groupFirstTargets);
+  FREE_FUNC(groupStates);
+  FREE_FUNC(groupStarts);
+  numStates = NULL;
+  numTargetStates = NULL;
+  targetStrides = NULL;
+  targetSums = NULL;
+  groupFirstTargets = NULL;
+  groupStates = NULL;
+  groupStarts = NULL;
+}/*multiTargetMutualInformation(uint *,uint **,int,int,int,int,double *)*/
+
+void calcMutualInformationMultiTarget(uint *dataVector, uint **targetVectors, int numTargets, int vectorLength,
+                                      double *outputVector) {
+  if (numTargets < 1) {
+    return;
+  }
+
+  INSTRUMENT_ENTER("calcMutualInformationMultiTarget",vectorLength);
+  multiTargetMutualInformation(dataVector,targetVectors,vectorLength,1,numTargets,0,outputVector);
+  INSTRUMENT_EXIT();
+}/*calcMutualInformationMultiTarget(uint *,uint **,int,int,double *)*/
+
+void calcMutualInformationMultiTargetBatch(uint *featureMatrix, uint *targetMatrix, int numSamples, int numFeatures,
+                                           int numTargets, double *outputMatrix) {
+  uint **targetVectors;
+  int t;
+
+  if ((numTargets < 1) || (numFeatures < 1)) {
+    return;
+  }
+
+  INSTRUMENT_ENTER("calcMutualInformationMultiTargetBatch",numSamples);
+  targetVectors = (uint **) checkedCalloc(numTargets,sizeof(uint *));
+  for (t = 0; t < numTargets; t++) {
+    targetVectors[t] = targetMatrix + (size_t) t * numSamples;
+  }
+
+  multiTargetMutualInformation(featureMatrix,targetVectors,numSamples,numFeatures,numTargets,0,outputMatrix);
+
+  FREE_FUNC(targetVectors);
+  targetVectors = NULL;
+  INSTRUMENT_EXIT();
+}/*calcMutualInformationMultiTargetBatch(uint *,uint *,int,int,int,double *)*/
+
+void calcPairwiseMutualInformation(uint *featureMatrix, int numSamples, int numFeatures, double *outputMatrix) {
+  uint **featureVectors;
+  int j;
+
+  if (numFeatures < 1) {
+    return;
+  }
+
+  INSTRUMENT_ENTER("calcPairwiseMutualInformation",numSamples);
+  featureVectors = (uint **) checkedCalloc(numFeatures,sizeof(uint *));
+  for (j = 0; j < numFeatures; j++) {
+    featureVectors[j] = featureMatrix + (size_t) j * numSamples;
+  }
+
+  multiTargetMutualInformation(featureMatrix,featureVectors,numSamples,numFeatures,numFeatures,1,outputMatrix);
+
+  FREE_FUNC(featureVectors);
+  featureVectors = NULL;
+  INSTRUMENT_EXIT();
+}/*calcPairwiseMutualInformation(uint *,int,int,double *)*/
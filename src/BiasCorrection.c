@@ -0,0 +1,322 @@
+/*******************************************************************************
+** BiasCorrection.c
+** Part of the mutual information toolbox
+**
+** Contains bias corrected estimates of the entropy, mutual information and
+** conditional mutual information, using the Miller-Madow correction or the
+** leave-one-out jackknife. Removing a sample only changes the counts of the
+** states it falls in, and every sample in the same joint state gives the
+** same leave-one-out estimate, so the jackknife is calculated from the
+** integer histograms in O(states) rather than with n recalculations.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/Instrumentation.h"
+#include "MIToolbox/JointCounts.h"
+#include "MIToolbox/BiasCorrection.h"
+#include "CountSums.h"
+
+/* Counts above this use the series for countLogCountStep */
+#define SERIES_COUNT 64.0
+#define SERIES_TERMS 10
+
+/*******************************************************************************
+** Each estimate is a log n + 1/n \sum_t sign_t \sum_c c \log c, summed over
+** the cells c of marginal tables t (e.g. a = 1 and tables +XY, -X, -Y for
+** I(X;Y)). The sums below are accumulated with the same signs.
+*******************************************************************************/
+typedef struct tsState
+{
+  double logCoefficient;
+  double countLogCounts;
+  double stepSum;
+  double occupiedStates;
+} TableSums;
+
+/*******************************************************************************
+** c \log c - (c-1) \log (c-1), the change in c \log c when a sample is
+** removed. The direct difference cancels badly for large c, so above
+** SERIES_COUNT it is \log c + (c-1) \sum_k 1/(k c^k).
+*******************************************************************************/
+static double countLogCountStep(double count) {
+  double u, series = 0.0;
+  int k;
+
+  if (count < SERIES_COUNT) {
+    return countLogCount(count) - countLogCount(count - 1);
+  }
+  u = 1.0 / count;
+  for (k = SERIES_TERMS; k > 0; k--) {
+    series = u * (1.0 / k + series);
+  }
+  return log(count) + (count - 1) * series;
+}/*countLogCountStep(double)*/
+
+static void addTable(double *counts, int numStates, double sign, TableSums *sums) {
+  int i;
+
+  for (i = 0; i < numStates; i++) {
+    if (counts[i] > 0) {
+      sums->countLogCounts += sign * countLogCount(counts[i]);
+      sums->stepSum += sign * counts[i] * countLogCountStep(counts[i]);
+      sums->occupiedStates += sign;
+    }
+  }
+}/*addTable(double *,int,double,TableSums *)*/
+
+static TableSums entropySums(JointCounts counts) {
+  TableSums sums = {1.0, 0.0, 0.0, 0.0};
+  double *firstCounts = (double *) checkedCalloc(counts.numFirstStates,sizeof(double));
+  int i;
+
+  for (i = 0; i < counts.numJointStates; i++) {
+    firstCounts[i % counts.numFirstStates] += counts.jointCounts[i];
+  }
+  addTable(firstCounts,counts.numFirstStates,-1.0,&sums);
+
+  FREE_FUNC(firstCounts);
+  firstCounts = NULL;
+
+  return sums;
+}/*entropySums(JointCounts)*/
+
+static TableSums mutualInformationSums(JointCounts counts) {
+  TableSums sums = {1.0, 0.0, 0.0, 0.0};
+  int numJointStates = counts.numFirstStates * counts.numSecondStates;
+  double *firstCounts = (double *) checkedCalloc(counts.numFirstStates,sizeof(double));
+  double *secondCounts = (double *) checkedCalloc(counts.numSecondStates,sizeof(double));
+  double *jointCounts = (double *) checkedCalloc(numJointStates,sizeof(double));
+  double value;
+  int x, y, z, index = 0;
+
+  for (z = 0; z < counts.numConditionStates; z++) {
+    for (y = 0; y < counts.numSecondStates; y++) {
+      for (x = 0; x < counts.numFirstStates; x++) {
+        value = counts.jointCounts[index];
+        firstCounts[x] += value;
+        secondCounts[y] += value;
+        jointCounts[x + counts.numFirstStates * y] += value;
+        index++;
+      }
+    }
+  }
+  addTable(jointCounts,numJointStates,1.0,&sums);
+  addTable(firstCounts,counts.numFirstStates,-1.0,&sums);
+  addTable(secondCounts,counts.numSecondStates,-1.0,&sums);
+
+  FREE_FUNC(firstCounts);
+  FREE_FUNC(secondCounts);
+  FREE_FUNC(jointCounts);
+  firstCounts = NULL;
+  secondCounts = NULL;
+  jointCounts = NULL;
+
+  return sums;
+}/*mutualInformationSums(JointCounts)*/
+
+static TableSums conditionalMutualInformationSums(JointCounts counts) {
+  TableSums sums = {0.0, 0.0, 0.0, 0.0};
+  int numFirstCondStates = counts.numFirstStates * counts.numConditionStates;
+  int numSecondCondStates = counts.numSecondStates * counts.numConditionStates;
+  double *firstCondCounts = (double *) checkedCalloc(numFirstCondStates,sizeof(double));
+  double *secondCondCounts = (double *) checkedCalloc(numSecondCondStates,sizeof(double));
+  double *condCounts = (double *) checkedCalloc(counts.numConditionStates,sizeof(double));
+  double *jointCounts = (double *) checkedCalloc(counts.numJointStates,sizeof(double));
+  double value;
+  int x, y, z, index = 0;
+
+  for (z = 0; z < counts.numConditionStates; z++) {
+    for (y = 0; y < counts.numSecondStates; y++) {
+      for (x = 0; x < counts.numFirstStates; x++) {
+        value = counts.jointCounts[index];
+        firstCondCounts[x + counts.numFirstStates * z] += value;
+        secondCondCounts[y + counts.numSecondStates * z] += value;
+        condCounts[z] += value;
+        jointCounts[index] = value;
+        index++;
+      }
+    }
+  }
+  addTable(jointCounts,counts.numJointStates,1.0,&sums);
+  addTable(condCounts,counts.numConditionStates,1.0,&sums);
+  addTable(firstCondCounts,numFirstCondStates,-1.0,&sums);
+  addTable(secondCondCounts,numSecondCondStates,-1.0,&sums);
+
+  FREE_FUNC(firstCondCounts);
+  FREE_FUNC(secondCondCounts);
+  FREE_FUNC(condCounts);
+  FREE_FUNC(jointCounts);
+  firstCondCounts = NULL;
+  secondCondCounts = NULL;
+  condCounts = NULL;
+  jointCounts = NULL;
+
+  return sums;
+}/*conditionalMutualInformationSums(JointCounts)*/
+
+/*******************************************************************************
+** Each plug-in entropy is biased by -(m - 1)/2n, and the signed sum of the
+** -(m - 1) terms is -(occupiedStates + logCoefficient).
+*******************************************************************************/
+static double millerMadow(TableSums sums, double length) {
+  double estimate = sums.logCoefficient * log(length) + sums.countLogCounts / length;
+
+  estimate -= (sums.occupiedStates + sums.logCoefficient) / (2.0 * length);
+
+  return estimate / log(LOG_BASE);
+}/*millerMadow(TableSums,double)*/
+
+/*******************************************************************************
+** Removing a sample from a cell with count c changes c \log c by
+** -countLogCountStep(c), and c samples share that cell, so the mean of the
+** leave-one-out estimates is
+**   a \log (n-1) + (T - 1/n \sum_t sign_t \sum_c c step(c)) / (n-1).
+** In n*plugin - (n-1)*mean the T terms cancel, leaving
+**   a step(n) + 1/n \sum_t sign_t \sum_c c step(c).
+*******************************************************************************/
+static double jackknife(TableSums sums, double length) {
+  double estimate;
+
+  if (length < 2) {
+    estimate = sums.logCoefficient * log(length) + sums.countLogCounts / length;
+  } else {
+    estimate = sums.logCoefficient * countLogCountStep(length) + sums.stepSum / length;
+  }
+
+  return estimate / log(LOG_BASE);
+}/*jackknife(TableSums,double)*/
+
+double countsMillerMadowEntropy(JointCounts counts) {
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+  return millerMadow(entropySums(counts),counts.numSamples);
+}/*countsMillerMadowEntropy(JointCounts)*/
+
+double countsMillerMadowMutualInformation(JointCounts counts) {
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+  return millerMadow(mutualInformationSums(counts),counts.numSamples);
+}/*countsMillerMadowMutualInformation(JointCounts)*/
+
+double countsMillerMadowConditionalMutualInformation(JointCounts counts) {
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+  return millerMadow(conditionalMutualInformationSums(counts),counts.numSamples);
+}/*countsMillerMadowConditionalMutualInformation(JointCounts)*/
+
+double countsJackknifeEntropy(JointCounts counts) {
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+  return jackknife(entropySums(counts),counts.numSamples);
+}/*countsJackknifeEntropy(JointCounts)*/
+
+double countsJackknifeMutualInformation(JointCounts counts) {
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+  return jackknife(mutualInformationSums(counts),counts.numSamples);
+}/*countsJackknifeMutualInformation(JointCounts)*/
+
+double countsJackknifeConditionalMutualInformation(JointCounts counts) {
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+  return jackknife(conditionalMutualInformationSums(counts),counts.numSamples);
+}/*countsJackknifeConditionalMutualInformation(JointCounts)*/
+
+double calcMillerMadowEntropy(uint *dataVector, int vectorLength) {
+  JointCounts counts;
+  double entropy;
+
+  INSTRUMENT_ENTER("calcMillerMadowEntropy",vectorLength);
+  counts = calculateJointCounts(dataVector,NULL,NULL,vectorLength);
+  entropy = countsMillerMadowEntropy(counts);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return entropy;
+}/*calcMillerMadowEntropy(uint *,int)*/
+
+double calcMillerMadowMutualInformation(uint *dataVector, uint *targetVector, int vectorLength) {
+  JointCounts counts;
+  double mutualInformation;
+
+  INSTRUMENT_ENTER("calcMillerMadowMutualInformation",vectorLength);
+  counts = calculateJointCounts(dataVector,targetVector,NULL,vectorLength);
+  mutualInformation = countsMillerMadowMutualInformation(counts);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return mutualInformation;
+}/*calcMillerMadowMutualInformation(uint *,uint *,int)*/
+
+double calcMillerMadowConditionalMutualInformation(uint *dataVector, uint *targetVector, uint *conditionVector, int vectorLength) {
+  JointCounts counts;
+  double mutualInformation;
+
+  INSTRUMENT_ENTER("calcMillerMadowConditionalMutualInformation",vectorLength);
+  counts = calculateJointCounts(dataVector,targetVector,conditionVector,vectorLength);
+  mutualInformation = countsMillerMadowConditionalMutualInformation(counts);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return mutualInformation;
+}/*calcMillerMadowConditionalMutualInformation(uint *,uint *,uint *,int)*/
+
+double calcJackknifeEntropy(uint *dataVector, int vectorLength) {
+  JointCounts counts;
+  double entropy;
+
+  INSTRUMENT_ENTER("calcJackknifeEntropy",vectorLength);
+  counts = calculateJointCounts(dataVector,NULL,NULL,vectorLength);
+  entropy = countsJackknifeEntropy(counts);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return entropy;
+}/*calcJackknifeEntropy(uint *,int)*/
+
+double calcJackknifeMutualInformation(uint *dataVector, uint *targetVector, int vectorLength) {
+  JointCounts counts;
+  double mutualInformation;
+
+  INSTRUMENT_ENTER("calcJackknifeMutualInformation",vectorLength);
+  counts = calculateJointCounts(dataVector,targetVector,NULL,vectorLength);
+  mutualInformation = countsJackknifeMutualInformation(counts);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return mutualInformation;
+}/*calcJackknifeMutualInformation(uint *,uint *,int)*/
+
+double calcJackknifeConditionalMutualInformation(uint *dataVector, uint *targetVector, uint *conditionVector, int vectorLength) {
+  JointCounts counts;
+  double mutualInformation;
+
+  INSTRUMENT_ENTER("calcJackknifeConditionalMutualInformation",vectorLength);
+  counts = calculateJointCounts(dataVector,targetVector,conditionVector,vectorLength);
+  mutualInformation = countsJackknifeConditionalMutualInformation(counts);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return mutualInformation;
+}/*calcJackknifeConditionalMutualInformation(uint *,uint *,uint *,int)*/
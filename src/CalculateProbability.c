@@ -19,6 +19,8 @@
 #include "MIToolbox/MIToolbox.h"
 #include "MIToolbox/ArrayOperations.h"
 #include "MIToolbox/CalculateProbability.h"
+#include "MIToolbox/Instrumentation.h"
+#include "MIToolbox/Kernels.h"
 
 JointProbabilityState calculateJointProbability(uint *firstVector, uint *secondVector, int vectorLength) {
   int *firstStateCounts;
@@ -30,13 +32,13 @@ JointProbabilityState calculateJointProbability(uint *firstVector, uint *secondV
   int firstNumStates;
   int secondNumStates;
   int jointNumStates;
-  int i;
   double length = vectorLength;
   JointProbabilityState state;
 
   firstNumStates = maxState(firstVector,vectorLength);
   secondNumStates = maxState(secondVector,vectorLength);
   jointNumStates = firstNumStates * secondNumStates;
+  INSTRUMENT_CELLS((double) firstNumStates + secondNumStates + jointNumStates);
   
   firstStateCounts = (int *) checkedCalloc(firstNumStates,sizeof(int));
   secondStateCounts = (int *) checkedCalloc(secondNumStates,sizeof(int));
@@ -46,24 +48,15 @@ JointProbabilityState calculateJointProbability(uint *firstVector, uint *secondV
   secondStateProbs = (double *) checkedCalloc(secondNumStates,sizeof(double));
   jointStateProbs = (double *) checkedCalloc(jointNumStates,sizeof(double));
     
+  INSTRUMENT_PHASE_BEGIN(COUNTING_PHASE);
   /* Optimised for number of FP operations now O(states) instead of O(vectorLength) */
-  for (i = 0; i < vectorLength; i++) {
-    firstStateCounts[firstVector[i]] += 1;
-    secondStateCounts[secondVector[i]] += 1;
-    jointStateCounts[secondVector[i] * firstNumStates + firstVector[i]] += 1;
-  }
-  
-  for (i = 0; i < firstNumStates; i++) {
-    firstStateProbs[i] = firstStateCounts[i] / length;
-  }
-  
-  for (i = 0; i < secondNumStates; i++) {
-    secondStateProbs[i] = secondStateCounts[i] / length;
-  }
+  activeKernels->countJointStates(firstVector,secondVector,firstNumStates,vectorLength,
+                                  firstStateCounts,secondStateCounts,jointStateCounts);
   
-  for (i = 0; i < jointNumStates; i++) {
-    jointStateProbs[i] = jointStateCounts[i] / length;
-  }
+  activeKernels->countsToProbabilities(firstStateCounts,firstStateProbs,firstNumStates,length);
+  activeKernels->countsToProbabilities(secondStateCounts,secondStateProbs,secondNumStates,length);
+  activeKernels->countsToProbabilities(jointStateCounts,jointStateProbs,jointNumStates,length);
+  INSTRUMENT_PHASE_END();
 
   FREE_FUNC(firstStateCounts);
   FREE_FUNC(secondStateCounts);
@@ -134,6 +127,7 @@ WeightedJointProbState calculateWeightedJointProbability(uint *firstVector, uint
   firstNumStates = maxState(firstVector,vectorLength);
   secondNumStates = maxState(secondVector,vectorLength);
   jointNumStates = firstNumStates * secondNumStates;
+  INSTRUMENT_CELLS((double) firstNumStates + secondNumStates + jointNumStates);
   
   firstStateCounts = (int *) checkedCalloc(firstNumStates,sizeof(int));
   secondStateCounts = (int *) checkedCalloc(secondNumStates,sizeof(int));
@@ -147,6 +141,7 @@ WeightedJointProbState calculateWeightedJointProbability(uint *firstVector, uint
   secondWeightVec = (double *) checkedCalloc(secondNumStates,sizeof(double));
   jointWeightVec = (double *) checkedCalloc(jointNumStates,sizeof(double));
     
+  INSTRUMENT_PHASE_BEGIN(COUNTING_PHASE);
   for (i = 0; i < vectorLength; i++) {
     firstStateCounts[firstVector[i]] += 1;
     secondStateCounts[secondVector[i]] += 1;
@@ -177,6 +172,7 @@ WeightedJointProbState calculateWeightedJointProbability(uint *firstVector, uint
       jointWeightVec[i] /= jointStateCounts[i];
     }
   }
+  INSTRUMENT_PHASE_END();
 
   FREE_FUNC(firstStateCounts);
   FREE_FUNC(secondStateCounts);
@@ -237,22 +233,19 @@ ProbabilityState calculateProbability(uint* dataVector, int vectorLength) {
   int *stateCounts;
   double *stateProbs;
   ProbabilityState state;
-  int i;
   double length = vectorLength;
 
   numStates = maxState(dataVector,vectorLength);
+  INSTRUMENT_CELLS(numStates);
   
   stateCounts = (int *) checkedCalloc(numStates,sizeof(int));
   stateProbs = (double *) checkedCalloc(numStates,sizeof(double));
   
+  INSTRUMENT_PHASE_BEGIN(COUNTING_PHASE);
   /* Optimised for number of FP operations now O(states) instead of O(vectorLength) */
-  for (i = 0; i < vectorLength; i++) {
-    stateCounts[dataVector[i]] += 1;
-  }
-  
-  for (i = 0; i < numStates; i++) {
-    stateProbs[i] = stateCounts[i] / length;
-  }
+  activeKernels->countStates(dataVector,vectorLength,stateCounts);
+  activeKernels->countsToProbabilities(stateCounts,stateProbs,numStates,length);
+  INSTRUMENT_PHASE_END();
   
   FREE_FUNC(stateCounts);
   stateCounts = NULL;
@@ -287,11 +280,13 @@ WeightedProbState calculateWeightedProbability(uint *dataVector, double *weightV
   double length = vectorLength;
   
   numStates = maxState(dataVector,vectorLength);
+  INSTRUMENT_CELLS(numStates);
   
   stateCounts = (int *) checkedCalloc(numStates,sizeof(int));
   stateProbs = (double *) checkedCalloc(numStates,sizeof(double));
   stateWeights = (double *) checkedCalloc(numStates,sizeof(double));
 
+  INSTRUMENT_PHASE_BEGIN(COUNTING_PHASE);
   for (i = 0; i < vectorLength; i++) {
     stateCounts[dataVector[i]] += 1;
     stateWeights[dataVector[i]] += weightVector[i];
@@ -301,6 +296,7 @@ WeightedProbState calculateWeightedProbability(uint *dataVector, double *weightV
     stateProbs[i] = stateCounts[i] / length;
     stateWeights[i] /= stateCounts[i];
   }
+  INSTRUMENT_PHASE_END();
   
   FREE_FUNC(stateCounts);
   stateCounts = NULL;
@@ -325,6 +321,99 @@ WeightedProbState discAndCalcWeightedProbability(double *dataVector, double *wei
   return state;
 }/*discAndCalcWeightedProbability(double *, double *, int)*/
 
+WeightedWorkspace createWeightedWorkspace(void) {
+  WeightedWorkspace workspace;
+
+  workspace.jointStates = NULL;
+  workspace.numJointStates = 0;
+  workspace.firstStates = NULL;
+  workspace.numFirstStates = 0;
+  workspace.secondStates = NULL;
+  workspace.numSecondStates = 0;
+  workspace.jointCapacity = 0;
+  workspace.firstCapacity = 0;
+  workspace.secondCapacity = 0;
+  workspace.length = 0.0;
+
+  return workspace;
+}/*createWeightedWorkspace()*/
+
+static WeightedStateSum *reserveStateSums(WeightedStateSum *states, int *capacity, int numStates) {
+  if (numStates > *capacity) {
+    FREE_FUNC(states);
+    states = (WeightedStateSum *) checkedCalloc(numStates,sizeof(WeightedStateSum));
+    *capacity = numStates;
+  } else {
+    memset(states,0,numStates * sizeof(WeightedStateSum));
+  }
+  return states;
+}/*reserveStateSums(WeightedStateSum *,int *,int)*/
+
+void calculateWeightedWorkspace(WeightedWorkspace *workspace, uint *firstVector, uint *secondVector, double *weightVector, int vectorLength) {
+  WeightedStateSum *jointState, *jointRow;
+  int numFirstStates, numSecondStates, i, j;
+
+  INSTRUMENT_PHASE_BEGIN(MAX_STATE_PHASE);
+  numFirstStates = maxState(firstVector,vectorLength);
+  numSecondStates = secondVector == NULL ? 1 : maxState(secondVector,vectorLength);
+  INSTRUMENT_PHASE_END();
+
+  INSTRUMENT_PHASE_BEGIN(ALLOC_PHASE);
+  workspace->jointStates = reserveStateSums(workspace->jointStates,&workspace->jointCapacity,numFirstStates * numSecondStates);
+  workspace->firstStates = reserveStateSums(workspace->firstStates,&workspace->firstCapacity,numFirstStates);
+  workspace->secondStates = reserveStateSums(workspace->secondStates,&workspace->secondCapacity,numSecondStates);
+  INSTRUMENT_PHASE_END();
+  workspace->numFirstStates = numFirstStates;
+  workspace->numSecondStates = numSecondStates;
+  workspace->numJointStates = numFirstStates * numSecondStates;
+  workspace->length = vectorLength;
+
+  /* only the joint state is touched per sample, the marginals are its row and column sums */
+  INSTRUMENT_PHASE_BEGIN(COUNTING_PHASE);
+  if (secondVector == NULL) {
+    for (i = 0; i < vectorLength; i++) {
+      jointState = workspace->jointStates + firstVector[i];
+      jointState->count += 1.0;
+      jointState->weight += weightVector[i];
+    }
+  } else {
+    for (i = 0; i < vectorLength; i++) {
+      jointState = workspace->jointStates + firstVector[i] + secondVector[i] * numFirstStates;
+      jointState->count += 1.0;
+      jointState->weight += weightVector[i];
+    }
+  }
+
+  for (j = 0; j < numSecondStates; j++) {
+    jointRow = workspace->jointStates + j*numFirstStates;
+    for (i = 0; i < numFirstStates; i++) {
+      workspace->firstStates[i].count += jointRow[i].count;
+      workspace->firstStates[i].weight += jointRow[i].weight;
+      workspace->secondStates[j].count += jointRow[i].count;
+      workspace->secondStates[j].weight += jointRow[i].weight;
+    }
+  }
+  INSTRUMENT_PHASE_END();
+}/*calculateWeightedWorkspace(WeightedWorkspace *,uint *,uint *,double *,int)*/
+
+double sumWeightLogCount(WeightedStateSum *states, int numStates, double *totalWeight) {
+  double sum = 0.0;
+  double weight = 0.0;
+  int i;
+
+  for (i = 0; i < numStates; i++) {
+    if (states[i].count > 0) {
+      sum += states[i].weight * log(states[i].count);
+      weight += states[i].weight;
+    }
+  }
+
+  if (totalWeight != NULL) {
+    *totalWeight = weight;
+  }
+  return sum;
+}/*sumWeightLogCount(WeightedStateSum *,int,double *)*/
+
 void freeProbabilityState(ProbabilityState state) {
     FREE_FUNC(state.probabilityVector);
     state.probabilityVector = NULL;
@@ -360,3 +449,12 @@ void freeWeightedJointProbState(WeightedJointProbState state) {
   FREE_FUNC(state.jointWeightVector);
   state.jointWeightVector = NULL;
 }
+
+void freeWeightedWorkspace(WeightedWorkspace workspace) {
+  FREE_FUNC(workspace.jointStates);
+  workspace.jointStates = NULL;
+  FREE_FUNC(workspace.firstStates);
+  workspace.firstStates = NULL;
+  FREE_FUNC(workspace.secondStates);
+  workspace.secondStates = NULL;
+}
@@ -0,0 +1,261 @@
+/*******************************************************************************
+** ChowLiuTree.c
+** Part of the mutual information toolbox
+**
+** Contains functions to build the Chow-Liu dependency tree of the columns of
+** a feature matrix, i.e. the maximum spanning tree of the complete graph
+** weighted by the pairwise mutual information I(X_i;X_j). The tree can be
+** built with Prim's algorithm on the full pairwise matrix, or with Boruvka's
+** algorithm streaming blocks of the matrix, so that the p x p matrix is never
+** stored for very wide data.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/BatchInformation.h"
+#include "MIToolbox/ChowLiuTree.h"
+#include "MIToolbox/Instrumentation.h"
+
+#define DEFAULT_STREAMING_BLOCK 64
+
+double calcChowLiuTree(uint *featureMatrix, int numSamples, int numFeatures, int *parentVector) {
+  double *pairwiseMatrix, *bestWeights;
+  double treeWeight = 0.0;
+  char *inTree;
+  int i, j, next;
+
+  if (numFeatures < 1) {
+    return 0.0;
+  }
+
+  INSTRUMENT_ENTER("calcChowLiuTree",numSamples);
+  pairwiseMatrix = (double *) checkedCalloc((size_t) numFeatures * numFeatures,sizeof(double));
+  bestWeights = (double *) checkedCalloc(numFeatures,sizeof(double));
+  inTree = (char *) checkedCalloc(numFeatures,sizeof(char));
+  calcPairwiseMutualInformation(featureMatrix,numSamples,numFeatures,pairwiseMatrix);
+
+  /* Prim's algorithm, where bestWeights[j] is the heaviest edge from j into the tree */
+  inTree[0] = 1;
+  parentVector[0] = -1;
+  for (j = 1; j < numFeatures; j++) {
+    bestWeights[j] = pairwiseMatrix[j];
+    parentVector[j] = 0;
+  }
+  for (i = 1; i < numFeatures; i++) {
+    next = -1;
+    for (j = 1; j < numFeatures; j++) {
+      if (!inTree[j] && ((next == -1) || (bestWeights[j] > bestWeights[next]))) {
+        next = j;
+      }
+    }
+    inTree[next] = 1;
+    treeWeight += bestWeights[next];
+    for (j = 1; j < numFeatures; j++) {
+      if (!inTree[j] && (pairwiseMatrix[j + (size_t) numFeatures * next] > bestWeights[j])) {
+        bestWeights[j] = pairwiseMatrix[j + (size_t) numFeatures * next];
+        parentVector[j] = next;
+      }
+    }
+  }
+
+  FREE_FUNC(pairwiseMatrix);
+  FREE_FUNC(bestWeights);
+  FREE_FUNC(inTree);
+  pairwiseMatrix = NULL;
+  bestWeights = NULL;
+  inTree = NULL;
+  INSTRUMENT_EXIT();
+
+  return treeWeight;
+}/*calcChowLiuTree(uint *,int,int,int *)*/
+
+static int findComponent(int *components, int feature) {
+  while (components[feature] != feature) {
+    components[feature] = components[components[feature]];
+    feature = components[feature];
+  }
+  return feature;
+}/*findComponent(int *,int)*/
+
+/*******************************************************************************
+** Orders edges by weight, then by their (smaller, larger) features, so every
+** component agrees on ties and the chosen edges cannot form a cycle.
+*******************************************************************************/
+static int heavierEdge(double weight, int first, int second, double bestWeight, int bestFirst, int bestSecond) {
+  if (weight != bestWeight) {
+    return weight > bestWeight;
+  }
+  if (first != bestFirst) {
+    return first < bestFirst;
+  }
+  return second < bestSecond;
+}/*heavierEdge(double,int,int,double,int,int)*/
+
+/*******************************************************************************
+** Roots the tree at feature 0 with a breadth first search over the edges.
+*******************************************************************************/
+static void orientTree(int *edgeFirsts, int *edgeSeconds, int numFeatures, int *parentVector) {
+  int *edgeStarts = (int *) checkedCalloc(numFeatures + 1,sizeof(int));
+  int *neighbours = (int *) checkedCalloc(2 * numFeatures,sizeof(int));
+  int *queue = (int *) checkedCalloc(numFeatures,sizeof(int));
+  int head = 0, tail = 0;
+  int i, j, feature;
+
+  for (i = 0; i < numFeatures - 1; i++) {
+    edgeStarts[edgeFirsts[i] + 1]++;
+    edgeStarts[edgeSeconds[i] + 1]++;
+  }
+  for (j = 0; j < numFeatures; j++) {
+    edgeStarts[j + 1] += edgeStarts[j];
+  }
+  for (i = 0; i < numFeatures - 1; i++) {
+    neighbours[edgeStarts[edgeFirsts[i]]++] = edgeSeconds[i];
+    neighbours[edgeStarts[edgeSeconds[i]]++] = edgeFirsts[i];
+  }
+  /* the fill advanced each start to the next feature's start */
+  for (j = numFeatures; j > 0; j--) {
+    edgeStarts[j] = edgeStarts[j - 1];
+  }
+  edgeStarts[0] = 0;
+
+  for (j = 0; j < numFeatures; j++) {
+    parentVector[j] = -2;
+  }
+  parentVector[0] = -1;
+  queue[tail++] = 0;
+  while (head < tail) {
+    feature = queue[head++];
+    for (i = edgeStarts[feature]; i < edgeStarts[feature + 1]; i++) {
+      if (parentVector[neighbours[i]] == -2) {
+        parentVector[neighbours[i]] = feature;
+        queue[tail++] = neighbours[i];
+      }
+    }
+  }
+
+  FREE_FUNC(edgeStarts);
+  FREE_FUNC(neighbours);
+  FREE_FUNC(queue);
+  edgeStarts = NULL;
+  neighbours = NULL;
+  queue = NULL;
+}/*orientTree(int *,int *,int,int *)*/
+
+/*******************************************************************************
+** Each round of Boruvka's algorithm scores the features blockSize at a time
+** against every later feature, keeps the heaviest edge leaving each
+** component, then joins the components along those edges.
+*******************************************************************************/
+double calcChowLiuTreeStreaming(uint *featureMatrix, int numSamples, int numFeatures, int blockSize, int *parentVector) {
+  double *blockMatrix, *bestWeights;
+  double treeWeight = 0.0;
+  double weight;
+  int *components, *roots, *bestFirsts, *bestSeconds, *edgeFirsts, *edgeSeconds;
+  int numEdges = 0;
+  int blockStart, numBlockFeatures, numTargets, i, t, j, first, second, firstRoot, secondRoot;
+
+  if (numFeatures < 1) {
+    return 0.0;
+  }
+  if (blockSize < 1) {
+    blockSize = DEFAULT_STREAMING_BLOCK;
+  }
+
+  INSTRUMENT_ENTER("calcChowLiuTreeStreaming",numSamples);
+  blockMatrix = (double *) checkedCalloc((size_t) blockSize * numFeatures,sizeof(double));
+  bestWeights = (double *) checkedCalloc(numFeatures,sizeof(double));
+  components = (int *) checkedCalloc(numFeatures,sizeof(int));
+  roots = (int *) checkedCalloc(numFeatures,sizeof(int));
+  bestFirsts = (int *) checkedCalloc(numFeatures,sizeof(int));
+  bestSeconds = (int *) checkedCalloc(numFeatures,sizeof(int));
+  edgeFirsts = (int *) checkedCalloc(numFeatures,sizeof(int));
+  edgeSeconds = (int *) checkedCalloc(numFeatures,sizeof(int));
+  for (j = 0; j < numFeatures; j++) {
+    components[j] = j;
+  }
+
+  while (numEdges < numFeatures - 1) {
+    for (j = 0; j < numFeatures; j++) {
+      roots[j] = findComponent(components,j);
+      bestWeights[j] = -HUGE_VAL;
+      bestFirsts[j] = -1;
+    }
+
+    for (blockStart = 0; blockStart < numFeatures; blockStart += blockSize) {
+      numBlockFeatures = blockStart + blockSize < numFeatures ? blockSize : numFeatures - blockStart;
+      numTargets = numFeatures - blockStart;
+      calcMutualInformationMultiTargetBatch(featureMatrix + (size_t) blockStart * numSamples,
+                                            featureMatrix + (size_t) blockStart * numSamples,
+                                            numSamples,numBlockFeatures,numTargets,blockMatrix);
+      for (i = 0; i < numBlockFeatures; i++) {
+        first = blockStart + i;
+        for (t = i + 1; t < numTargets; t++) {
+          second = blockStart + t;
+          firstRoot = roots[first];
+          secondRoot = roots[second];
+          if (firstRoot == secondRoot) {
+            continue;
+          }
+          weight = blockMatrix[i + (size_t) numBlockFeatures * t];
+          if ((bestFirsts[firstRoot] == -1)
+              || heavierEdge(weight,first,second,bestWeights[firstRoot],bestFirsts[firstRoot],bestSeconds[firstRoot])) {
+            bestWeights[firstRoot] = weight;
+            bestFirsts[firstRoot] = first;
+            bestSeconds[firstRoot] = second;
+          }
+          if ((bestFirsts[secondRoot] == -1)
+              || heavierEdge(weight,first,second,bestWeights[secondRoot],bestFirsts[secondRoot],bestSeconds[secondRoot])) {
+            bestWeights[secondRoot] = weight;
+            bestFirsts[secondRoot] = first;
+            bestSeconds[secondRoot] = second;
+          }
+        }
+      }
+    }
+
+    for (j = 0; j < numFeatures; j++) {
+      if ((roots[j] != j) || (bestFirsts[j] == -1)) {
+        continue;
+      }
+      firstRoot = findComponent(components,bestFirsts[j]);
+      secondRoot = findComponent(components,bestSeconds[j]);
+      if (firstRoot != secondRoot) {
+        components[firstRoot] = secondRoot;
+        edgeFirsts[numEdges] = bestFirsts[j];
+        edgeSeconds[numEdges] = bestSeconds[j];
+        treeWeight += bestWeights[j];
+        numEdges++;
+      }
+    }
+  }
+
+  orientTree(edgeFirsts,edgeSeconds,numFeatures,parentVector);
+
+  FREE_FUNC(blockMatrix);
+  FREE_FUNC(bestWeights);
+  FREE_FUNC(components);
+  FREE_FUNC(roots);
+  FREE_FUNC(bestFirsts);
+  FREE_FUNC(bestSeconds);
+  FREE_FUNC(edgeFirsts);
+  FREE_FUNC(edgeSeconds);
+  blockMatrix = NULL;
+  bestWeights = NULL;
+  components = NULL;
+  roots = NULL;
+  bestFirsts = NULL;
+  bestSeconds = NULL;
+  edgeFirsts = NULL;
+  edgeSeconds = NULL;
+  INSTRUMENT_EXIT();
+
+  return treeWeight;
+}/*calcChowLiuTreeStreaming(uint *,int,int,int,int *)*/
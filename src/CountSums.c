@@ -0,0 +1,93 @@
+/*******************************************************************************
+** CountSums.c
+** Part of the mutual information toolbox
+**
+** Contains the \sum c \log c reductions shared by the functions which
+** calculate entropies directly from integer state counts, and the conversions
+** from those sums to H(X), H(X|Y), I(X;Y) and I(X;Y|Z).
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include "MIToolbox/MIToolbox.h"
+#include "CountSums.h"
+
+double countLogCount(double count) {
+  return count > 0 ? count * log(count) : 0.0;
+}/*countLogCount(double)*/
+
+double sumCountLogCount(int *counts, int numStates) {
+  double sum = 0.0;
+  int i;
+
+  for (i = 0; i < numStates; i++) {
+    if (counts[i] > 0) {
+      sum += countLogCount(counts[i]);
+    }
+  }
+
+  return sum;
+}/*sumCountLogCount(int *,int)*/
+
+double sumUintCountLogCount(uint *counts, int numStates) {
+  double sum = 0.0;
+  int i;
+
+  for (i = 0; i < numStates; i++) {
+    if (counts[i] > 0) {
+      sum += countLogCount(counts[i]);
+    }
+  }
+
+  return sum;
+}/*sumUintCountLogCount(uint *,int)*/
+
+double sumDoubleCountLogCount(double *counts, int numStates) {
+  double sum = 0.0;
+  int i;
+
+  for (i = 0; i < numStates; i++) {
+    sum += countLogCount(counts[i]);
+  }
+
+  return sum;
+}/*sumDoubleCountLogCount(double *,int)*/
+
+double entropyFromSums(double length, double countSum) {
+  if (length > 0) {
+    return (log(length) - countSum / length) / log(LOG_BASE);
+  } else {
+    return 0.0;
+  }
+}/*entropyFromSums(double,double)*/
+
+double conditionalEntropyFromSums(double length, double jointSum, double conditionSum) {
+  if (length > 0) {
+    return (conditionSum - jointSum) / length / log(LOG_BASE);
+  } else {
+    return 0.0;
+  }
+}/*conditionalEntropyFromSums(double,double,double)*/
+
+double mutualInformationFromSums(double length, double jointSum, double firstSum, double secondSum) {
+  if (length > 0) {
+    return (log(length) + (jointSum - firstSum - secondSum) / length) / log(LOG_BASE);
+  } else {
+    return 0.0;
+  }
+}/*mutualInformationFromSums(double,double,double,double)*/
+
+double conditionalMutualInformationFromSums(double length, double jointSum, double firstConditionSum,
+                                            double secondConditionSum, double conditionSum) {
+  if (length > 0) {
+    return (jointSum + conditionSum - firstConditionSum - secondConditionSum) / length / log(LOG_BASE);
+  } else {
+    return 0.0;
+  }
+}/*conditionalMutualInformationFromSums(double,double,double,double,double)*/
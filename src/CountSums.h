@@ -0,0 +1,63 @@
+/*******************************************************************************
+** CountSums.h
+** Part of the mutual information toolbox
+**
+** Contains the \sum c \log c reductions shared by the functions which
+** calculate entropies directly from integer state counts, and the conversions
+** from those sums to H(X), H(X|Y), I(X;Y) and I(X;Y|Z). These are internal
+** helpers for the library sources, so the header lives in src/ and is not
+** installed with the public headers.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+**  Copyright 2010-2026 Adam Pocock, The University Of Manchester
+**  www.cs.manchester.ac.uk
+**
+**  This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef __CountSums_H
+#define __CountSums_H
+
+#include "MIToolbox/MIToolbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+** Returns c \log c, with 0 \log 0 = 0.
+*******************************************************************************/
+double countLogCount(double count);
+
+/*******************************************************************************
+** Returns \sum_i c_i \log c_i over a count array.
+*******************************************************************************/
+double sumCountLogCount(int *counts, int numStates);
+double sumUintCountLogCount(uint *counts, int numStates);
+double sumDoubleCountLogCount(double *counts, int numStates);
+
+/*******************************************************************************
+** Convert the \sum c \log c of each count table into an information value in
+** LOG_BASE units, where length is the number of samples n. Each returns 0 when
+** length is 0.
+**
+** H(X) = \log n - 1/n \sum c(x) \log c(x)
+** H(X|Y) = 1/n (\sum c(y) \log c(y) - \sum c(x,y) \log c(x,y))
+** I(X;Y) = \log n + 1/n (\sum c(x,y) \log c(x,y) - \sum c(x) \log c(x) - \sum c(y) \log c(y))
+** I(X;Y|Z) = 1/n (\sum c(x,y,z) \log c(x,y,z) + \sum c(z) \log c(z)
+**                 - \sum c(x,z) \log c(x,z) - \sum c(y,z) \log c(y,z))
+*******************************************************************************/
+double entropyFromSums(double length, double countSum);
+double conditionalEntropyFromSums(double length, double jointSum, double conditionSum);
+double mutualInformationFromSums(double length, double jointSum, double firstSum, double secondSum);
+double conditionalMutualInformationFromSums(double length, double jointSum, double firstConditionSum,
+                                            double secondConditionSum, double conditionSum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,607 @@
+/*******************************************************************************
+** DataReader.c
+** Part of the mutual information toolbox
+**
+** Contains functions to read CSV and LibSVM files directly into a
+** DiscreteMatrix. Each column is dictionary encoded while parsing, so the
+** result is ready for the uint functions without a separate discretisation
+** pass. When compiled with OpenMP the file is split into byte ranges which
+** are parsed in parallel.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/DiscreteMatrix.h"
+#include "MIToolbox/DataReader.h"
+
+/* Smallest byte range worth giving to a separate thread */
+#define MIN_CHUNK_LENGTH (1 << 20)
+#define INITIAL_CAPACITY 64
+
+/*******************************************************************************
+** A dictionary from (column, token) to a code. The tokens point into the
+** file buffer, and entries are kept in insertion order so the merge can
+** replay them in the order they appeared in the file.
+*******************************************************************************/
+typedef struct tokenEntry
+{
+  const char *token;
+  int length;
+  int column;
+  uint code;
+} TokenEntry;
+
+typedef struct tokenTable
+{
+  TokenEntry *entries;
+  int numEntries;
+  int entryCapacity;
+  int *slots;
+  int numSlots;
+} TokenTable;
+
+typedef struct uintBuffer
+{
+  uint *values;
+  size_t length;
+  size_t capacity;
+} UintBuffer;
+
+/*******************************************************************************
+** The state of a single byte range. Codes in a chunk are indices into the
+** chunk's TokenTable, and are remapped to the final per-column codes after
+** all the chunks are parsed.
+** For CSV files codes holds the row-major fields. For LibSVM files codes
+** holds the labels, and rows, columns & codes hold the non-zero features.
+*******************************************************************************/
+typedef struct parseChunk
+{
+  const char *start;
+  const char *end;
+  TokenTable table;
+  UintBuffer codes;
+  UintBuffer featureRows;
+  UintBuffer featureColumns;
+  UintBuffer featureCodes;
+  int numRows;
+  int maxColumn;
+  int error;
+} ParseChunk;
+
+static void appendUint(UintBuffer *buffer, uint value) {
+  uint *newValues;
+
+  if (buffer->length == buffer->capacity) {
+    buffer->capacity = buffer->capacity == 0 ? INITIAL_CAPACITY : buffer->capacity * 2;
+    newValues = (uint *) checkedCalloc(buffer->capacity,sizeof(uint));
+    if (buffer->length > 0) {
+      memcpy(newValues,buffer->values,buffer->length * sizeof(uint));
+      FREE_FUNC(buffer->values);
+    }
+    buffer->values = newValues;
+  }
+
+  buffer->values[buffer->length] = value;
+  buffer->length++;
+}/*appendUint(UintBuffer *,uint)*/
+
+static void freeUintBuffer(UintBuffer *buffer) {
+  if (buffer->values != NULL) {
+    FREE_FUNC(buffer->values);
+    buffer->values = NULL;
+  }
+}
+
+static uint hashToken(const char *token, int length, int column) {
+  /* FNV-1a */
+  uint hash = 2166136261U ^ (uint) column;
+  int i;
+
+  for (i = 0; i < length; i++) {
+    hash ^= (unsigned char) token[i];
+    hash *= 16777619U;
+  }
+
+  return hash;
+}
+
+static void initTokenTable(TokenTable *table) {
+  table->entryCapacity = INITIAL_CAPACITY;
+  table->entries = (TokenEntry *) checkedCalloc(table->entryCapacity,sizeof(TokenEntry));
+  table->numEntries = 0;
+  table->numSlots = 2 * INITIAL_CAPACITY;
+  table->slots = (int *) checkedCalloc(table->numSlots,sizeof(int));
+}
+
+static void freeTokenTable(TokenTable *table) {
+  if (table->entries != NULL) {
+    FREE_FUNC(table->entries);
+    FREE_FUNC(table->slots);
+    table->entries = NULL;
+    table->slots = NULL;
+  }
+}
+
+/*******************************************************************************
+** Returns the index of the entry for (column, token), adding it with the
+** supplied code if it isn't present. *added is set if the entry is new.
+*******************************************************************************/
+static int findOrAddToken(TokenTable *table, const char *token, int length, int column, uint code, int *added) {
+  TokenEntry *entry;
+  TokenEntry *newEntries;
+  int i, slot, mask;
+
+  mask = table->numSlots - 1;
+  slot = hashToken(token,length,column) & mask;
+  while (table->slots[slot] != 0) {
+    entry = table->entries + (table->slots[slot] - 1);
+    if ((entry->column == column) && (entry->length == length) && (memcmp(entry->token,token,length) == 0)) {
+      *added = 0;
+      return table->slots[slot] - 1;
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  if (table->numEntries == table->entryCapacity) {
+    table->entryCapacity *= 2;
+    newEntries = (TokenEntry *) checkedCalloc(table->entryCapacity,sizeof(TokenEntry));
+    memcpy(newEntries,table->entries,table->numEntries * sizeof(TokenEntry));
+    FREE_FUNC(table->entries);
+    table->entries = newEntries;
+  }
+
+  entry = table->entries + table->numEntries;
+  entry->token = token;
+  entry->length = length;
+  entry->column = column;
+  entry->code = code;
+  table->numEntries++;
+  table->slots[slot] = table->numEntries;
+  *added = 1;
+
+  /* keep the load factor below 1/2 */
+  if (2 * table->numEntries > table->numSlots) {
+    FREE_FUNC(table->slots);
+    table->numSlots *= 2;
+    table->slots = (int *) checkedCalloc(table->numSlots,sizeof(int));
+    mask = table->numSlots - 1;
+    for (i = 0; i < table->numEntries; i++) {
+      entry = table->entries + i;
+      slot = hashToken(entry->token,entry->length,entry->column) & mask;
+      while (table->slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+      }
+      table->slots[slot] = i + 1;
+    }
+  }
+
+  return table->numEntries - 1;
+}/*findOrAddToken(TokenTable *,const char *,int,int,uint,int *)*/
+
+static int chunkToken(ParseChunk *chunk, const char *token, int length, int column) {
+  int added;
+  return findOrAddToken(&(chunk->table),token,length,column,0,&added);
+}
+
+static int isSpace(char c) {
+  return (c == ' ') || (c == '\t') || (c == '\r');
+}
+
+static void trimToken(const char **token, const char **tokenEnd) {
+  while ((*token < *tokenEnd) && isSpace(**token)) {
+    (*token)++;
+  }
+  while ((*tokenEnd > *token) && isSpace(*(*tokenEnd - 1))) {
+    (*tokenEnd)--;
+  }
+}
+
+static const char *lineEnd(const char *position, const char *end) {
+  const char *newline = (const char *) memchr(position,'\n',end - position);
+  return newline == NULL ? end : newline;
+}
+
+static int isBlankLine(const char *position, const char *end) {
+  while ((position < end) && isSpace(*position)) {
+    position++;
+  }
+  return position == end;
+}
+
+static int countFields(const char *position, const char *end, char delimiter) {
+  int numFields = 1;
+
+  for (; position < end; position++) {
+    if (*position == delimiter) {
+      numFields++;
+    }
+  }
+
+  return numFields;
+}
+
+static void parseCSVChunk(ParseChunk *chunk, char delimiter, int numColumns) {
+  const char *position = chunk->start;
+  const char *end, *token, *tokenEnd;
+  int column;
+
+  while ((position < chunk->end) && !chunk->error) {
+    end = lineEnd(position,chunk->end);
+    if (!isBlankLine(position,end)) {
+      column = 0;
+      token = position;
+      while (token <= end) {
+        tokenEnd = token;
+        while ((tokenEnd < end) && (*tokenEnd != delimiter)) {
+          tokenEnd++;
+        }
+        if (column == numColumns) {
+          chunk->error = 1;
+          break;
+        }
+        position = tokenEnd;
+        trimToken(&token,&tokenEnd);
+        appendUint(&(chunk->codes),chunkToken(chunk,token,tokenEnd - token,column));
+        column++;
+        token = position + 1;
+      }
+      if (column != numColumns) {
+        chunk->error = 1;
+      }
+      chunk->numRows++;
+    }
+    position = end + 1;
+  }
+}/*parseCSVChunk(ParseChunk *,char,int)*/
+
+static int isZeroValue(const char *token, int length) {
+  char *parsedEnd;
+  double value = strtod(token,&parsedEnd);
+  return (parsedEnd == token + length) && (value == 0.0);
+}
+
+static void parseLibSVMChunk(ParseChunk *chunk) {
+  const char *position = chunk->start;
+  const char *end, *token, *tokenEnd, *colon, *comment;
+  char *indexEnd;
+  long index;
+
+  while ((position < chunk->end) && !chunk->error) {
+    end = lineEnd(position,chunk->end);
+    comment = (const char *) memchr(position,'#',end - position);
+    if (comment != NULL) {
+      end = comment;
+    }
+    if (!isBlankLine(position,end)) {
+      token = position;
+      while ((token < end) && isSpace(*token)) {
+        token++;
+      }
+      tokenEnd = token;
+      while ((tokenEnd < end) && !isSpace(*tokenEnd)) {
+        tokenEnd++;
+      }
+      appendUint(&(chunk->codes),chunkToken(chunk,token,tokenEnd - token,0));
+
+      token = tokenEnd;
+      while (token < end) {
+        while ((token < end) && isSpace(*token)) {
+          token++;
+        }
+        if (token == end) {
+          break;
+        }
+        tokenEnd = token;
+        while ((tokenEnd < end) && !isSpace(*tokenEnd)) {
+          tokenEnd++;
+        }
+        colon = (const char *) memchr(token,':',tokenEnd - token);
+        index = strtol(token,&indexEnd,10);
+        if ((colon == NULL) || (indexEnd != colon) || (index < 1) || (index >= INT_MAX)) {
+          chunk->error = 1;
+          break;
+        }
+        colon++;
+        if (!isZeroValue(colon,tokenEnd - colon)) {
+          appendUint(&(chunk->featureRows),chunk->numRows);
+          appendUint(&(chunk->featureColumns),(uint) index);
+          appendUint(&(chunk->featureCodes),chunkToken(chunk,colon,tokenEnd - colon,(int) index));
+        }
+        if (index > chunk->maxColumn) {
+          chunk->maxColumn = (int) index;
+        }
+        token = tokenEnd;
+      }
+      chunk->numRows++;
+    }
+    position = lineEnd(position,chunk->end) + 1;
+  }
+}/*parseLibSVMChunk(ParseChunk *)*/
+
+/*******************************************************************************
+** Reads the whole file into a NUL terminated buffer.
+*******************************************************************************/
+static char *readFile(const char *fileName, size_t *length) {
+  char *contents;
+  long fileLength;
+  FILE *file = fopen(fileName,"rb");
+
+  if (file == NULL) {
+    return NULL;
+  }
+  if ((fseek(file,0,SEEK_END) != 0) || ((fileLength = ftell(file)) < 0) || (fseek(file,0,SEEK_SET) != 0)) {
+    fclose(file);
+    return NULL;
+  }
+
+  contents = (char *) checkedCalloc(fileLength + 1,sizeof(char));
+  if (fread(contents,1,fileLength,file) != (size_t) fileLength) {
+    FREE_FUNC(contents);
+    fclose(file);
+    return NULL;
+  }
+
+  fclose(file);
+  *length = fileLength;
+  return contents;
+}/*readFile(const char *,size_t *)*/
+
+/*******************************************************************************
+** Splits [start,end) into byte ranges which begin at the start of a line.
+*******************************************************************************/
+static ParseChunk *splitChunks(const char *start, const char *end, int *numChunks) {
+  ParseChunk *chunks;
+  size_t length = end - start;
+  const char *boundary;
+  int i, maxChunks = 1;
+
+#ifdef _OPENMP
+  maxChunks = omp_get_max_threads();
+#endif
+  if ((size_t) maxChunks > length / MIN_CHUNK_LENGTH + 1) {
+    maxChunks = (int) (length / MIN_CHUNK_LENGTH + 1);
+  }
+
+  chunks = (ParseChunk *) checkedCalloc(maxChunks,sizeof(ParseChunk));
+  for (i = 0; i < maxChunks; i++) {
+    boundary = start + (length / maxChunks) * i;
+    if ((i > 0) && (boundary > start)) {
+      boundary = lineEnd(boundary - 1,end);
+      boundary = boundary < end ? boundary + 1 : end;
+    }
+    if ((i > 0) && (boundary < chunks[i-1].start)) {
+      boundary = chunks[i-1].start;
+    }
+    chunks[i].start = boundary;
+    initTokenTable(&(chunks[i].table));
+  }
+  for (i = 0; i < maxChunks - 1; i++) {
+    chunks[i].end = chunks[i+1].start;
+  }
+  chunks[maxChunks-1].end = end;
+
+  *numChunks = maxChunks;
+  return chunks;
+}/*splitChunks(const char *,const char *,int *)*/
+
+static void freeChunks(ParseChunk *chunks, int numChunks) {
+  int i;
+
+  for (i = 0; i < numChunks; i++) {
+    freeTokenTable(&(chunks[i].table));
+    freeUintBuffer(&(chunks[i].codes));
+    freeUintBuffer(&(chunks[i].featureRows));
+    freeUintBuffer(&(chunks[i].featureColumns));
+    freeUintBuffer(&(chunks[i].featureCodes));
+  }
+
+  FREE_FUNC(chunks);
+}/*freeChunks(ParseChunk *,int)*/
+
+/*******************************************************************************
+** Replays each chunk's dictionary in file order into a global dictionary,
+** assigning per-column codes from arities, and returns a remapping from
+** each chunk's local codes to the global codes.
+*******************************************************************************/
+static uint **mergeDictionaries(ParseChunk *chunks, int numChunks, int *arities) {
+  TokenTable globalTable;
+  TokenEntry *entry;
+  uint **remaps = (uint **) checkedCalloc(numChunks,sizeof(uint *));
+  int i, j, index, added;
+
+  initTokenTable(&globalTable);
+
+  for (i = 0; i < numChunks; i++) {
+    remaps[i] = (uint *) checkedCalloc(chunks[i].table.numEntries + 1,sizeof(uint));
+    for (j = 0; j < chunks[i].table.numEntries; j++) {
+      entry = chunks[i].table.entries + j;
+      index = findOrAddToken(&globalTable,entry->token,entry->length,entry->column,arities[entry->column],&added);
+      if (added) {
+        arities[entry->column]++;
+      }
+      remaps[i][j] = globalTable.entries[index].code;
+    }
+  }
+
+  freeTokenTable(&globalTable);
+
+  return remaps;
+}/*mergeDictionaries(ParseChunk *,int,int *)*/
+
+static void freeRemaps(uint **remaps, int numChunks) {
+  int i;
+
+  for (i = 0; i < numChunks; i++) {
+    FREE_FUNC(remaps[i]);
+  }
+
+  FREE_FUNC(remaps);
+}
+
+int readCSVFile(const char *fileName, char delimiter, int hasHeader, DiscreteMatrix *matrix) {
+  ParseChunk *chunks;
+  uint **remaps;
+  char *contents;
+  const char *start, *end;
+  size_t length;
+  int *rowOffsets;
+  int i, row, column, numChunks, numColumns, error;
+
+  contents = readFile(fileName,&length);
+  if (contents == NULL) {
+    return -1;
+  }
+
+  /* the first non-blank line fixes the number of columns */
+  start = contents;
+  end = contents + length;
+  while ((start < end) && isBlankLine(start,lineEnd(start,end))) {
+    start = lineEnd(start,end) + 1;
+  }
+  if (start >= end) {
+    FREE_FUNC(contents);
+    return -1;
+  }
+  numColumns = countFields(start,lineEnd(start,end),delimiter);
+  if (hasHeader) {
+    start = lineEnd(start,end) + 1;
+    if (start > end) {
+      start = end;
+    }
+  }
+
+  chunks = splitChunks(start,end,&numChunks);
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic,1)
+#endif
+  for (i = 0; i < numChunks; i++) {
+    parseCSVChunk(chunks + i,delimiter,numColumns);
+  }
+
+  error = 0;
+  rowOffsets = (int *) checkedCalloc(numChunks + 1,sizeof(int));
+  for (i = 0; i < numChunks; i++) {
+    error |= chunks[i].error;
+    rowOffsets[i+1] = rowOffsets[i] + chunks[i].numRows;
+  }
+
+  if (error) {
+    FREE_FUNC(rowOffsets);
+    freeChunks(chunks,numChunks);
+    FREE_FUNC(contents);
+    return -1;
+  }
+
+  matrix->numSamples = rowOffsets[numChunks];
+  matrix->numFeatures = numColumns;
+  matrix->arities = (int *) checkedCalloc(numColumns,sizeof(int));
+  matrix->matrix = (uint *) checkedCalloc((size_t) matrix->numSamples * numColumns + 1,sizeof(uint));
+
+  remaps = mergeDictionaries(chunks,numChunks,matrix->arities);
+
+#ifdef _OPENMP
+  #pragma omp parallel for private(row,column) schedule(dynamic,1)
+#endif
+  for (i = 0; i < numChunks; i++) {
+    uint *codes = chunks[i].codes.values;
+    for (row = 0; row < chunks[i].numRows; row++) {
+      for (column = 0; column < numColumns; column++) {
+        matrix->matrix[(size_t) column * matrix->numSamples + rowOffsets[i] + row] = remaps[i][codes[(size_t) row * numColumns + column]];
+      }
+    }
+  }
+
+  freeRemaps(remaps,numChunks);
+  FREE_FUNC(rowOffsets);
+  freeChunks(chunks,numChunks);
+  FREE_FUNC(contents);
+
+  return 0;
+}/*readCSVFile(const char *,char,int,DiscreteMatrix *)*/
+
+int readLibSVMFile(const char *fileName, DiscreteMatrix *matrix) {
+  ParseChunk *chunks;
+  uint **remaps;
+  char *contents;
+  size_t length, j;
+  int *rowOffsets;
+  int i, numChunks, numColumns, error;
+
+  contents = readFile(fileName,&length);
+  if (contents == NULL) {
+    return -1;
+  }
+
+  chunks = splitChunks(contents,contents + length,&numChunks);
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic,1)
+#endif
+  for (i = 0; i < numChunks; i++) {
+    parseLibSVMChunk(chunks + i);
+  }
+
+  error = 0;
+  numColumns = 1;
+  rowOffsets = (int *) checkedCalloc(numChunks + 1,sizeof(int));
+  for (i = 0; i < numChunks; i++) {
+    error |= chunks[i].error;
+    rowOffsets[i+1] = rowOffsets[i] + chunks[i].numRows;
+    if (chunks[i].maxColumn + 1 > numColumns) {
+      numColumns = chunks[i].maxColumn + 1;
+    }
+  }
+
+  if (error) {
+    FREE_FUNC(rowOffsets);
+    freeChunks(chunks,numChunks);
+    FREE_FUNC(contents);
+    return -1;
+  }
+
+  matrix->numSamples = rowOffsets[numChunks];
+  matrix->numFeatures = numColumns;
+  matrix->arities = (int *) checkedCalloc(numColumns,sizeof(int));
+  matrix->matrix = (uint *) checkedCalloc((size_t) matrix->numSamples * numColumns + 1,sizeof(uint));
+
+  /* state 0 of every feature column is the value zero */
+  for (i = 1; i < numColumns; i++) {
+    matrix->arities[i] = 1;
+  }
+
+  remaps = mergeDictionaries(chunks,numChunks,matrix->arities);
+
+#ifdef _OPENMP
+  #pragma omp parallel for private(j) schedule(dynamic,1)
+#endif
+  for (i = 0; i < numChunks; i++) {
+    for (j = 0; j < chunks[i].codes.length; j++) {
+      matrix->matrix[rowOffsets[i] + j] = remaps[i][chunks[i].codes.values[j]];
+    }
+    for (j = 0; j < chunks[i].featureCodes.length; j++) {
+      matrix->matrix[(size_t) chunks[i].featureColumns.values[j] * matrix->numSamples + rowOffsets[i] + chunks[i].featureRows.values[j]] = remaps[i][chunks[i].featureCodes.values[j]];
+    }
+  }
+
+  freeRemaps(remaps,numChunks);
+  FREE_FUNC(rowOffsets);
+  freeChunks(chunks,numChunks);
+  FREE_FUNC(contents);
+
+  return 0;
+}/*readLibSVMFile(const char *,DiscreteMatrix *)*/
@@ -0,0 +1,388 @@
+/*******************************************************************************
+** DiscreteMatrix.c
+** Part of the mutual information toolbox
+**
+** Contains a column-major matrix of discrete features with their arities,
+** and functions to write it to and memory map it from a columnar binary file
+** so it can be used without parsing or discretising the data again.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef _WIN32
+  #define _POSIX_C_SOURCE 200112L
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+#include <stdio.h>
+#include <limits.h>
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/DiscreteMatrix.h"
+
+#define MATRIX_MAGIC "MITXDMAT"
+#define MATRIX_VERSION 1U
+#define MATRIX_BYTE_ORDER 0x01020304U
+#define MATRIX_HEADER_LENGTH 32
+#define MATRIX_DESCRIPTOR_LENGTH 16
+#define MATRIX_ALIGNMENT 64
+
+static size_t alignOffset(size_t offset) {
+  return ((offset + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT) * MATRIX_ALIGNMENT;
+}
+
+static int codeWidth(int arity, int compact) {
+  if (compact && (arity <= 0x100)) {
+    return 1;
+  } else if (compact && (arity <= 0x10000)) {
+    return 2;
+  } else {
+    return sizeof(uint);
+  }
+}
+
+static int writePadding(FILE *file, size_t length) {
+  static const unsigned char zeros[MATRIX_ALIGNMENT] = {0};
+  return fwrite(zeros,1,length,file) == length ? 0 : -1;
+}
+
+int writeDiscreteMatrix(const char *fileName, DiscreteMatrix matrix, int compact) {
+  FILE *file;
+  uint header[6];
+  uint descriptor[4];
+  size_t offset, columnLength, position;
+  unsigned char *buffer;
+  unsigned short *shortBuffer;
+  uint *column;
+  int i, j, width;
+  int status = 0;
+
+  for (j = 0; j < matrix.numFeatures; j++) {
+    column = matrix.matrix + (size_t) j * matrix.numSamples;
+    for (i = 0; i < matrix.numSamples; i++) {
+      if ((matrix.arities[j] < 0) || (column[i] >= (uint) matrix.arities[j])) {
+        return -1;
+      }
+    }
+  }
+
+  file = fopen(fileName,"wb");
+  if (file == NULL) {
+    return -1;
+  }
+
+  memcpy(header,MATRIX_MAGIC,8);
+  header[2] = MATRIX_VERSION;
+  header[3] = MATRIX_BYTE_ORDER;
+  header[4] = matrix.numSamples;
+  header[5] = matrix.numFeatures;
+  if ((fwrite(header,sizeof(uint),6,file) != 6) || writePadding(file,MATRIX_HEADER_LENGTH - sizeof(header))) {
+    fclose(file);
+    return -1;
+  }
+
+  /* descriptors */
+  offset = alignOffset(MATRIX_HEADER_LENGTH + (size_t) matrix.numFeatures * MATRIX_DESCRIPTOR_LENGTH);
+  for (j = 0; j < matrix.numFeatures; j++) {
+    width = codeWidth(matrix.arities[j],compact);
+    descriptor[0] = matrix.arities[j];
+    descriptor[1] = width;
+    descriptor[2] = (uint) (offset & 0xFFFFFFFFU);
+    descriptor[3] = (uint) ((offset >> 16) >> 16);
+    if (fwrite(descriptor,sizeof(uint),4,file) != 4) {
+      fclose(file);
+      return -1;
+    }
+    offset = alignOffset(offset + (size_t) matrix.numSamples * width);
+  }
+
+  /* column blocks */
+  buffer = (unsigned char *) checkedCalloc(matrix.numSamples > 0 ? matrix.numSamples : 1,sizeof(uint));
+  shortBuffer = (unsigned short *) buffer;
+  position = MATRIX_HEADER_LENGTH + (size_t) matrix.numFeatures * MATRIX_DESCRIPTOR_LENGTH;
+  for (j = 0; (j < matrix.numFeatures) && (status == 0); j++) {
+    width = codeWidth(matrix.arities[j],compact);
+    column = matrix.matrix + (size_t) j * matrix.numSamples;
+    columnLength = (size_t) matrix.numSamples * width;
+
+    status = writePadding(file,alignOffset(position) - position);
+    position = alignOffset(position);
+
+    if (width == 1) {
+      for (i = 0; i < matrix.numSamples; i++) {
+        buffer[i] = (unsigned char) column[i];
+      }
+      status |= fwrite(buffer,1,columnLength,file) == columnLength ? 0 : -1;
+    } else if (width == 2) {
+      for (i = 0; i < matrix.numSamples; i++) {
+        shortBuffer[i] = (unsigned short) column[i];
+      }
+      status |= fwrite(shortBuffer,1,columnLength,file) == columnLength ? 0 : -1;
+    } else {
+      status |= fwrite(column,1,columnLength,file) == columnLength ? 0 : -1;
+    }
+    position += columnLength;
+  }
+
+  FREE_FUNC(buffer);
+  buffer = NULL;
+
+  if (fclose(file) != 0) {
+    status = -1;
+  }
+
+  return status;
+}/*writeDiscreteMatrix(const char *,DiscreteMatrix,int)*/
+
+/*******************************************************************************
+** Maps the whole file, falling back to reading it into memory on platforms
+** without mmap. Returns NULL on failure.
+*******************************************************************************/
+static unsigned char *mapFile(const char *fileName, size_t *length) {
+#ifdef _WIN32
+  unsigned char *contents;
+  long fileLength;
+  FILE *file = fopen(fileName,"rb");
+
+  if (file == NULL) {
+    return NULL;
+  }
+  if ((fseek(file,0,SEEK_END) != 0) || ((fileLength = ftell(file)) < 0) || (fseek(file,0,SEEK_SET) != 0)) {
+    fclose(file);
+    return NULL;
+  }
+  contents = (unsigned char *) checkedCalloc(fileLength > 0 ? fileLength : 1,1);
+  if (fread(contents,1,fileLength,file) != (size_t) fileLength) {
+    FREE_FUNC(contents);
+    fclose(file);
+    return NULL;
+  }
+  fclose(file);
+  *length = fileLength;
+  return contents;
+#else
+  struct stat fileStats;
+  void *mapping;
+  int fd = open(fileName,O_RDONLY);
+
+  if (fd < 0) {
+    return NULL;
+  }
+  if ((fstat(fd,&fileStats) != 0) || (fileStats.st_size < MATRIX_HEADER_LENGTH)) {
+    close(fd);
+    return NULL;
+  }
+  mapping = mmap(NULL,fileStats.st_size,PROT_READ | PROT_WRITE,MAP_PRIVATE,fd,0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return NULL;
+  }
+  *length = fileStats.st_size;
+  return (unsigned char *) mapping;
+#endif
+}/*mapFile(const char *,size_t *)*/
+
+static void unmapFile(unsigned char *mapping, size_t length) {
+#ifdef _WIN32
+  FREE_FUNC(mapping);
+#else
+  munmap(mapping,length);
+#endif
+}/*unmapFile(unsigned char *,size_t)*/
+
+/*******************************************************************************
+** Returns 1 if every code in the column is below its arity. Narrow columns
+** whose arity exceeds the largest code they can hold are always valid.
+*******************************************************************************/
+static int validColumn(MappedMatrix *matrix, int column) {
+  unsigned char *bytes = matrix->columns[column];
+  unsigned short *shorts = (unsigned short *) matrix->columns[column];
+  uint *codes = (uint *) matrix->columns[column];
+  uint arity = matrix->arities[column];
+  int i;
+
+  if (matrix->numSamples == 0) {
+    return 1;
+  }
+
+  if (matrix->codeWidths[column] == 1) {
+    if (arity > 0xFF) {
+      return 1;
+    }
+    for (i = 0; i < matrix->numSamples; i++) {
+      if (bytes[i] >= arity) {
+        return 0;
+      }
+    }
+  } else if (matrix->codeWidths[column] == 2) {
+    if (arity > 0xFFFF) {
+      return 1;
+    }
+    for (i = 0; i < matrix->numSamples; i++) {
+      if (shorts[i] >= arity) {
+        return 0;
+      }
+    }
+  } else {
+    for (i = 0; i < matrix->numSamples; i++) {
+      if (codes[i] >= arity) {
+        return 0;
+      }
+    }
+  }
+
+  return 1;
+}/*validColumn(MappedMatrix *,int)*/
+
+static int mapMatrix(const char *fileName, MappedMatrix *matrix, int validate) {
+  unsigned char *mapping;
+  size_t length, offset;
+  uint header[6];
+  uint descriptor[4];
+  int j, width;
+
+  mapping = mapFile(fileName,&length);
+  if (mapping == NULL) {
+    return -1;
+  }
+
+  if (length < MATRIX_HEADER_LENGTH) {
+    unmapFile(mapping,length);
+    return -1;
+  }
+
+  memcpy(header,mapping,sizeof(header));
+  if ((memcmp(header,MATRIX_MAGIC,8) != 0) || (header[2] != MATRIX_VERSION)
+      || (header[3] != MATRIX_BYTE_ORDER) || (header[4] > INT_MAX) || (header[5] > INT_MAX)
+      || (length < MATRIX_HEADER_LENGTH + (size_t) header[5] * MATRIX_DESCRIPTOR_LENGTH)) {
+    unmapFile(mapping,length);
+    return -1;
+  }
+
+  matrix->mapping = mapping;
+  matrix->mappingLength = length;
+  matrix->numSamples = header[4];
+  matrix->numFeatures = header[5];
+  matrix->columns = (unsigned char **) checkedCalloc(matrix->numFeatures + 1,sizeof(unsigned char *));
+  matrix->codeWidths = (int *) checkedCalloc(matrix->numFeatures + 1,sizeof(int));
+  matrix->arities = (int *) checkedCalloc(matrix->numFeatures + 1,sizeof(int));
+
+  for (j = 0; j < matrix->numFeatures; j++) {
+    memcpy(descriptor,mapping + MATRIX_HEADER_LENGTH + (size_t) j * MATRIX_DESCRIPTOR_LENGTH,sizeof(descriptor));
+    width = descriptor[1];
+    offset = descriptor[2] + (((size_t) descriptor[3] << 16) << 16);
+
+    if (((width != 1) && (width != 2) && (width != sizeof(uint))) || (descriptor[0] > INT_MAX)
+        || (offset % MATRIX_ALIGNMENT != 0) || (offset > length)
+        || ((length - offset) / width < (size_t) matrix->numSamples)) {
+      unmapDiscreteMatrix(*matrix);
+      return -1;
+    }
+
+    matrix->arities[j] = descriptor[0];
+    matrix->codeWidths[j] = width;
+    matrix->columns[j] = mapping + offset;
+
+    if (validate && !validColumn(matrix,j)) {
+      unmapDiscreteMatrix(*matrix);
+      return -1;
+    }
+  }
+
+  return 0;
+}/*mapMatrix(const char *,MappedMatrix *,int)*/
+
+int mapDiscreteMatrix(const char *fileName, MappedMatrix *matrix) {
+  return mapMatrix(fileName,matrix,1);
+}/*mapDiscreteMatrix(const char *,MappedMatrix *)*/
+
+int mapDiscreteMatrixUnvalidated(const char *fileName, MappedMatrix *matrix) {
+  return mapMatrix(fileName,matrix,0);
+}/*mapDiscreteMatrixUnvalidated(const char *,MappedMatrix *)*/
+
+uint *mappedColumn(MappedMatrix matrix, int column) {
+  if (matrix.codeWidths[column] == sizeof(uint)) {
+    return (uint *) matrix.columns[column];
+  } else {
+    return NULL;
+  }
+}/*mappedColumn(MappedMatrix,int)*/
+
+unsigned char *mappedColumnUint8(MappedMatrix matrix, int column) {
+  if (matrix.codeWidths[column] == 1) {
+    return matrix.columns[column];
+  } else {
+    return NULL;
+  }
+}/*mappedColumnUint8(MappedMatrix,int)*/
+
+unsigned short *mappedColumnUint16(MappedMatrix matrix, int column) {
+  if (matrix.codeWidths[column] == 2) {
+    return (unsigned short *) matrix.columns[column];
+  } else {
+    return NULL;
+  }
+}/*mappedColumnUint16(MappedMatrix,int)*/
+
+void copyMappedColumn(MappedMatrix matrix, int column, uint *outputVector) {
+  unsigned char *bytes = matrix.columns[column];
+  unsigned short *shorts = (unsigned short *) matrix.columns[column];
+  int i;
+
+  if (matrix.codeWidths[column] == 1) {
+    for (i = 0; i < matrix.numSamples; i++) {
+      outputVector[i] = bytes[i];
+    }
+  } else if (matrix.codeWidths[column] == 2) {
+    for (i = 0; i < matrix.numSamples; i++) {
+      outputVector[i] = shorts[i];
+    }
+  } else {
+    memcpy(outputVector,bytes,(size_t) matrix.numSamples * sizeof(uint));
+  }
+}/*copyMappedColumn(MappedMatrix,int,uint *)*/
+
+uint **generateMappedIntIndices(MappedMatrix matrix) {
+  uint **feature2D;
+  int j;
+
+  for (j = 0; j < matrix.numFeatures; j++) {
+    if (matrix.codeWidths[j] != sizeof(uint)) {
+      return NULL;
+    }
+  }
+
+  feature2D = (uint **) checkedCalloc(matrix.numFeatures + 1,sizeof(uint *));
+  for (j = 0; j < matrix.numFeatures; j++) {
+    feature2D[j] = (uint *) matrix.columns[j];
+  }
+
+  return feature2D;
+}/*generateMappedIntIndices(MappedMatrix)*/
+
+void freeDiscreteMatrix(DiscreteMatrix matrix) {
+  FREE_FUNC(matrix.matrix);
+  matrix.matrix = NULL;
+  FREE_FUNC(matrix.arities);
+  matrix.arities = NULL;
+}
+
+void unmapDiscreteMatrix(MappedMatrix matrix) {
+  unmapFile(matrix.mapping,matrix.mappingLength);
+  matrix.mapping = NULL;
+  FREE_FUNC(matrix.columns);
+  matrix.columns = NULL;
+  FREE_FUNC(matrix.codeWidths);
+  matrix.codeWidths = NULL;
+  FREE_FUNC(matrix.arities);
+  matrix.arities = NULL;
+}
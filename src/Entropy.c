@@ -18,20 +18,16 @@
 #include "MIToolbox/MIToolbox.h"
 #include "MIToolbox/CalculateProbability.h"
 #include "MIToolbox/Entropy.h"
+#include "MIToolbox/Instrumentation.h"
+#include "MIToolbox/Kernels.h"
 
 double entropy(ProbabilityState state) {
     double entropy = 0.0;
-    double tempValue = 0.0;
-    int i;
 
     /*H(X) = - \sum p(x) \log p(x)*/
-    for (i = 0; i < state.numStates; i++) {
-        tempValue = state.probabilityVector[i];
-
-        if (tempValue > 0) {
-            entropy -= tempValue * log(tempValue);
-        }
-    }
+    INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+    entropy = activeKernels->entropySum(state.probabilityVector,state.numStates);
+    INSTRUMENT_PHASE_END();
 
     entropy /= log(LOG_BASE);
 
@@ -39,35 +35,40 @@ double entropy(ProbabilityState state) {
 }
 
 double discAndCalcEntropy(double* dataVector, int vectorLength) {
-    ProbabilityState state = discAndCalcProbability(dataVector, vectorLength);
-    double h = entropy(state);
+    ProbabilityState state;
+    double h;
+
+    INSTRUMENT_ENTER("discAndCalcEntropy",vectorLength);
+    state = discAndCalcProbability(dataVector, vectorLength);
+    h = entropy(state);
 
     freeProbabilityState(state);
+    INSTRUMENT_EXIT();
 
     return h;
 }/*discAndCalcEntropy(double* ,int)*/
 
 double calcEntropy(uint* dataVector, int vectorLength) {
-    ProbabilityState state = calculateProbability(dataVector, vectorLength);
-    double h = entropy(state);
+    ProbabilityState state;
+    double h;
+
+    INSTRUMENT_ENTER("calcEntropy",vectorLength);
+    state = calculateProbability(dataVector, vectorLength);
+    h = entropy(state);
 
     freeProbabilityState(state);
-    
+    INSTRUMENT_EXIT();
+
     return h;
 }/*calcEntropy(uint* ,int)*/
 
 double jointEntropy(JointProbabilityState state) {
     double jointEntropy = 0.0;
-    double tempValue = 0.0;
-    int i;
     
     /*H(XY) = - \sum_x \sum_y p(xy) \log p(xy)*/
-    for (i = 0; i < state.numJointStates; i++) {
-        tempValue = state.jointProbabilityVector[i];
-        if (tempValue > 0) {
-            jointEntropy -= tempValue * log(tempValue);
-        }
-    }
+    INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+    jointEntropy = activeKernels->entropySum(state.jointProbabilityVector,state.numJointStates);
+    INSTRUMENT_PHASE_END();
 
     jointEntropy /= log(LOG_BASE);
 
@@ -75,39 +76,41 @@ double jointEntropy(JointProbabilityState state) {
 }
 
 double discAndCalcJointEntropy(double *firstVector, double *secondVector, int vectorLength) {
-    JointProbabilityState state = discAndCalcJointProbability(firstVector, secondVector, vectorLength);
-    double h = jointEntropy(state);
+    JointProbabilityState state;
+    double h;
+
+    INSTRUMENT_ENTER("discAndCalcJointEntropy",vectorLength);
+    state = discAndCalcJointProbability(firstVector, secondVector, vectorLength);
+    h = jointEntropy(state);
 
     freeJointProbabilityState(state);
+    INSTRUMENT_EXIT();
 
     return h;
 }/*discAndCalcJointEntropy(double *, double *, int)*/
 
 double calcJointEntropy(uint *firstVector, uint *secondVector, int vectorLength) {
-    JointProbabilityState state = calculateJointProbability(firstVector, secondVector, vectorLength);
-    double h = jointEntropy(state);
+    JointProbabilityState state;
+    double h;
+
+    INSTRUMENT_ENTER("calcJointEntropy",vectorLength);
+    state = calculateJointProbability(firstVector, secondVector, vectorLength);
+    h = jointEntropy(state);
 
     freeJointProbabilityState(state);
+    INSTRUMENT_EXIT();
 
     return h;
 }/*calcJointEntropy(uint *, uint *, int)*/
 
 double condEntropy(JointProbabilityState state) {
     double condEntropy = 0.0;
-    double jointValue = 0.0;
-    double condValue = 0.0;
-    int i;
 
     /*H(X|Y) = - \sum_x \sum_y p(x,y) \log p(x,y)/p(y)*/
-    /** Indexing by numFirstStates use modulus of i
-     ** Indexing by numSecondStates use integer division of i by numFirstStates*/
-    for (i = 0; i < state.numJointStates; i++) {
-        jointValue = state.jointProbabilityVector[i];
-        condValue = state.secondProbabilityVector[i / state.numFirstStates];
-        if ((jointValue > 0) && (condValue > 0)) {
-            condEntropy -= jointValue * log(jointValue / condValue);
-        }
-    }
+    INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+    condEntropy = activeKernels->condEntropySum(state.jointProbabilityVector,state.secondProbabilityVector,
+                                                state.numFirstStates,state.numJointStates);
+    INSTRUMENT_PHASE_END();
 
     condEntropy /= log(LOG_BASE);
 
@@ -115,19 +118,29 @@ double condEntropy(JointProbabilityState state) {
 }
 
 double discAndCalcConditionalEntropy(double *dataVector, double *conditionVector, int vectorLength) {
-    JointProbabilityState state = discAndCalcJointProbability(dataVector, conditionVector, vectorLength);
-    double h = condEntropy(state);
+    JointProbabilityState state;
+    double h;
+
+    INSTRUMENT_ENTER("discAndCalcConditionalEntropy",vectorLength);
+    state = discAndCalcJointProbability(dataVector, conditionVector, vectorLength);
+    h = condEntropy(state);
 
     freeJointProbabilityState(state);
+    INSTRUMENT_EXIT();
 
     return h;
 }/*discAndCalcConditionalEntropy(double *, double *, int)*/
 
 double calcConditionalEntropy(uint *dataVector, uint *conditionVector, int vectorLength) {
-    JointProbabilityState state = calculateJointProbability(dataVector, conditionVector, vectorLength);
-    double h = condEntropy(state);
+    JointProbabilityState state;
+    double h;
+
+    INSTRUMENT_ENTER("calcConditionalEntropy",vectorLength);
+    state = calculateJointProbability(dataVector, conditionVector, vectorLength);
+    h = condEntropy(state);
 
     freeJointProbabilityState(state);
+    INSTRUMENT_EXIT();
 
     return h;
 }/*calcConditionalEntropy(uint *, uint *, int)*/
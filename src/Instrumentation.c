@@ -0,0 +1,145 @@
+/*******************************************************************************
+** Instrumentation.c
+** Part of the mutual information toolbox
+**
+** Contains optional per-thread counters which record how many calls were
+** made, how many samples and histogram cells they processed, how many bytes
+** they allocated, and how long they spent in each phase. The library
+** records into them only when compiled with MITOOLBOX_INSTRUMENT defined.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#ifndef _WIN32
+  #define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <time.h>
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/Instrumentation.h"
+
+#ifdef _MSC_VER
+  #define THREAD_LOCAL __declspec(thread)
+#else
+  #define THREAD_LOCAL __thread
+#endif
+
+/* Deepest nesting of phases which is timed */
+#define MAX_PHASE_DEPTH 16
+
+typedef struct itState
+{
+  InstrumentCounters counters;
+  InstrumentCounters callStart;
+  const char *functionName;
+  int callDepth;
+  InstrumentPhase phaseStack[MAX_PHASE_DEPTH];
+  int phaseDepth;
+  double phaseStart;
+} InstrumentThreadState;
+
+static THREAD_LOCAL InstrumentThreadState threadState;
+
+static InstrumentCallback instrumentCallback = NULL;
+static void *instrumentUserData = NULL;
+
+static double now(void) {
+#ifdef _WIN32
+  return (double) clock() / CLOCKS_PER_SEC;
+#else
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC,&time);
+  return time.tv_sec + time.tv_nsec / 1e9;
+#endif
+}
+
+void snapshotInstrumentCounters(InstrumentCounters *counters) {
+  *counters = threadState.counters;
+}/*snapshotInstrumentCounters(InstrumentCounters *)*/
+
+void resetInstrumentCounters(void) {
+  memset(&threadState.counters,0,sizeof(InstrumentCounters));
+  threadState.callStart = threadState.counters;
+}/*resetInstrumentCounters()*/
+
+void setInstrumentCallback(InstrumentCallback callback, void *userData) {
+  instrumentCallback = callback;
+  instrumentUserData = userData;
+}/*setInstrumentCallback(InstrumentCallback,void *)*/
+
+/*******************************************************************************
+** Only the outermost call is counted, so the functions which call other
+** public functions report once with the totals of their callees.
+*******************************************************************************/
+void instrumentEnter(const char *functionName, int vectorLength) {
+  if (threadState.callDepth == 0) {
+    threadState.callStart = threadState.counters;
+    threadState.functionName = functionName;
+    threadState.counters.calls++;
+    threadState.counters.samples += vectorLength;
+  }
+  threadState.callDepth++;
+}/*instrumentEnter(const char *,int)*/
+
+void instrumentExit(void) {
+  InstrumentCounters callCounters;
+  InstrumentCallback callback = instrumentCallback;
+  int i;
+
+  threadState.callDepth--;
+  if ((threadState.callDepth == 0) && (callback != NULL)) {
+    callCounters.calls = threadState.counters.calls - threadState.callStart.calls;
+    callCounters.allocations = threadState.counters.allocations - threadState.callStart.allocations;
+    callCounters.samples = threadState.counters.samples - threadState.callStart.samples;
+    callCounters.cells = threadState.counters.cells - threadState.callStart.cells;
+    callCounters.bytesAllocated = threadState.counters.bytesAllocated - threadState.callStart.bytesAllocated;
+    for (i = 0; i < NUM_INSTRUMENT_PHASES; i++) {
+      callCounters.phaseSeconds[i] = threadState.counters.phaseSeconds[i] - threadState.callStart.phaseSeconds[i];
+    }
+    callback(threadState.functionName,&callCounters,instrumentUserData);
+  }
+}/*instrumentExit()*/
+
+/*******************************************************************************
+** Beginning a phase pauses the enclosing phase, so each phase is charged
+** only for its own time (e.g. the allocation inside normaliseArray).
+*******************************************************************************/
+void instrumentPhaseBegin(InstrumentPhase phase) {
+  double time = now();
+  int depth = threadState.phaseDepth;
+
+  if ((depth > 0) && (depth <= MAX_PHASE_DEPTH)) {
+    threadState.counters.phaseSeconds[threadState.phaseStack[depth-1]] += time - threadState.phaseStart;
+  }
+  if (depth < MAX_PHASE_DEPTH) {
+    threadState.phaseStack[depth] = phase;
+  }
+  threadState.phaseDepth++;
+  threadState.phaseStart = time;
+}/*instrumentPhaseBegin(InstrumentPhase)*/
+
+void instrumentPhaseEnd(void) {
+  double time = now();
+  int depth = threadState.phaseDepth;
+
+  if ((depth > 0) && (depth <= MAX_PHASE_DEPTH)) {
+    threadState.counters.phaseSeconds[threadState.phaseStack[depth-1]] += time - threadState.phaseStart;
+  }
+  threadState.phaseDepth--;
+  threadState.phaseStart = time;
+}/*instrumentPhaseEnd()*/
+
+void instrumentCells(double cells) {
+  threadState.counters.cells += cells;
+}/*instrumentCells(double)*/
+
+void instrumentAllocation(double bytes) {
+  threadState.counters.allocations++;
+  threadState.counters.bytesAllocated += bytes;
+}/*instrumentAllocation(double)*/
@@ -0,0 +1,454 @@
+/*******************************************************************************
+** JointCounts.c
+** Part of the mutual information toolbox
+**
+** Contains a mergeable integer histogram over up to three variables X, Y & Z,
+** which can be built from chunks of data, merged across chunks or processes,
+** serialised into a flat byte buffer, and used to calculate H(X), H(X,Y),
+** H(X|Y), I(X;Y) and I(X;Y|Z).
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include <limits.h>
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/JointCounts.h"
+#include "CountSums.h"
+
+#define JOINT_COUNTS_MAGIC 0x434A494DU
+#define JOINT_COUNTS_VERSION 1U
+#define JOINT_COUNTS_HEADER_WORDS 6
+
+static void writeWord(unsigned char *buffer, uint value) {
+  buffer[0] = (unsigned char) (value & 0xFF);
+  buffer[1] = (unsigned char) ((value >> 8) & 0xFF);
+  buffer[2] = (unsigned char) ((value >> 16) & 0xFF);
+  buffer[3] = (unsigned char) ((value >> 24) & 0xFF);
+}
+
+static uint readWord(unsigned char *buffer) {
+  return ((uint) buffer[0]) | ((uint) buffer[1] << 8) | ((uint) buffer[2] << 16) | ((uint) buffer[3] << 24);
+}
+
+/*******************************************************************************
+** Returns the number of joint states, or -1 if it does not fit in an int.
+*******************************************************************************/
+static int jointStates(int numFirstStates, int numSecondStates, int numConditionStates) {
+  size_t product = numFirstStates;
+
+  if ((size_t) numSecondStates > INT_MAX / product) {
+    return -1;
+  }
+  product *= numSecondStates;
+  if ((size_t) numConditionStates > INT_MAX / product) {
+    return -1;
+  }
+  product *= numConditionStates;
+
+  return (int) product;
+}/*jointStates(int,int,int)*/
+
+/*******************************************************************************
+** Grows counts so it has at least the supplied number of states in each
+** variable, and at least one, copying the existing counts into the new
+** layout. Counts with no table (jointCounts == NULL) have no states. Returns
+** -1 and leaves counts unchanged if the grown table would have more than
+** INT_MAX states.
+*******************************************************************************/
+static int growJointCounts(JointCounts *counts, int numFirstStates, int numSecondStates, int numConditionStates) {
+  uint *newCounts;
+  size_t oldIndex, newIndex;
+  int oldFirstStates = 0, oldSecondStates = 0, oldConditionStates = 0;
+  int numJointStates, x, y, z;
+
+  if (counts->jointCounts != NULL) {
+    oldFirstStates = counts->numFirstStates;
+    oldSecondStates = counts->numSecondStates;
+    oldConditionStates = counts->numConditionStates;
+  }
+
+  if (numFirstStates < oldFirstStates) {
+    numFirstStates = oldFirstStates;
+  }
+  if (numSecondStates < oldSecondStates) {
+    numSecondStates = oldSecondStates;
+  }
+  if (numConditionStates < oldConditionStates) {
+    numConditionStates = oldConditionStates;
+  }
+  numFirstStates = numFirstStates < 1 ? 1 : numFirstStates;
+  numSecondStates = numSecondStates < 1 ? 1 : numSecondStates;
+  numConditionStates = numConditionStates < 1 ? 1 : numConditionStates;
+
+  if ((numFirstStates == oldFirstStates) && (numSecondStates == oldSecondStates) && (numConditionStates == oldConditionStates)) {
+    return 0;
+  }
+
+  numJointStates = jointStates(numFirstStates,numSecondStates,numConditionStates);
+  if (numJointStates < 0) {
+    return -1;
+  }
+
+  newCounts = (uint *) checkedCalloc(numJointStates, sizeof(uint));
+
+  oldIndex = 0;
+  for (z = 0; z < oldConditionStates; z++) {
+    for (y = 0; y < oldSecondStates; y++) {
+      newIndex = (size_t) numFirstStates * (y + (size_t) numSecondStates * z);
+      for (x = 0; x < oldFirstStates; x++) {
+        newCounts[newIndex + x] = counts->jointCounts[oldIndex];
+        oldIndex++;
+      }
+    }
+  }
+
+  FREE_FUNC(counts->jointCounts);
+  counts->jointCounts = newCounts;
+  counts->numFirstStates = numFirstStates;
+  counts->numSecondStates = numSecondStates;
+  counts->numConditionStates = numConditionStates;
+  counts->numJointStates = numJointStates;
+
+  return 0;
+}/*growJointCounts(JointCounts *,int,int,int)*/
+
+JointCounts calculateJointCounts(uint *firstVector, uint *secondVector, uint *conditionVector, int vectorLength) {
+  JointCounts counts;
+
+  counts.jointCounts = (uint *) checkedCalloc(1,sizeof(uint));
+  counts.numJointStates = 1;
+  counts.numFirstStates = 1;
+  counts.numSecondStates = 1;
+  counts.numConditionStates = 1;
+  counts.numSamples = 0;
+
+  if (accumulateJointCounts(&counts,firstVector,secondVector,conditionVector,vectorLength) != 0) {
+    FREE_FUNC(counts.jointCounts);
+    counts.jointCounts = NULL;
+    counts.numJointStates = 0;
+    counts.numFirstStates = 0;
+    counts.numSecondStates = 0;
+    counts.numConditionStates = 0;
+  }
+
+  return counts;
+}/*calculateJointCounts(uint *,uint *,uint *,int)*/
+
+int accumulateJointCounts(JointCounts *counts, uint *firstVector, uint *secondVector, uint *conditionVector, int vectorLength) {
+  int numFirstStates = firstVector == NULL ? 1 : maxState(firstVector,vectorLength);
+  int numSecondStates = secondVector == NULL ? 1 : maxState(secondVector,vectorLength);
+  int numConditionStates = conditionVector == NULL ? 1 : maxState(conditionVector,vectorLength);
+  size_t firstStride, secondStride, index;
+  int i;
+
+  if ((vectorLength > 0) && (counts->numSamples > UINT_MAX - (uint) vectorLength)) {
+    return -1;
+  }
+  if (growJointCounts(counts,numFirstStates,numSecondStates,numConditionStates) != 0) {
+    return -1;
+  }
+
+  firstStride = counts->numFirstStates;
+  secondStride = firstStride * counts->numSecondStates;
+
+  for (i = 0; i < vectorLength; i++) {
+    index = 0;
+    if (firstVector != NULL) {
+      index += firstVector[i];
+    }
+    if (secondVector != NULL) {
+      index += secondVector[i] * firstStride;
+    }
+    if (conditionVector != NULL) {
+      index += conditionVector[i] * secondStride;
+    }
+    counts->jointCounts[index] += 1;
+  }
+
+  counts->numSamples += vectorLength;
+
+  return 0;
+}/*accumulateJointCounts(JointCounts *,uint *,uint *,uint *,int)*/
+
+int mergeJointCounts(JointCounts *destination, JointCounts source) {
+  size_t sourceIndex, destIndex;
+  int x, y, z;
+
+  if (source.jointCounts == NULL) {
+    return 0;
+  }
+  if (destination->numSamples > UINT_MAX - source.numSamples) {
+    return -1;
+  }
+  if (growJointCounts(destination,source.numFirstStates,source.numSecondStates,source.numConditionStates) != 0) {
+    return -1;
+  }
+
+  sourceIndex = 0;
+  for (z = 0; z < source.numConditionStates; z++) {
+    for (y = 0; y < source.numSecondStates; y++) {
+      destIndex = (size_t) destination->numFirstStates * (y + (size_t) destination->numSecondStates * z);
+      for (x = 0; x < source.numFirstStates; x++) {
+        destination->jointCounts[destIndex + x] += source.jointCounts[sourceIndex];
+        sourceIndex++;
+      }
+    }
+  }
+
+  destination->numSamples += source.numSamples;
+
+  return 0;
+}/*mergeJointCounts(JointCounts *,JointCounts)*/
+
+size_t serialisedJointCountsSize(JointCounts counts) {
+  return (JOINT_COUNTS_HEADER_WORDS + (size_t) counts.numJointStates) * 4;
+}/*serialisedJointCountsSize(JointCounts)*/
+
+size_t serialiseJointCounts(JointCounts counts, unsigned char *buffer) {
+  int i;
+
+  writeWord(buffer,JOINT_COUNTS_MAGIC);
+  writeWord(buffer+4,JOINT_COUNTS_VERSION);
+  writeWord(buffer+8,counts.numFirstStates);
+  writeWord(buffer+12,counts.numSecondStates);
+  writeWord(buffer+16,counts.numConditionStates);
+  writeWord(buffer+20,counts.numSamples);
+
+  buffer += JOINT_COUNTS_HEADER_WORDS * 4;
+  for (i = 0; i < counts.numJointStates; i++) {
+    writeWord(buffer + 4*i,counts.jointCounts[i]);
+  }
+
+  return serialisedJointCountsSize(counts);
+}/*serialiseJointCounts(JointCounts,unsigned char *)*/
+
+int deserialiseJointCounts(unsigned char *buffer, size_t bufferLength, JointCounts *counts) {
+  uint numFirstStates, numSecondStates, numConditionStates;
+  double numJointStates, cellSum = 0.0;
+  int i;
+
+  if (bufferLength < JOINT_COUNTS_HEADER_WORDS * 4) {
+    return -1;
+  }
+  if ((readWord(buffer) != JOINT_COUNTS_MAGIC) || (readWord(buffer+4) != JOINT_COUNTS_VERSION)) {
+    return -1;
+  }
+
+  numFirstStates = readWord(buffer+8);
+  numSecondStates = readWord(buffer+12);
+  numConditionStates = readWord(buffer+16);
+  numJointStates = ((double) numFirstStates) * numSecondStates * numConditionStates;
+
+  if ((numFirstStates == 0) && (numSecondStates == 0) && (numConditionStates == 0) && (readWord(buffer+20) == 0)) {
+    counts->jointCounts = NULL;
+    counts->numJointStates = 0;
+    counts->numFirstStates = 0;
+    counts->numSecondStates = 0;
+    counts->numConditionStates = 0;
+    counts->numSamples = 0;
+    return 0;
+  }
+  if ((numJointStates < 1) || (numJointStates > INT_MAX) || (bufferLength < (JOINT_COUNTS_HEADER_WORDS + (size_t) numJointStates) * 4)) {
+    return -1;
+  }
+
+  counts->numFirstStates = numFirstStates;
+  counts->numSecondStates = numSecondStates;
+  counts->numConditionStates = numConditionStates;
+  counts->numJointStates = (int) numJointStates;
+  counts->numSamples = readWord(buffer+20);
+  counts->jointCounts = (uint *) checkedCalloc(counts->numJointStates,sizeof(uint));
+
+  buffer += JOINT_COUNTS_HEADER_WORDS * 4;
+  for (i = 0; i < counts->numJointStates; i++) {
+    counts->jointCounts[i] = readWord(buffer + 4*i);
+    cellSum += counts->jointCounts[i];
+  }
+
+  if (cellSum != counts->numSamples) {
+    freeJointCounts(*counts);
+    counts->jointCounts = NULL;
+    return -1;
+  }
+
+  return 0;
+}/*deserialiseJointCounts(unsigned char *,size_t,JointCounts *)*/
+
+/*******************************************************************************
+** Sums out the condition variable, writing the X, Y and XY marginal counts.
+** Any of the output arrays may be NULL.
+*******************************************************************************/
+static void marginaliseCondition(JointCounts counts, double *firstCounts, double *secondCounts, double *jointCounts) {
+  int x, y, z, index;
+  double value;
+
+  index = 0;
+  for (z = 0; z < counts.numConditionStates; z++) {
+    for (y = 0; y < counts.numSecondStates; y++) {
+      for (x = 0; x < counts.numFirstStates; x++) {
+        value = counts.jointCounts[index];
+        if (firstCounts != NULL) {
+          firstCounts[x] += value;
+        }
+        if (secondCounts != NULL) {
+          secondCounts[y] += value;
+        }
+        if (jointCounts != NULL) {
+          jointCounts[x + counts.numFirstStates * y] += value;
+        }
+        index++;
+      }
+    }
+  }
+}/*marginaliseCondition(JointCounts,double *,double *,double *)*/
+
+double countsEntropy(JointCounts counts) {
+  double length = counts.numSamples;
+  double *firstCounts;
+  double entropy;
+
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+
+  firstCounts = (double *) checkedCalloc(counts.numFirstStates,sizeof(double));
+  marginaliseCondition(counts,firstCounts,NULL,NULL);
+
+  entropy = entropyFromSums(length,sumDoubleCountLogCount(firstCounts,counts.numFirstStates));
+
+  FREE_FUNC(firstCounts);
+  firstCounts = NULL;
+
+  return entropy;
+}/*countsEntropy(JointCounts)*/
+
+double countsJointEntropy(JointCounts counts) {
+  double length = counts.numSamples;
+  double *jointCounts;
+  double entropy;
+  int numJointStates = counts.numFirstStates * counts.numSecondStates;
+
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+
+  jointCounts = (double *) checkedCalloc(numJointStates,sizeof(double));
+  marginaliseCondition(counts,NULL,NULL,jointCounts);
+
+  entropy = entropyFromSums(length,sumDoubleCountLogCount(jointCounts,numJointStates));
+
+  FREE_FUNC(jointCounts);
+  jointCounts = NULL;
+
+  return entropy;
+}/*countsJointEntropy(JointCounts)*/
+
+double countsConditionalEntropy(JointCounts counts) {
+  double length = counts.numSamples;
+  double *secondCounts, *jointCounts;
+  double entropy;
+  int numJointStates = counts.numFirstStates * counts.numSecondStates;
+
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+
+  secondCounts = (double *) checkedCalloc(counts.numSecondStates,sizeof(double));
+  jointCounts = (double *) checkedCalloc(numJointStates,sizeof(double));
+  marginaliseCondition(counts,NULL,secondCounts,jointCounts);
+
+  entropy = conditionalEntropyFromSums(length,sumDoubleCountLogCount(jointCounts,numJointStates),
+                                       sumDoubleCountLogCount(secondCounts,counts.numSecondStates));
+
+  FREE_FUNC(secondCounts);
+  FREE_FUNC(jointCounts);
+  secondCounts = NULL;
+  jointCounts = NULL;
+
+  return entropy;
+}/*countsConditionalEntropy(JointCounts)*/
+
+double countsMutualInformation(JointCounts counts) {
+  double length = counts.numSamples;
+  double *firstCounts, *secondCounts, *jointCounts;
+  double mutualInformation;
+  int numJointStates = counts.numFirstStates * counts.numSecondStates;
+
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+
+  firstCounts = (double *) checkedCalloc(counts.numFirstStates,sizeof(double));
+  secondCounts = (double *) checkedCalloc(counts.numSecondStates,sizeof(double));
+  jointCounts = (double *) checkedCalloc(numJointStates,sizeof(double));
+  marginaliseCondition(counts,firstCounts,secondCounts,jointCounts);
+
+  mutualInformation = mutualInformationFromSums(length,sumDoubleCountLogCount(jointCounts,numJointStates),
+                                                sumDoubleCountLogCount(firstCounts,counts.numFirstStates),
+                                                sumDoubleCountLogCount(secondCounts,counts.numSecondStates));
+
+  FREE_FUNC(firstCounts);
+  FREE_FUNC(secondCounts);
+  FREE_FUNC(jointCounts);
+  firstCounts = NULL;
+  secondCounts = NULL;
+  jointCounts = NULL;
+
+  return mutualInformation;
+}/*countsMutualInformation(JointCounts)*/
+
+double countsConditionalMutualInformation(JointCounts counts) {
+  double length = counts.numSamples;
+  double *firstCondCounts, *secondCondCounts, *condCounts;
+  double mutualInformation;
+  double value, jointSum = 0.0;
+  int x, y, z, index;
+
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+
+  firstCondCounts = (double *) checkedCalloc(counts.numFirstStates * counts.numConditionStates,sizeof(double));
+  secondCondCounts = (double *) checkedCalloc(counts.numSecondStates * counts.numConditionStates,sizeof(double));
+  condCounts = (double *) checkedCalloc(counts.numConditionStates,sizeof(double));
+
+  index = 0;
+  for (z = 0; z < counts.numConditionStates; z++) {
+    for (y = 0; y < counts.numSecondStates; y++) {
+      for (x = 0; x < counts.numFirstStates; x++) {
+        value = counts.jointCounts[index];
+        firstCondCounts[x + counts.numFirstStates * z] += value;
+        secondCondCounts[y + counts.numSecondStates * z] += value;
+        condCounts[z] += value;
+        jointSum += countLogCount(value);
+        index++;
+      }
+    }
+  }
+
+  mutualInformation = conditionalMutualInformationFromSums(length,jointSum,
+                          sumDoubleCountLogCount(firstCondCounts,counts.numFirstStates * counts.numConditionStates),
+                          sumDoubleCountLogCount(secondCondCounts,counts.numSecondStates * counts.numConditionStates),
+                          sumDoubleCountLogCount(condCounts,counts.numConditionStates));
+
+  FREE_FUNC(firstCondCounts);
+  FREE_FUNC(secondCondCounts);
+  FREE_FUNC(condCounts);
+  firstCondCounts = NULL;
+  secondCondCounts = NULL;
+  condCounts = NULL;
+
+  return mutualInformation;
+}/*countsConditionalMutualInformation(JointCounts)*/
+
+void freeJointCounts(JointCounts counts) {
+  FREE_FUNC(counts.jointCounts);
+  counts.jointCounts = NULL;
+}
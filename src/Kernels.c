@@ -0,0 +1,414 @@
+/*******************************************************************************
+** Kernels.c
+** Part of the mutual information toolbox
+**
+** Contains the inner loops used by the probability, entropy and mutual
+** information functions. The loops are written so the compiler can
+** vectorise them, and this file is compiled once per instruction set with
+** KERNEL_VARIANT set to the suffix of the function names (see the Makefile).
+** The compile without KERNEL_VARIANT builds the scalar loops and the
+** dispatch code, which picks a variant with cpuid when the library loads.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/Kernels.h"
+
+#ifndef KERNEL_VARIANT
+  #define KERNEL_VARIANT scalar
+  #define KERNEL_DISPATCH
+#endif
+
+#define PASTE_NAME(name,variant) name##_##variant
+#define EXPAND_NAME(name,variant) PASTE_NAME(name,variant)
+#define KERNEL_NAME(name) EXPAND_NAME(name,KERNEL_VARIANT)
+
+#define DECLARE_KERNELS(variant) \
+  int EXPAND_NAME(kernelMaxState,variant)(uint *, int); \
+  void EXPAND_NAME(kernelFloorArray,variant)(double *, int *, int, int *, int *); \
+  void EXPAND_NAME(kernelOffsetArray,variant)(int *, uint *, int, int); \
+  void EXPAND_NAME(kernelJointIndices,variant)(uint *, uint *, int, uint *, int); \
+  void EXPAND_NAME(kernelCountStates,variant)(uint *, int, int *); \
+  void EXPAND_NAME(kernelCountJointStates,variant)(uint *, uint *, int, int, int *, int *, int *); \
+  void EXPAND_NAME(kernelCountsToProbabilities,variant)(int *, double *, int, double); \
+  double EXPAND_NAME(kernelEntropySum,variant)(double *, int); \
+  double EXPAND_NAME(kernelCondEntropySum,variant)(double *, double *, int, int); \
+  double EXPAND_NAME(kernelMISum,variant)(double *, double *, double *, int, int); \
+  double EXPAND_NAME(kernelWeightedEntropySum,variant)(double *, double *, int); \
+  double EXPAND_NAME(kernelWeightedCondEntropySum,variant)(double *, double *, double *, int, int); \
+  double EXPAND_NAME(kernelWeightedMISum,variant)(double *, double *, double *, double *, int, int);
+
+#define KERNEL_TABLE(name,variant) { name, \
+  EXPAND_NAME(kernelMaxState,variant), EXPAND_NAME(kernelFloorArray,variant), \
+  EXPAND_NAME(kernelOffsetArray,variant), EXPAND_NAME(kernelJointIndices,variant), \
+  EXPAND_NAME(kernelCountStates,variant), EXPAND_NAME(kernelCountJointStates,variant), \
+  EXPAND_NAME(kernelCountsToProbabilities,variant), EXPAND_NAME(kernelEntropySum,variant), \
+  EXPAND_NAME(kernelCondEntropySum,variant), EXPAND_NAME(kernelMISum,variant), \
+  EXPAND_NAME(kernelWeightedEntropySum,variant), EXPAND_NAME(kernelWeightedCondEntropySum,variant), \
+  EXPAND_NAME(kernelWeightedMISum,variant) }
+
+DECLARE_KERNELS(KERNEL_VARIANT)
+
+int KERNEL_NAME(kernelMaxState)(uint *vector, int vectorLength) {
+  uint max = 0;
+  int i;
+
+  for (i = 0; i < vectorLength; i++) {
+    max = vector[i] > max ? vector[i] : max;
+  }
+
+  return max + 1;
+}/*kernelMaxState(uint *,int)*/
+
+void KERNEL_NAME(kernelFloorArray)(double *inputVector, int *outputVector, int vectorLength, int *minVal, int *maxVal) {
+  int min = (int) floor(inputVector[0]);
+  int max = min;
+  int currentValue;
+  int i;
+
+  for (i = 0; i < vectorLength; i++) {
+    currentValue = (int) floor(inputVector[i]);
+    outputVector[i] = currentValue;
+    min = currentValue < min ? currentValue : min;
+    max = currentValue > max ? currentValue : max;
+  }
+
+  *minVal = min;
+  *maxVal = max;
+}/*kernelFloorArray(double *,int *,int,int *,int *)*/
+
+void KERNEL_NAME(kernelOffsetArray)(int *inputVector, uint *outputVector, int vectorLength, int offset) {
+  int i;
+
+  for (i = 0; i < vectorLength; i++) {
+    outputVector[i] = inputVector[i] - offset;
+  }
+}/*kernelOffsetArray(int *,uint *,int,int)*/
+
+void KERNEL_NAME(kernelJointIndices)(uint *firstVector, uint *secondVector, int numFirstStates, uint *outputVector, int vectorLength) {
+  uint numStates = numFirstStates;
+  int i;
+
+  for (i = 0; i < vectorLength; i++) {
+    outputVector[i] = firstVector[i] + secondVector[i] * numStates;
+  }
+}/*kernelJointIndices(uint *,uint *,int,uint *,int)*/
+
+void KERNEL_NAME(kernelCountStates)(uint *vector, int vectorLength, int *counts) {
+  int i;
+
+  for (i = 0; i < vectorLength; i++) {
+    counts[vector[i]] += 1;
+  }
+}/*kernelCountStates(uint *,int,int *)*/
+
+void KERNEL_NAME(kernelCountJointStates)(uint *firstVector, uint *secondVector, int numFirstStates, int vectorLength,
+                                         int *firstCounts, int *secondCounts, int *jointCounts) {
+  int i;
+
+  for (i = 0; i < vectorLength; i++) {
+    firstCounts[firstVector[i]] += 1;
+    secondCounts[secondVector[i]] += 1;
+    jointCounts[secondVector[i] * numFirstStates + firstVector[i]] += 1;
+  }
+}/*kernelCountJointStates(uint *,uint *,int,int,int *,int *,int *)*/
+
+void KERNEL_NAME(kernelCountsToProbabilities)(int *counts, double *probabilities, int numStates, double length) {
+  int i;
+
+  for (i = 0; i < numStates; i++) {
+    probabilities[i] = counts[i] / length;
+  }
+}/*kernelCountsToProbabilities(int *,double *,int,double)*/
+
+/*******************************************************************************
+** The log reductions work on blocks of LOG_BLOCK states. The occupied
+** states of a block are packed into a buffer without branching (every
+** state is written, but the count only advances for the occupied ones),
+** so sparse histograms only pay for the logs they need. The packed ratios
+** are then passed through logVector, multiplied by the probabilities and
+** summed, and each of those loops vectorises.
+*******************************************************************************/
+#define LOG_BLOCK 256
+
+/* Coefficients from fdlibm's e_log.c */
+#define LN2_HI 6.93147180369123816490e-01
+#define LN2_LO 1.90821492927058770002e-10
+#define LG1 6.666666666666735130e-01
+#define LG2 3.999999999940941908e-01
+#define LG3 2.857142874366239149e-01
+#define LG4 2.222219843214978396e-01
+#define LG5 1.818357216161805012e-01
+#define LG6 1.531383769920937332e-01
+#define LG7 1.479819860511658591e-01
+
+/*******************************************************************************
+** Writes the natural log of each element of input to output, with an error
+** below 1 ulp. This is fdlibm's log without the branches for special values,
+** so every input must be a positive normal number. The input is split into
+** 2^k * m with m in [sqrt(2)/2, sqrt(2)) using integer operations on the
+** bits, so both the split and the polynomial vectorise.
+*******************************************************************************/
+static void logVector(double *input, double *output, int length) {
+  const uint64_t offset = (uint64_t) 0x00095f62 << 32;
+  const uint64_t exponentBits = (uint64_t) 0x43300000 << 32;
+  double x, f, s, z, w, r, halfSquare, k;
+  uint64_t bits, exponent;
+  int i;
+
+  for (i = 0; i < length; i++) {
+    x = input[i];
+    memcpy(&bits,&x,sizeof(double));
+    /* the exponent of x * sqrt(2), so the mantissa of x is scaled into [sqrt(2)/2, sqrt(2)) */
+    exponent = (bits + offset) >> 52;
+    bits -= (exponent - 1023) << 52;
+    memcpy(&f,&bits,sizeof(double));
+    f -= 1.0;
+    /* converts exponent - 1023 to a double exactly, via 2^52 + exponent */
+    bits = exponentBits | exponent;
+    memcpy(&k,&bits,sizeof(double));
+    k -= 4503599627371519.0;
+
+    s = f / (2.0 + f);
+    z = s * s;
+    w = z * z;
+    r = z * (LG1 + w * (LG3 + w * (LG5 + w * LG7))) + w * (LG2 + w * (LG4 + w * LG6));
+    halfSquare = 0.5 * f * f;
+    output[i] = k * LN2_HI - ((halfSquare - (s * (halfSquare + r) + k * LN2_LO)) - f);
+  }
+}/*logVector(double *,double *,int)*/
+
+static double sumVector(double *vector, int length) {
+  double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+  int i;
+
+  for (i = 0; i + 3 < length; i += 4) {
+    sum0 += vector[i];
+    sum1 += vector[i+1];
+    sum2 += vector[i+2];
+    sum3 += vector[i+3];
+  }
+  for (; i < length; i++) {
+    sum0 += vector[i];
+  }
+
+  return (sum0 + sum1) + (sum2 + sum3);
+}/*sumVector(double *,int)*/
+
+/*******************************************************************************
+** Returns \sum_i weights[i] * numerators[i] * \log (numerators[i] / denominator)
+** over the states where numerators[i] > 0. If weights is NULL every weight
+** is 1, and if denominators is not NULL the ratio is
+** numerators[i] / denominators[i] / denominator, and states with
+** denominators[i] == 0 are skipped.
+*******************************************************************************/
+static double sumLogRatios(double *numerators, double *weights, double *denominators, double denominator, int length) {
+  int occupied[LOG_BLOCK];
+  double ratios[LOG_BLOCK];
+  double sum = 0.0;
+  int blockStart, blockLength, count, i;
+
+  for (blockStart = 0; blockStart < length; blockStart += LOG_BLOCK) {
+    double *numerator = numerators + blockStart;
+    blockLength = length - blockStart < LOG_BLOCK ? length - blockStart : LOG_BLOCK;
+    count = 0;
+
+    if (denominators == NULL) {
+      for (i = 0; i < blockLength; i++) {
+        occupied[count] = i;
+        count += numerator[i] > 0;
+      }
+      for (i = 0; i < count; i++) {
+        ratios[i] = numerator[occupied[i]] / denominator;
+      }
+    } else {
+      double *rowDenominator = denominators + blockStart;
+      for (i = 0; i < blockLength; i++) {
+        occupied[count] = i;
+        count += (numerator[i] > 0) & (rowDenominator[i] > 0);
+      }
+      for (i = 0; i < count; i++) {
+        ratios[i] = numerator[occupied[i]] / rowDenominator[occupied[i]] / denominator;
+      }
+    }
+
+    logVector(ratios,ratios,count);
+
+    if (weights == NULL) {
+      for (i = 0; i < count; i++) {
+        ratios[i] *= numerator[occupied[i]];
+      }
+    } else {
+      double *weight = weights + blockStart;
+      for (i = 0; i < count; i++) {
+        ratios[i] *= weight[occupied[i]] * numerator[occupied[i]];
+      }
+    }
+    sum += sumVector(ratios,count);
+  }
+
+  return sum;
+}/*sumLogRatios(double *,double *,double *,double,int)*/
+
+double KERNEL_NAME(kernelEntropySum)(double *probabilities, int numStates) {
+  return -sumLogRatios(probabilities,NULL,NULL,1.0,numStates);
+}/*kernelEntropySum(double *,int)*/
+
+/*******************************************************************************
+** The joint reductions walk the joint histogram one row (one state of the
+** second variable) at a time, so the inner loops run over contiguous
+** memory without the modulo and division of the flat index.
+*******************************************************************************/
+double KERNEL_NAME(kernelCondEntropySum)(double *jointProbabilities, double *secondProbabilities, int numFirstStates, int numJointStates) {
+  double condEntropy = 0.0;
+  int numSecondStates = numJointStates / numFirstStates;
+  int j;
+
+  for (j = 0; j < numSecondStates; j++) {
+    if (secondProbabilities[j] > 0) {
+      condEntropy -= sumLogRatios(jointProbabilities + j*numFirstStates,NULL,NULL,secondProbabilities[j],numFirstStates);
+    }
+  }
+
+  return condEntropy;
+}/*kernelCondEntropySum(double *,double *,int,int)*/
+
+double KERNEL_NAME(kernelMISum)(double *jointProbabilities, double *firstProbabilities, double *secondProbabilities,
+                                int numFirstStates, int numJointStates) {
+  double mutualInformation = 0.0;
+  int numSecondStates = numJointStates / numFirstStates;
+  int j;
+
+  for (j = 0; j < numSecondStates; j++) {
+    if (secondProbabilities[j] > 0) {
+      mutualInformation += sumLogRatios(jointProbabilities + j*numFirstStates,NULL,firstProbabilities,
+                                        secondProbabilities[j],numFirstStates);
+    }
+  }
+
+  return mutualInformation;
+}/*kernelMISum(double *,double *,double *,int,int)*/
+
+double KERNEL_NAME(kernelWeightedEntropySum)(double *probabilities, double *weights, int numStates) {
+  return -sumLogRatios(probabilities,weights,NULL,1.0,numStates);
+}/*kernelWeightedEntropySum(double *,double *,int)*/
+
+double KERNEL_NAME(kernelWeightedCondEntropySum)(double *jointProbabilities, double *jointWeights, double *secondProbabilities,
+                                                 int numFirstStates, int numJointStates) {
+  double condEntropy = 0.0;
+  int numSecondStates = numJointStates / numFirstStates;
+  int j;
+
+  for (j = 0; j < numSecondStates; j++) {
+    if (secondProbabilities[j] > 0) {
+      condEntropy -= sumLogRatios(jointProbabilities + j*numFirstStates,jointWeights + j*numFirstStates,NULL,
+                                  secondProbabilities[j],numFirstStates);
+    }
+  }
+
+  return condEntropy;
+}/*kernelWeightedCondEntropySum(double *,double *,double *,int,int)*/
+
+double KERNEL_NAME(kernelWeightedMISum)(double *jointProbabilities, double *jointWeights, double *firstProbabilities,
+                                        double *secondProbabilities, int numFirstStates, int numJointStates) {
+  double mutualInformation = 0.0;
+  int numSecondStates = numJointStates / numFirstStates;
+  int j;
+
+  for (j = 0; j < numSecondStates; j++) {
+    if (secondProbabilities[j] > 0) {
+      mutualInformation += sumLogRatios(jointProbabilities + j*numFirstStates,jointWeights + j*numFirstStates,
+                                        firstProbabilities,secondProbabilities[j],numFirstStates);
+    }
+  }
+
+  return mutualInformation;
+}/*kernelWeightedMISum(double *,double *,double *,double *,int,int)*/
+
+#ifdef KERNEL_DISPATCH
+
+static const KernelTable scalarKernels = KERNEL_TABLE("scalar",scalar);
+
+const KernelTable *activeKernels = &scalarKernels;
+
+#ifdef MITOOLBOX_MULTI_ISA
+
+DECLARE_KERNELS(sse42)
+DECLARE_KERNELS(avx2)
+DECLARE_KERNELS(avx512)
+
+static const KernelTable sse42Kernels = KERNEL_TABLE("sse4.2",sse42);
+static const KernelTable avx2Kernels = KERNEL_TABLE("avx2",avx2);
+static const KernelTable avx512Kernels = KERNEL_TABLE("avx512f",avx512);
+
+/* In order of preference */
+static const KernelTable *kernelTables[] = {&avx512Kernels, &avx2Kernels, &sse42Kernels, &scalarKernels};
+#define NUM_KERNEL_TABLES 4
+
+static int cpuSupports(const KernelTable *table) {
+  if (table == &avx512Kernels) {
+    return __builtin_cpu_supports("avx512f");
+  } else if (table == &avx2Kernels) {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  } else if (table == &sse42Kernels) {
+    return __builtin_cpu_supports("sse4.2");
+  }
+  return 1;
+}/*cpuSupports(const KernelTable *)*/
+
+int setKernelVariant(const char *variantName) {
+  int i;
+
+  for (i = 0; i < NUM_KERNEL_TABLES; i++) {
+    if ((strcmp(variantName,kernelTables[i]->name) == 0) && cpuSupports(kernelTables[i])) {
+      activeKernels = kernelTables[i];
+      return 0;
+    }
+  }
+
+  return -1;
+}/*setKernelVariant(const char *)*/
+
+/*******************************************************************************
+** Runs when the library is loaded, choosing the variant named by
+** MITOOLBOX_KERNELS if it is usable, and otherwise the widest supported one.
+*******************************************************************************/
+__attribute__((constructor)) static void selectKernels(void) {
+  const char *variantName = getenv("MITOOLBOX_KERNELS");
+  int i;
+
+  __builtin_cpu_init();
+
+  if ((variantName != NULL) && (setKernelVariant(variantName) == 0)) {
+    return;
+  }
+  for (i = 0; i < NUM_KERNEL_TABLES; i++) {
+    if (cpuSupports(kernelTables[i])) {
+      activeKernels = kernelTables[i];
+      return;
+    }
+  }
+}/*selectKernels()*/
+
+#else
+
+int setKernelVariant(const char *variantName) {
+  return strcmp(variantName,scalarKernels.name) == 0 ? 0 : -1;
+}/*setKernelVariant(const char *)*/
+
+#endif
+
+const char *kernelVariant(void) {
+  return activeKernels->name;
+}/*kernelVariant()*/
+
+#endif
@@ -0,0 +1,304 @@
+/*******************************************************************************
+** MultiInformation.c
+** Part of the mutual information toolbox
+**
+** Contains functions to calculate the multi-information (total
+** correlation), the interaction information, and the sums of the entropies
+** of every subset of a set of variables. The N-way histogram of the
+** variables is counted once, and the histogram of each subset is found by
+** summing out axes of a larger histogram, so the data is only read to
+** build the first one.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/Instrumentation.h"
+#include "MIToolbox/MultiInformation.h"
+#include "CountSums.h"
+
+/* Histograms with more cells than this (and DENSE_CELLS_PER_SAMPLE per
+** sample) store only their occupied states */
+#define MIN_DENSE_CELLS 65536.0
+#define DENSE_CELLS_PER_SAMPLE 2.0
+
+/*******************************************************************************
+** The occupied joint states, with the values of state s in
+** states[s + numStates*k] for k = 0...numVariables-1.
+*******************************************************************************/
+typedef struct nwState
+{
+  uint *states;
+  int *counts;
+  int numStates;
+  int numVariables;
+} NwayCounts;
+
+/* the entropy in nats of a histogram over length samples */
+static double histogramEntropy(int *counts, int numStates, double length) {
+  return log(length) - sumCountLogCount(counts,numStates) / length;
+}/*histogramEntropy(int *,int,double)*/
+
+/*******************************************************************************
+** Merges the rows of the matrix into compact joint states, and keeps the
+** first row with each state along with the state's count. The matrix may
+** itself be a set of occupied states, in which case each row is weighted
+** by rowCounts, otherwise rowCounts is NULL.
+*******************************************************************************/
+static NwayCounts mergeStates(uint *matrix, int *rowCounts, int numRows, int numVariables) {
+  NwayCounts merged;
+  uint *codes = (uint *) checkedCalloc(numRows > 0 ? numRows : 1,sizeof(uint));
+  int i, k;
+
+  merged.numVariables = numVariables;
+  merged.numStates = compactMergeMultipleArrays(matrix,codes,numVariables,numRows);
+  merged.counts = (int *) checkedCalloc(merged.numStates > 0 ? merged.numStates : 1,sizeof(int));
+  merged.states = (uint *) checkedCalloc((size_t) (merged.numStates > 0 ? merged.numStates : 1) * numVariables,sizeof(uint));
+
+  for (i = 0; i < numRows; i++) {
+    if (merged.counts[codes[i]] == 0) {
+      for (k = 0; k < numVariables; k++) {
+        merged.states[codes[i] + (size_t) merged.numStates * k] = matrix[i + (size_t) numRows * k];
+      }
+    }
+    merged.counts[codes[i]] += rowCounts == NULL ? 1 : rowCounts[i];
+  }
+
+  FREE_FUNC(codes);
+  codes = NULL;
+
+  return merged;
+}/*mergeStates(uint *,int *,int,int)*/
+
+static void freeNwayCounts(NwayCounts counts) {
+  FREE_FUNC(counts.states);
+  FREE_FUNC(counts.counts);
+}/*freeNwayCounts(NwayCounts)*/
+
+/*******************************************************************************
+** The subsets are visited depth first, removing axes in increasing order so
+** each subset is reached once. entropySums[k] accumulates the entropies of
+** the subsets with k variables. Removing the last variable gives the empty
+** set, whose entropy is zero, so it is not visited.
+**
+** A dense histogram over the axes in S has the state of axis p at stride
+** strides[p] = arities[0] * ... * arities[p-1].
+*******************************************************************************/
+static void denseSubsetEntropies(int *table, int *arities, int *axes, int numAxes, int nextAxis,
+                                 double length, double *entropySums) {
+  int *childTable, *childArities, *childAxes;
+  int numCells = 1, stride, arity, block, p, q, j, r;
+
+  for (p = 0; p < numAxes; p++) {
+    numCells *= arities[p];
+  }
+  entropySums[numAxes] += histogramEntropy(table,numCells,length);
+  if (numAxes == 1) {
+    return;
+  }
+
+  childArities = (int *) checkedCalloc(numAxes - 1,sizeof(int));
+  childAxes = (int *) checkedCalloc(numAxes - 1,sizeof(int));
+  stride = 1;
+  for (p = 0; p < numAxes; stride *= arities[p], p++) {
+    if (axes[p] < nextAxis) {
+      continue;
+    }
+    arity = arities[p];
+    childTable = (int *) checkedCalloc(numCells / arity,sizeof(int));
+    for (block = 0; block < numCells; block += stride * arity) {
+      for (j = 0; j < arity; j++) {
+        for (r = 0; r < stride; r++) {
+          childTable[block / arity + r] += table[block + j * stride + r];
+        }
+      }
+    }
+    for (q = 0; q < numAxes - 1; q++) {
+      childArities[q] = arities[q < p ? q : q + 1];
+      childAxes[q] = axes[q < p ? q : q + 1];
+    }
+    denseSubsetEntropies(childTable,childArities,childAxes,numAxes - 1,axes[p] + 1,length,entropySums);
+    FREE_FUNC(childTable);
+  }
+
+  FREE_FUNC(childArities);
+  FREE_FUNC(childAxes);
+  childTable = NULL;
+  childArities = NULL;
+  childAxes = NULL;
+}/*denseSubsetEntropies(int *,int *,int *,int,int,double,double *)*/
+
+/*******************************************************************************
+** The same walk over the occupied states, where removing an axis merges the
+** states which only differed in it.
+*******************************************************************************/
+static void sparseSubsetEntropies(NwayCounts counts, int *axes, int nextAxis, double length, double *entropySums) {
+  NwayCounts child;
+  uint *childMatrix;
+  int *childAxes;
+  int numAxes = counts.numVariables;
+  int p, q;
+
+  entropySums[numAxes] += histogramEntropy(counts.counts,counts.numStates,length);
+  if (numAxes == 1) {
+    return;
+  }
+
+  childMatrix = (uint *) checkedCalloc((size_t) counts.numStates * (numAxes - 1),sizeof(uint));
+  childAxes = (int *) checkedCalloc(numAxes - 1,sizeof(int));
+  for (p = 0; p < numAxes; p++) {
+    if (axes[p] < nextAxis) {
+      continue;
+    }
+    for (q = 0; q < numAxes - 1; q++) {
+      memcpy(childMatrix + (size_t) counts.numStates * q,counts.states + (size_t) counts.numStates * (q < p ? q : q + 1),
+             counts.numStates * sizeof(uint));
+      childAxes[q] = axes[q < p ? q : q + 1];
+    }
+    child = mergeStates(childMatrix,counts.counts,counts.numStates,numAxes - 1);
+    sparseSubsetEntropies(child,childAxes,axes[p] + 1,length,entropySums);
+    freeNwayCounts(child);
+  }
+
+  FREE_FUNC(childMatrix);
+  FREE_FUNC(childAxes);
+  childMatrix = NULL;
+  childAxes = NULL;
+}/*sparseSubsetEntropies(NwayCounts,int *,int,double,double *)*/
+
+/*******************************************************************************
+** Writes the sums of the subset entropies in nats to entropySums[1...N].
+*******************************************************************************/
+static void subsetEntropySums(uint *dataMatrix, int vectorLength, int numVariables, double *entropySums) {
+  NwayCounts counts;
+  int *table, *arities, *axes;
+  double numCells = 1.0;
+  int i, k, index, stride;
+
+  counts = mergeStates(dataMatrix,NULL,vectorLength,numVariables);
+  arities = (int *) checkedCalloc(numVariables,sizeof(int));
+  axes = (int *) checkedCalloc(numVariables,sizeof(int));
+  for (k = 0; k < numVariables; k++) {
+    axes[k] = k;
+    arities[k] = maxState(counts.states + (size_t) counts.numStates * k,counts.numStates);
+    numCells *= arities[k];
+  }
+  INSTRUMENT_CELLS(numCells);
+
+  if ((numCells <= MIN_DENSE_CELLS) || (numCells <= DENSE_CELLS_PER_SAMPLE * vectorLength)) {
+    table = (int *) checkedCalloc((size_t) numCells,sizeof(int));
+    for (i = 0; i < counts.numStates; i++) {
+      index = 0;
+      stride = 1;
+      for (k = 0; k < numVariables; k++) {
+        index += counts.states[i + (size_t) counts.numStates * k] * stride;
+        stride *= arities[k];
+      }
+      table[index] = counts.counts[i];
+    }
+    denseSubsetEntropies(table,arities,axes,numVariables,0,vectorLength,entropySums);
+    FREE_FUNC(table);
+    table = NULL;
+  } else {
+    sparseSubsetEntropies(counts,axes,0,vectorLength,entropySums);
+  }
+
+  freeNwayCounts(counts);
+  FREE_FUNC(arities);
+  FREE_FUNC(axes);
+  arities = NULL;
+  axes = NULL;
+}/*subsetEntropySums(uint *,int,int,double *)*/
+
+double calcMultiInformation(uint *dataMatrix, int vectorLength, int numVariables) {
+  NwayCounts counts;
+  double length = vectorLength;
+  double multiInformation;
+  int *marginalCounts;
+  int numMarginalStates, i, k;
+
+  if ((vectorLength < 1) || (numVariables < 1)) {
+    return 0.0;
+  }
+
+  INSTRUMENT_ENTER("calcMultiInformation",vectorLength);
+  counts = mergeStates(dataMatrix,NULL,vectorLength,numVariables);
+
+  /* each marginal is summed over the occupied joint states */
+  multiInformation = -histogramEntropy(counts.counts,counts.numStates,length);
+  for (k = 0; k < numVariables; k++) {
+    numMarginalStates = maxState(counts.states + (size_t) counts.numStates * k,counts.numStates);
+    marginalCounts = (int *) checkedCalloc(numMarginalStates,sizeof(int));
+    for (i = 0; i < counts.numStates; i++) {
+      marginalCounts[counts.states[i + (size_t) counts.numStates * k]] += counts.counts[i];
+    }
+    multiInformation += histogramEntropy(marginalCounts,numMarginalStates,length);
+    FREE_FUNC(marginalCounts);
+  }
+  multiInformation /= log(LOG_BASE);
+
+  freeNwayCounts(counts);
+  marginalCounts = NULL;
+  INSTRUMENT_EXIT();
+
+  return multiInformation;
+}/*calcMultiInformation(uint *,int,int)*/
+
+double calcInteractionInformation(uint *dataMatrix, int vectorLength, int numVariables) {
+  double *entropySums;
+  double interactionInformation = 0.0;
+  int k;
+
+  if ((vectorLength < 1) || (numVariables < 1)) {
+    return 0.0;
+  }
+
+  INSTRUMENT_ENTER("calcInteractionInformation",vectorLength);
+  entropySums = (double *) checkedCalloc(numVariables + 1,sizeof(double));
+  subsetEntropySums(dataMatrix,vectorLength,numVariables,entropySums);
+
+  for (k = 1; k <= numVariables; k++) {
+    interactionInformation += (k % 2 == 1) ? entropySums[k] : -entropySums[k];
+  }
+  interactionInformation /= log(LOG_BASE);
+
+  FREE_FUNC(entropySums);
+  entropySums = NULL;
+  INSTRUMENT_EXIT();
+
+  return interactionInformation;
+}/*calcInteractionInformation(uint *,int,int)*/
+
+void calcSubsetEntropySums(uint *dataMatrix, int vectorLength, int numVariables, double *outputVector) {
+  double *entropySums;
+  int k;
+
+  if (numVariables < 1) {
+    return;
+  }
+  if (vectorLength < 1) {
+    for (k = 0; k < numVariables; k++) {
+      outputVector[k] = 0.0;
+    }
+    return;
+  }
+
+  INSTRUMENT_ENTER("calcSubsetEntropySums",vectorLength);
+  entropySums = (double *) checkedCalloc(numVariables + 1,sizeof(double));
+  subsetEntropySums(dataMatrix,vectorLength,numVariables,entropySums);
+
+  for (k = 1; k <= numVariables; k++) {
+    outputVector[k-1] = entropySums[k] / log(LOG_BASE);
+  }
+
+  FREE_FUNC(entropySums);
+  entropySums = NULL;
+  INSTRUMENT_EXIT();
+}/*calcSubsetEntropySums(uint *,int,int,double *)*/
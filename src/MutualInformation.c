@@ -22,26 +22,19 @@
 #include "MIToolbox/CalculateProbability.h"
 #include "MIToolbox/Entropy.h"
 #include "MIToolbox/MutualInformation.h"
+#include "MIToolbox/Instrumentation.h"
+#include "MIToolbox/Kernels.h"
 
 double mi(JointProbabilityState state) {
   double mutualInformation = 0.0;
-  int firstIndex,secondIndex;
-  int i;
     
   /*
   ** I(X;Y) = \sum_x \sum_y p(x,y) * \log (p(x,y)/p(x)p(y))
   */
-  for (i = 0; i < state.numJointStates; i++) {
-    firstIndex = i % state.numFirstStates;
-    secondIndex = i / state.numFirstStates;
-    
-    if ((state.jointProbabilityVector[i] > 0) && (state.firstProbabilityVector[firstIndex] > 0) && (state.secondProbabilityVector[secondIndex] > 0)) {
-      /*double division is probably more stable than multiplying two small numbers together
-      ** mutualInformation += state.jointProbabilityVector[i] * log(state.jointProbabilityVector[i] / (state.firstProbabilityVector[firstIndex] * state.secondProbabilityVector[secondIndex]));
-      */
-      mutualInformation += state.jointProbabilityVector[i] * log(state.jointProbabilityVector[i] / state.firstProbabilityVector[firstIndex] / state.secondProbabilityVector[secondIndex]);
-    }
-  }
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  mutualInformation = activeKernels->miSum(state.jointProbabilityVector,state.firstProbabilityVector,
+                                           state.secondProbabilityVector,state.numFirstStates,state.numJointStates);
+  INSTRUMENT_PHASE_END();
   
   mutualInformation /= log(LOG_BASE);
  
@@ -49,29 +42,40 @@ double mi(JointProbabilityState state) {
 }/*mi(JointProbabilityState)*/
 
 double calcMutualInformation(uint *dataVector, uint *targetVector, int vectorLength) {
-  JointProbabilityState state = calculateJointProbability(dataVector,targetVector,vectorLength);
-    
-  double mutualInformation = mi(state);
-  
+  JointProbabilityState state;
+  double mutualInformation;
+
+  INSTRUMENT_ENTER("calcMutualInformation",vectorLength);
+  state = calculateJointProbability(dataVector,targetVector,vectorLength);
+  mutualInformation = mi(state);
+
   freeJointProbabilityState(state);
-  
+  INSTRUMENT_EXIT();
+
   return mutualInformation;
 }/*calculateMutualInformation(uint *,uint *,int)*/
 
 double discAndCalcMutualInformation(double *dataVector, double *targetVector, int vectorLength) {
-  JointProbabilityState state = discAndCalcJointProbability(dataVector,targetVector,vectorLength);
-    
-  double mutualInformation = mi(state);
-  
+  JointProbabilityState state;
+  double mutualInformation;
+
+  INSTRUMENT_ENTER("discAndCalcMutualInformation",vectorLength);
+  state = discAndCalcJointProbability(dataVector,targetVector,vectorLength);
+  mutualInformation = mi(state);
+
   freeJointProbabilityState(state);
-  
+  INSTRUMENT_EXIT();
+
   return mutualInformation;
 }/*discAndCalcMutualInformation(double *,double *,int)*/
 
 double calcConditionalMutualInformation(uint *dataVector, uint *targetVector, uint *conditionVector, int vectorLength) {
   double mutualInformation = 0.0;
   double firstCondition, secondCondition;
-  uint *mergedVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
+  uint *mergedVector;
+
+  INSTRUMENT_ENTER("calcConditionalMutualInformation",vectorLength);
+  mergedVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
   
   mergeArrays(targetVector,conditionVector,mergedVector,vectorLength);
   
@@ -84,17 +88,24 @@ double calcConditionalMutualInformation(uint *dataVector, uint *targetVector, ui
   
   FREE_FUNC(mergedVector);
   mergedVector = NULL;
-  
+  INSTRUMENT_EXIT();
+
   return mutualInformation;
 }/*calculateConditionalMutualInformation(double *,double *,double *,int)*/
 
 double discAndCalcConditionalMutualInformation(double *dataVector, double *targetVector, double *conditionVector, int vectorLength) {
   double mutualInformation = 0.0;
   double firstCondition, secondCondition;
-  uint *dataNormVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
-  uint *targetNormVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
-  uint *conditionNormVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
-  uint *mergedVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
+  uint *dataNormVector;
+  uint *targetNormVector;
+  uint *conditionNormVector;
+  uint *mergedVector;
+
+  INSTRUMENT_ENTER("discAndCalcConditionalMutualInformation",vectorLength);
+  dataNormVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
+  targetNormVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
+  conditionNormVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
+  mergedVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
   
   normaliseArray(dataVector,dataNormVector,vectorLength);
   normaliseArray(targetVector,targetNormVector,vectorLength);
@@ -116,6 +127,7 @@ double discAndCalcConditionalMutualInformation(double *dataVector, double *targe
   targetNormVector = NULL;
   conditionNormVector = NULL;
   mergedVector = NULL;
-  
+  INSTRUMENT_EXIT();
+
   return mutualInformation;
 }/*calculateConditionalMutualInformation(double *,double *,double *,int)*/
@@ -0,0 +1,421 @@
+/*******************************************************************************
+** OnlineInformation.c
+** Part of the mutual information toolbox
+**
+** Contains streaming accumulators for the entropy H(X), the mutual
+** information I(X;Y) and the conditional mutual information I(X;Y|Z).
+** Samples can be added and removed in O(1), so the accumulators can track
+** a sliding window. The number of states grows on demand.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include <limits.h>
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/CalculateProbability.h"
+#include "MIToolbox/Entropy.h"
+#include "MIToolbox/MutualInformation.h"
+#include "MIToolbox/Kernels.h"
+#include "MIToolbox/OnlineInformation.h"
+
+/*******************************************************************************
+** Doubles numStates until value is a valid state, clamping at INT_MAX.
+** Returns -1 if value does not fit in an int number of states.
+*******************************************************************************/
+static int grownStates(int numStates, uint value) {
+  if (value >= (uint) INT_MAX) {
+    return -1;
+  }
+  if (numStates < 1) {
+    numStates = 1;
+  }
+  while (value >= (uint) numStates) {
+    numStates = numStates > INT_MAX / 2 ? INT_MAX : numStates * 2;
+  }
+  return numStates;
+}
+
+/* returns 1 if a table of the supplied shape has at most INT_MAX cells */
+static int tableFits(int first, int second, int third) {
+  return (second <= INT_MAX / first) && (third <= INT_MAX / (first * second));
+}
+
+/*******************************************************************************
+** Returns one more than the largest occupied state of a count array, which is
+** the number of states maxState finds in the samples.
+*******************************************************************************/
+static int usedStates(uint *counts, int numStates) {
+  while ((numStates > 1) && (counts[numStates - 1] == 0)) {
+    numStates--;
+  }
+  return numStates;
+}/*usedStates(uint *,int)*/
+
+/*******************************************************************************
+** Builds the probabilities calculateJointProbability would give for the
+** samples in a count table whose rows are stride states apart, writing them
+** into the supplied buffers. The first numFirstStates states of each of the
+** numSecondStates rows are used, and firstCounts and firstProbabilities may
+** be NULL if the first marginal is not needed.
+*******************************************************************************/
+static JointProbabilityState countsToJointState(uint *jointCounts, uint *firstCounts, uint *secondCounts, int stride,
+                                                int numFirstStates, int numSecondStates, double length,
+                                                double *jointProbabilities, double *firstProbabilities,
+                                                double *secondProbabilities) {
+  JointProbabilityState state;
+  int y;
+
+  state.numFirstStates = numFirstStates;
+  state.numSecondStates = numSecondStates;
+  state.numJointStates = numFirstStates * numSecondStates;
+  state.jointProbabilityVector = jointProbabilities;
+  state.firstProbabilityVector = firstProbabilities;
+  state.secondProbabilityVector = secondProbabilities;
+
+  for (y = 0; y < numSecondStates; y++) {
+    activeKernels->countsToProbabilities((int *) jointCounts + (size_t) stride * y,
+                                         state.jointProbabilityVector + (size_t) numFirstStates * y,numFirstStates,length);
+  }
+  if (firstCounts != NULL) {
+    activeKernels->countsToProbabilities((int *) firstCounts,state.firstProbabilityVector,numFirstStates,length);
+  }
+  activeKernels->countsToProbabilities((int *) secondCounts,state.secondProbabilityVector,numSecondStates,length);
+
+  return state;
+}/*countsToJointState(uint *,uint *,uint *,int,int,int,double,double *,double *,double *)*/
+
+/*******************************************************************************
+** Frees a probability buffer so the next value call allocates it at the
+** grown number of states.
+*******************************************************************************/
+static void releaseProbabilities(double **probabilities) {
+  FREE_FUNC(*probabilities);
+  *probabilities = NULL;
+}/*releaseProbabilities(double **)*/
+
+/*******************************************************************************
+** Copies a (first x second x third) count array into a larger array,
+** freeing the old one.
+*******************************************************************************/
+static uint *resizeCounts(uint *counts, int first, int second, int third, int newFirst, int newSecond, int newThird) {
+  uint *newCounts = (uint *) checkedCalloc((size_t) newFirst * newSecond * newThird, sizeof(uint));
+  int x, y, z, oldIndex, newIndex;
+
+  oldIndex = 0;
+  for (z = 0; z < third; z++) {
+    for (y = 0; y < second; y++) {
+      newIndex = newFirst * (y + newSecond * z);
+      for (x = 0; x < first; x++) {
+        newCounts[newIndex + x] = counts[oldIndex];
+        oldIndex++;
+      }
+    }
+  }
+
+  FREE_FUNC(counts);
+  counts = NULL;
+
+  return newCounts;
+}/*resizeCounts(uint *,int,int,int,int,int,int)*/
+
+OnlineEntropy createOnlineEntropy(int numStates) {
+  OnlineEntropy accumulator;
+
+  accumulator.numStates = numStates > 0 ? numStates : 1;
+  accumulator.counts = (uint *) checkedCalloc(accumulator.numStates,sizeof(uint));
+  accumulator.probabilities = NULL;
+  accumulator.numSamples = 0;
+
+  return accumulator;
+}/*createOnlineEntropy(int)*/
+
+int onlineEntropyAdd(OnlineEntropy *accumulator, uint dataValue) {
+  int numStates;
+
+  if (dataValue >= (uint) accumulator->numStates) {
+    numStates = grownStates(accumulator->numStates,dataValue);
+    if (numStates < 0) {
+      return -1;
+    }
+    accumulator->counts = resizeCounts(accumulator->counts,accumulator->numStates,1,1,numStates,1,1);
+    accumulator->numStates = numStates;
+    releaseProbabilities(&accumulator->probabilities);
+  }
+
+  accumulator->counts[dataValue] += 1;
+  accumulator->numSamples++;
+
+  return 0;
+}/*onlineEntropyAdd(OnlineEntropy *,uint)*/
+
+int onlineEntropyRemove(OnlineEntropy *accumulator, uint dataValue) {
+  if ((dataValue >= (uint) accumulator->numStates) || (accumulator->counts[dataValue] == 0)) {
+    return -1;
+  }
+
+  accumulator->counts[dataValue] -= 1;
+  accumulator->numSamples--;
+
+  return 0;
+}/*onlineEntropyRemove(OnlineEntropy *,uint)*/
+
+double onlineEntropyValue(OnlineEntropy *accumulator) {
+  ProbabilityState state;
+
+  if (accumulator->numSamples == 0) {
+    return 0.0;
+  }
+  if (accumulator->probabilities == NULL) {
+    accumulator->probabilities = (double *) checkedCalloc(accumulator->numStates,sizeof(double));
+  }
+
+  state.numStates = usedStates(accumulator->counts,accumulator->numStates);
+  state.probabilityVector = accumulator->probabilities;
+  activeKernels->countsToProbabilities((int *) accumulator->counts,state.probabilityVector,state.numStates,accumulator->numSamples);
+
+  return entropy(state);
+}/*onlineEntropyValue(OnlineEntropy *)*/
+
+void freeOnlineEntropy(OnlineEntropy accumulator) {
+  FREE_FUNC(accumulator.counts);
+  accumulator.counts = NULL;
+  FREE_FUNC(accumulator.probabilities);
+  accumulator.probabilities = NULL;
+}
+
+OnlineMI createOnlineMI(int numFirstStates, int numSecondStates) {
+  OnlineMI accumulator;
+
+  accumulator.numFirstStates = numFirstStates > 0 ? numFirstStates : 1;
+  accumulator.numSecondStates = numSecondStates > 0 ? numSecondStates : 1;
+  if (!tableFits(accumulator.numFirstStates,accumulator.numSecondStates,1)) {
+    accumulator.numFirstStates = 1;
+    accumulator.numSecondStates = 1;
+  }
+  accumulator.jointCounts = (uint *) checkedCalloc((size_t) accumulator.numFirstStates * accumulator.numSecondStates,sizeof(uint));
+  accumulator.firstCounts = (uint *) checkedCalloc(accumulator.numFirstStates,sizeof(uint));
+  accumulator.secondCounts = (uint *) checkedCalloc(accumulator.numSecondStates,sizeof(uint));
+  accumulator.jointProbabilities = NULL;
+  accumulator.firstProbabilities = NULL;
+  accumulator.secondProbabilities = NULL;
+  accumulator.numSamples = 0;
+
+  return accumulator;
+}/*createOnlineMI(int,int)*/
+
+int onlineMIAdd(OnlineMI *accumulator, uint dataValue, uint targetValue) {
+  int numFirstStates, numSecondStates;
+
+  if ((dataValue >= (uint) accumulator->numFirstStates) || (targetValue >= (uint) accumulator->numSecondStates)) {
+    numFirstStates = grownStates(accumulator->numFirstStates,dataValue);
+    numSecondStates = grownStates(accumulator->numSecondStates,targetValue);
+    if ((numFirstStates < 0) || (numSecondStates < 0) || !tableFits(numFirstStates,numSecondStates,1)) {
+      return -1;
+    }
+    accumulator->jointCounts = resizeCounts(accumulator->jointCounts,accumulator->numFirstStates,accumulator->numSecondStates,1,numFirstStates,numSecondStates,1);
+    accumulator->firstCounts = resizeCounts(accumulator->firstCounts,accumulator->numFirstStates,1,1,numFirstStates,1,1);
+    accumulator->secondCounts = resizeCounts(accumulator->secondCounts,accumulator->numSecondStates,1,1,numSecondStates,1,1);
+    accumulator->numFirstStates = numFirstStates;
+    accumulator->numSecondStates = numSecondStates;
+    releaseProbabilities(&accumulator->jointProbabilities);
+    releaseProbabilities(&accumulator->firstProbabilities);
+    releaseProbabilities(&accumulator->secondProbabilities);
+  }
+
+  accumulator->jointCounts[dataValue + accumulator->numFirstStates * targetValue] += 1;
+  accumulator->firstCounts[dataValue] += 1;
+  accumulator->secondCounts[targetValue] += 1;
+  accumulator->numSamples++;
+
+  return 0;
+}/*onlineMIAdd(OnlineMI *,uint,uint)*/
+
+int onlineMIRemove(OnlineMI *accumulator, uint dataValue, uint targetValue) {
+  int jointIndex;
+
+  if ((dataValue >= (uint) accumulator->numFirstStates) || (targetValue >= (uint) accumulator->numSecondStates)) {
+    return -1;
+  }
+
+  jointIndex = dataValue + accumulator->numFirstStates * targetValue;
+  if (accumulator->jointCounts[jointIndex] == 0) {
+    return -1;
+  }
+
+  accumulator->jointCounts[jointIndex] -= 1;
+  accumulator->firstCounts[dataValue] -= 1;
+  accumulator->secondCounts[targetValue] -= 1;
+  accumulator->numSamples--;
+
+  return 0;
+}/*onlineMIRemove(OnlineMI *,uint,uint)*/
+
+double onlineMIValue(OnlineMI *accumulator) {
+  JointProbabilityState state;
+
+  if (accumulator->numSamples == 0) {
+    return 0.0;
+  }
+  if (accumulator->jointProbabilities == NULL) {
+    accumulator->jointProbabilities = (double *) checkedCalloc((size_t) accumulator->numFirstStates * accumulator->numSecondStates,sizeof(double));
+    accumulator->firstProbabilities = (double *) checkedCalloc(accumulator->numFirstStates,sizeof(double));
+    accumulator->secondProbabilities = (double *) checkedCalloc(accumulator->numSecondStates,sizeof(double));
+  }
+
+  state = countsToJointState(accumulator->jointCounts,accumulator->firstCounts,accumulator->secondCounts,
+                             accumulator->numFirstStates,usedStates(accumulator->firstCounts,accumulator->numFirstStates),
+                             usedStates(accumulator->secondCounts,accumulator->numSecondStates),accumulator->numSamples,
+                             accumulator->jointProbabilities,accumulator->firstProbabilities,accumulator->secondProbabilities);
+
+  return mi(state);
+}/*onlineMIValue(OnlineMI *)*/
+
+void freeOnlineMI(OnlineMI accumulator) {
+  FREE_FUNC(accumulator.jointCounts);
+  accumulator.jointCounts = NULL;
+  FREE_FUNC(accumulator.firstCounts);
+  accumulator.firstCounts = NULL;
+  FREE_FUNC(accumulator.secondCounts);
+  accumulator.secondCounts = NULL;
+  FREE_FUNC(accumulator.jointProbabilities);
+  accumulator.jointProbabilities = NULL;
+  FREE_FUNC(accumulator.firstProbabilities);
+  accumulator.firstProbabilities = NULL;
+  FREE_FUNC(accumulator.secondProbabilities);
+  accumulator.secondProbabilities = NULL;
+}
+
+OnlineCMI createOnlineCMI(int numFirstStates, int numSecondStates, int numConditionStates) {
+  OnlineCMI accumulator;
+
+  accumulator.numFirstStates = numFirstStates > 0 ? numFirstStates : 1;
+  accumulator.numSecondStates = numSecondStates > 0 ? numSecondStates : 1;
+  accumulator.numConditionStates = numConditionStates > 0 ? numConditionStates : 1;
+  if (!tableFits(accumulator.numFirstStates,accumulator.numSecondStates,accumulator.numConditionStates)) {
+    accumulator.numFirstStates = 1;
+    accumulator.numSecondStates = 1;
+    accumulator.numConditionStates = 1;
+  }
+  accumulator.jointCounts = (uint *) checkedCalloc((size_t) accumulator.numFirstStates * accumulator.numSecondStates * accumulator.numConditionStates,sizeof(uint));
+  accumulator.firstCondCounts = (uint *) checkedCalloc((size_t) accumulator.numFirstStates * accumulator.numConditionStates,sizeof(uint));
+  accumulator.secondCondCounts = (uint *) checkedCalloc((size_t) accumulator.numSecondStates * accumulator.numConditionStates,sizeof(uint));
+  accumulator.condCounts = (uint *) checkedCalloc(accumulator.numConditionStates,sizeof(uint));
+  accumulator.jointProbabilities = NULL;
+  accumulator.secondProbabilities = NULL;
+  accumulator.numSamples = 0;
+
+  return accumulator;
+}/*createOnlineCMI(int,int,int)*/
+
+int onlineCMIAdd(OnlineCMI *accumulator, uint dataValue, uint targetValue, uint conditionValue) {
+  int numFirstStates, numSecondStates, numConditionStates;
+  int jointIndex;
+
+  if ((dataValue >= (uint) accumulator->numFirstStates) || (targetValue >= (uint) accumulator->numSecondStates) || (conditionValue >= (uint) accumulator->numConditionStates)) {
+    numFirstStates = grownStates(accumulator->numFirstStates,dataValue);
+    numSecondStates = grownStates(accumulator->numSecondStates,targetValue);
+    numConditionStates = grownStates(accumulator->numConditionStates,conditionValue);
+    if ((numFirstStates < 0) || (numSecondStates < 0) || (numConditionStates < 0) ||
+        !tableFits(numFirstStates,numSecondStates,numConditionStates)) {
+      return -1;
+    }
+    accumulator->jointCounts = resizeCounts(accumulator->jointCounts,accumulator->numFirstStates,accumulator->numSecondStates,accumulator->numConditionStates,numFirstStates,numSecondStates,numConditionStates);
+    accumulator->firstCondCounts = resizeCounts(accumulator->firstCondCounts,accumulator->numFirstStates,accumulator->numConditionStates,1,numFirstStates,numConditionStates,1);
+    accumulator->secondCondCounts = resizeCounts(accumulator->secondCondCounts,accumulator->numSecondStates,accumulator->numConditionStates,1,numSecondStates,numConditionStates,1);
+    accumulator->condCounts = resizeCounts(accumulator->condCounts,accumulator->numConditionStates,1,1,numConditionStates,1,1);
+    accumulator->numFirstStates = numFirstStates;
+    accumulator->numSecondStates = numSecondStates;
+    accumulator->numConditionStates = numConditionStates;
+    releaseProbabilities(&accumulator->jointProbabilities);
+    releaseProbabilities(&accumulator->secondProbabilities);
+  }
+
+  jointIndex = dataValue + accumulator->numFirstStates * (targetValue + accumulator->numSecondStates * conditionValue);
+  accumulator->jointCounts[jointIndex] += 1;
+  accumulator->firstCondCounts[dataValue + accumulator->numFirstStates * conditionValue] += 1;
+  accumulator->secondCondCounts[targetValue + accumulator->numSecondStates * conditionValue] += 1;
+  accumulator->condCounts[conditionValue] += 1;
+  accumulator->numSamples++;
+
+  return 0;
+}/*onlineCMIAdd(OnlineCMI *,uint,uint,uint)*/
+
+int onlineCMIRemove(OnlineCMI *accumulator, uint dataValue, uint targetValue, uint conditionValue) {
+  int jointIndex;
+
+  if ((dataValue >= (uint) accumulator->numFirstStates) || (targetValue >= (uint) accumulator->numSecondStates) || (conditionValue >= (uint) accumulator->numConditionStates)) {
+    return -1;
+  }
+
+  jointIndex = dataValue + accumulator->numFirstStates * (targetValue + accumulator->numSecondStates * conditionValue);
+  if (accumulator->jointCounts[jointIndex] == 0) {
+    return -1;
+  }
+
+  accumulator->jointCounts[jointIndex] -= 1;
+  accumulator->firstCondCounts[dataValue + accumulator->numFirstStates * conditionValue] -= 1;
+  accumulator->secondCondCounts[targetValue + accumulator->numSecondStates * conditionValue] -= 1;
+  accumulator->condCounts[conditionValue] -= 1;
+  accumulator->numSamples--;
+
+  return 0;
+}/*onlineCMIRemove(OnlineCMI *,uint,uint,uint)*/
+
+double onlineCMIValue(OnlineCMI *accumulator) {
+  JointProbabilityState state;
+  double firstCondition, secondCondition;
+  int numFirstStates = 1;
+  int numConditionStates, used, z;
+
+  if (accumulator->numSamples == 0) {
+    return 0.0;
+  }
+
+  for (z = 0; z < accumulator->numConditionStates; z++) {
+    used = usedStates(accumulator->firstCondCounts + (size_t) accumulator->numFirstStates * z,accumulator->numFirstStates);
+    if (used > numFirstStates) {
+      numFirstStates = used;
+    }
+  }
+  numConditionStates = usedStates(accumulator->condCounts,accumulator->numConditionStates);
+  if (accumulator->jointProbabilities == NULL) {
+    accumulator->jointProbabilities = (double *) checkedCalloc((size_t) accumulator->numFirstStates * accumulator->numSecondStates * accumulator->numConditionStates,sizeof(double));
+    accumulator->secondProbabilities = (double *) checkedCalloc((size_t) accumulator->numSecondStates * accumulator->numConditionStates,sizeof(double));
+  }
+
+  /* I(X;Y|Z) = H(X|Z) - H(X|YZ), as in calcConditionalMutualInformation, with
+  ** both terms built in the same buffers as the H(X|Z) tables are smaller */
+  state = countsToJointState(accumulator->firstCondCounts,NULL,accumulator->condCounts,accumulator->numFirstStates,
+                             numFirstStates,numConditionStates,accumulator->numSamples,
+                             accumulator->jointProbabilities,NULL,accumulator->secondProbabilities);
+  firstCondition = condEntropy(state);
+
+  state = countsToJointState(accumulator->jointCounts,NULL,accumulator->secondCondCounts,accumulator->numFirstStates,
+                             numFirstStates,accumulator->numSecondStates * numConditionStates,accumulator->numSamples,
+                             accumulator->jointProbabilities,NULL,accumulator->secondProbabilities);
+  secondCondition = condEntropy(state);
+
+  return firstCondition - secondCondition;
+}/*onlineCMIValue(OnlineCMI *)*/
+
+void freeOnlineCMI(OnlineCMI accumulator) {
+  FREE_FUNC(accumulator.jointCounts);
+  accumulator.jointCounts = NULL;
+  FREE_FUNC(accumulator.firstCondCounts);
+  accumulator.firstCondCounts = NULL;
+  FREE_FUNC(accumulator.secondCondCounts);
+  accumulator.secondCondCounts = NULL;
+  FREE_FUNC(accumulator.condCounts);
+  accumulator.condCounts = NULL;
+  FREE_FUNC(accumulator.jointProbabilities);
+  accumulator.jointProbabilities = NULL;
+  FREE_FUNC(accumulator.secondProbabilities);
+  accumulator.secondProbabilities = NULL;
+}
@@ -20,19 +20,168 @@
 #include "MIToolbox/ArrayOperations.h"
 #include "MIToolbox/CalculateProbability.h"
 #include "MIToolbox/Entropy.h"
+#include "MIToolbox/JointCounts.h"
+#include "MIToolbox/RenyiEntropy.h"
+#include "MIToolbox/Instrumentation.h"
+
+/* Largest integer alpha which is calculated by repeated multiplication */
+#define MAX_INTEGER_ALPHA 1024
+
+double alphaPower(double value, double alpha) {
+  double result = 1.0;
+  int exponent;
+
+  if ((alpha != floor(alpha)) || (fabs(alpha) > MAX_INTEGER_ALPHA)) {
+    return pow(value,alpha);
+  }
+
+  /* exponentiation by squaring */
+  exponent = (int) fabs(alpha);
+  while (exponent > 0) {
+    if (exponent & 1) {
+      result *= value;
+    }
+    value *= value;
+    exponent >>= 1;
+  }
+
+  return alpha < 0 ? 1.0 / result : result;
+}/*alphaPower(double,double)*/
+
+/*******************************************************************************
+** H_2(X) = -\log \sum_x p(x)^2 and H_\infty(X) = -\log \max_x p(x), so
+** neither needs a pow per state.
+*******************************************************************************/
+static double specialRenyiEntropy(double *probabilities, int numStates, double alpha) {
+  double sum = 0.0;
+  int i;
+
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  if (alpha == 2.0) {
+    for (i = 0; i < numStates; i++) {
+      sum += probabilities[i] * probabilities[i];
+    }
+  } else {
+    for (i = 0; i < numStates; i++) {
+      if (probabilities[i] > sum) {
+        sum = probabilities[i];
+      }
+    }
+  }
+  INSTRUMENT_PHASE_END();
+
+  return -log(sum) / log(LOG_BASE);
+}/*specialRenyiEntropy(double*,int,double)*/
+
+/*******************************************************************************
+** The same from the integer counts, as H_2(X) = 2\log n - \log \sum_x c(x)^2
+** and H_\infty(X) = \log n - \log \max_x c(x).
+*******************************************************************************/
+static double specialRenyiEntropyFromCounts(JointCounts counts, double alpha) {
+  double length = counts.numSamples;
+  double sum = 0.0;
+  double value;
+  uint maxCount = 0;
+  int i;
+
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  if (alpha == 2.0) {
+    for (i = 0; i < counts.numJointStates; i++) {
+      value = counts.jointCounts[i];
+      sum += value * value;
+    }
+    sum = 2.0 * log(length) - log(sum);
+  } else {
+    for (i = 0; i < counts.numJointStates; i++) {
+      if (counts.jointCounts[i] > maxCount) {
+        maxCount = counts.jointCounts[i];
+      }
+    }
+    sum = log(length) - log(maxCount);
+  }
+  INSTRUMENT_PHASE_END();
+
+  return sum / log(LOG_BASE);
+}/*specialRenyiEntropyFromCounts(JointCounts,double)*/
+
+double calcCollisionEntropy(uint *dataVector, int vectorLength) {
+  JointCounts counts;
+  double h;
+
+  INSTRUMENT_ENTER("calcCollisionEntropy",vectorLength);
+  counts = calculateJointCounts(dataVector,NULL,NULL,vectorLength);
+  h = specialRenyiEntropyFromCounts(counts,2.0);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return h;
+}/*calcCollisionEntropy(uint*,int)*/
+
+double calcJointCollisionEntropy(uint *firstVector, uint *secondVector, int vectorLength) {
+  JointCounts counts;
+  double h;
+
+  INSTRUMENT_ENTER("calcJointCollisionEntropy",vectorLength);
+  counts = calculateJointCounts(firstVector,secondVector,NULL,vectorLength);
+  h = specialRenyiEntropyFromCounts(counts,2.0);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return h;
+}/*calcJointCollisionEntropy(uint*,uint*,int)*/
+
+double calcMinEntropy(uint *dataVector, int vectorLength) {
+  JointCounts counts;
+  double h;
+
+  INSTRUMENT_ENTER("calcMinEntropy",vectorLength);
+  counts = calculateJointCounts(dataVector,NULL,NULL,vectorLength);
+  h = specialRenyiEntropyFromCounts(counts,HUGE_VAL);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return h;
+}/*calcMinEntropy(uint*,int)*/
+
+double calcJointMinEntropy(uint *firstVector, uint *secondVector, int vectorLength) {
+  JointCounts counts;
+  double h;
+
+  INSTRUMENT_ENTER("calcJointMinEntropy",vectorLength);
+  counts = calculateJointCounts(firstVector,secondVector,NULL,vectorLength);
+  h = specialRenyiEntropyFromCounts(counts,HUGE_VAL);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return h;
+}/*calcJointMinEntropy(uint*,uint*,int)*/
 
 double renyiEntropy(ProbabilityState state, double alpha) {
   double entropy = 0.0;
   double tempValue = 0.0;
   int i;
+
+  if ((alpha == 2.0) || (alpha == HUGE_VAL)) {
+    return specialRenyiEntropy(state.probabilityVector,state.numStates,alpha);
+  }
   
   /*H_\alpha(X) = 1/(1-alpha) * \log(\sum_x p(x)^alpha)*/
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
   for (i = 0; i < state.numStates; i++) {
     tempValue = state.probabilityVector[i];
     if (tempValue > 0) {
-      entropy += pow(tempValue,alpha);
+      entropy += alphaPower(tempValue,alpha);
     }
   }
+  INSTRUMENT_PHASE_END();
   
   entropy = log(entropy);
   entropy /= log(LOG_BASE);
@@ -42,20 +191,36 @@ double renyiEntropy(ProbabilityState state, double alpha) {
 }
 
 double calcRenyiEntropy(double alpha, uint *dataVector, int vectorLength) {
-  ProbabilityState state = calculateProbability(dataVector,vectorLength);
-  double h = renyiEntropy(state,alpha);
-  
+  ProbabilityState state;
+  double h;
+
+  if (alpha == 2.0) {
+    return calcCollisionEntropy(dataVector,vectorLength);
+  } else if (alpha == HUGE_VAL) {
+    return calcMinEntropy(dataVector,vectorLength);
+  }
+
+  INSTRUMENT_ENTER("calcRenyiEntropy",vectorLength);
+  state = calculateProbability(dataVector,vectorLength);
+  h = renyiEntropy(state,alpha);
+
   freeProbabilityState(state);
-  
+  INSTRUMENT_EXIT();
+
   return h;
 }/*calcRenyiEntropy(double,uint*,int)*/
 
 double discAndCalcRenyiEntropy(double alpha, double *dataVector, int vectorLength) {
-  ProbabilityState state = discAndCalcProbability(dataVector,vectorLength);
-  double h = renyiEntropy(state,alpha);
-  
+  ProbabilityState state;
+  double h;
+
+  INSTRUMENT_ENTER("discAndCalcRenyiEntropy",vectorLength);
+  state = discAndCalcProbability(dataVector,vectorLength);
+  h = renyiEntropy(state,alpha);
+
   freeProbabilityState(state);
-  
+  INSTRUMENT_EXIT();
+
   return h;
 }/*discAndCalcRenyiEntropy(double,double*,int)*/
 
@@ -63,14 +228,20 @@ double jointRenyiEntropy(JointProbabilityState state, double alpha) {
   double jointEntropy = 0.0;  
   double tempValue = 0.0;
   int i;
+
+  if ((alpha == 2.0) || (alpha == HUGE_VAL)) {
+    return specialRenyiEntropy(state.jointProbabilityVector,state.numJointStates,alpha);
+  }
   
   /*H_\alpha(XY) = 1/(1-alpha) * log(2)(sum p(xy)^alpha)*/
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
   for (i = 0; i < state.numJointStates; i++) {
     tempValue = state.jointProbabilityVector[i];
     if (tempValue > 0) {
-      jointEntropy += pow(tempValue,alpha);
+      jointEntropy += alphaPower(tempValue,alpha);
     }
   }
+  INSTRUMENT_PHASE_END();
   
   jointEntropy = log(jointEntropy);
   jointEntropy /= log(LOG_BASE);
@@ -80,19 +251,124 @@ double jointRenyiEntropy(JointProbabilityState state, double alpha) {
 }
 
 double calcJointRenyiEntropy(double alpha, uint *firstVector, uint *secondVector, int vectorLength) {
-  JointProbabilityState state = calculateJointProbability(firstVector,secondVector,vectorLength);
-  double h = jointRenyiEntropy(state,alpha);
-  
+  JointProbabilityState state;
+  double h;
+
+  if (alpha == 2.0) {
+    return calcJointCollisionEntropy(firstVector,secondVector,vectorLength);
+  } else if (alpha == HUGE_VAL) {
+    return calcJointMinEntropy(firstVector,secondVector,vectorLength);
+  }
+
+  INSTRUMENT_ENTER("calcJointRenyiEntropy",vectorLength);
+  state = calculateJointProbability(firstVector,secondVector,vectorLength);
+  h = jointRenyiEntropy(state,alpha);
+
   freeJointProbabilityState(state);
-  
+  INSTRUMENT_EXIT();
+
   return h;
 }/*calcJointRenyiEntropy(double,uint*,uint*,int)*/
 
 double discAndCalcJointRenyiEntropy(double alpha, double *firstVector, double *secondVector, int vectorLength) {
-  JointProbabilityState state = discAndCalcJointProbability(firstVector,secondVector,vectorLength);
-  double h = jointRenyiEntropy(state,alpha);
-  
+  JointProbabilityState state;
+  double h;
+
+  INSTRUMENT_ENTER("discAndCalcJointRenyiEntropy",vectorLength);
+  state = discAndCalcJointProbability(firstVector,secondVector,vectorLength);
+  h = jointRenyiEntropy(state,alpha);
+
   freeJointProbabilityState(state);
-  
+  INSTRUMENT_EXIT();
+
   return h;
 }/*discAndCalcJointRenyiEntropy(double,double*,double*,int)*/
+
+/*******************************************************************************
+** Adds p^alpha for every non-zero probability to the sum for each alpha,
+** then converts the sums to entropies in place. An alpha of HUGE_VAL gives
+** the min-entropy.
+*******************************************************************************/
+static void sumAlphaPowers(double *probabilities, int numStates, double *alphas, int numAlphas, double *sums) {
+  double tempValue;
+  double maxProbability = 0.0;
+  int i, j;
+
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  for (j = 0; j < numAlphas; j++) {
+    sums[j] = 0.0;
+  }
+  for (i = 0; i < numStates; i++) {
+    tempValue = probabilities[i];
+    if (tempValue > 0) {
+      if (tempValue > maxProbability) {
+        maxProbability = tempValue;
+      }
+      for (j = 0; j < numAlphas; j++) {
+        if (alphas[j] != HUGE_VAL) {
+          sums[j] += alphaPower(tempValue,alphas[j]);
+        }
+      }
+    }
+  }
+  for (j = 0; j < numAlphas; j++) {
+    if (alphas[j] == HUGE_VAL) {
+      sums[j] = -log(maxProbability) / log(LOG_BASE);
+    } else {
+      sums[j] = log(sums[j]) / log(LOG_BASE) / (1.0-alphas[j]);
+    }
+  }
+  INSTRUMENT_PHASE_END();
+}/*sumAlphaPowers(double*,int,double*,int,double*)*/
+
+void multiAlphaRenyiEntropy(ProbabilityState state, double *alphas, int numAlphas, double *outputVector) {
+  sumAlphaPowers(state.probabilityVector,state.numStates,alphas,numAlphas,outputVector);
+}/*multiAlphaRenyiEntropy(ProbabilityState,double*,int,double*)*/
+
+void multiAlphaJointRenyiEntropy(JointProbabilityState state, double *alphas, int numAlphas, double *outputVector) {
+  sumAlphaPowers(state.jointProbabilityVector,state.numJointStates,alphas,numAlphas,outputVector);
+}/*multiAlphaJointRenyiEntropy(JointProbabilityState,double*,int,double*)*/
+
+void calcMultiAlphaRenyiEntropy(double *alphas, int numAlphas, uint *dataVector, int vectorLength, double *outputVector) {
+  ProbabilityState state;
+
+  INSTRUMENT_ENTER("calcMultiAlphaRenyiEntropy",vectorLength);
+  state = calculateProbability(dataVector,vectorLength);
+  multiAlphaRenyiEntropy(state,alphas,numAlphas,outputVector);
+
+  freeProbabilityState(state);
+  INSTRUMENT_EXIT();
+}/*calcMultiAlphaRenyiEntropy(double*,int,uint*,int,double*)*/
+
+void discAndCalcMultiAlphaRenyiEntropy(double *alphas, int numAlphas, double *dataVector, int vectorLength, double *outputVector) {
+  ProbabilityState state;
+
+  INSTRUMENT_ENTER("discAndCalcMultiAlphaRenyiEntropy",vectorLength);
+  state = discAndCalcProbability(dataVector,vectorLength);
+  multiAlphaRenyiEntropy(state,alphas,numAlphas,outputVector);
+
+  freeProbabilityState(state);
+  INSTRUMENT_EXIT();
+}/*discAndCalcMultiAlphaRenyiEntropy(double*,int,double*,int,double*)*/
+
+void calcMultiAlphaJointRenyiEntropy(double *alphas, int numAlphas, uint *firstVector, uint *secondVector, int vectorLength, double *outputVector) {
+  JointProbabilityState state;
+
+  INSTRUMENT_ENTER("calcMultiAlphaJointRenyiEntropy",vectorLength);
+  state = calculateJointProbability(firstVector,secondVector,vectorLength);
+  multiAlphaJointRenyiEntropy(state,alphas,numAlphas,outputVector);
+
+  freeJointProbabilityState(state);
+  INSTRUMENT_EXIT();
+}/*calcMultiAlphaJointRenyiEntropy(double*,int,uint*,uint*,int,double*)*/
+
+void discAndCalcMultiAlphaJointRenyiEntropy(double *alphas, int numAlphas, double *firstVector, double *secondVector, int vectorLength, double *outputVector) {
+  JointProbabilityState state;
+
+  INSTRUMENT_ENTER("discAndCalcMultiAlphaJointRenyiEntropy",vectorLength);
+  state = discAndCalcJointProbability(firstVector,secondVector,vectorLength);
+  multiAlphaJointRenyiEntropy(state,alphas,numAlphas,outputVector);
+
+  freeJointProbabilityState(state);
+  INSTRUMENT_EXIT();
+}/*discAndCalcMultiAlphaJointRenyiEntropy(double*,int,double*,double*,int,double*)*/
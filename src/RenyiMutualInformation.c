@@ -18,16 +18,137 @@
 #include "MIToolbox/MIToolbox.h"
 #include "MIToolbox/ArrayOperations.h"
 #include "MIToolbox/CalculateProbability.h"
+#include "MIToolbox/JointCounts.h"
 #include "MIToolbox/RenyiEntropy.h"
 #include "MIToolbox/RenyiMutualInformation.h"
+#include "MIToolbox/Instrumentation.h"
+
+/*******************************************************************************
+** D_2(p(x,y)||p(x)p(y)) = \log \sum p(x,y)^2 / (p(x)p(y)) and
+** D_\infty(p(x,y)||p(x)p(y)) = \log \max p(x,y) / (p(x)p(y)), so neither
+** needs a pow per state.
+*******************************************************************************/
+static double specialRenyiMI(JointProbabilityState state, double alpha) {
+  int i, j;
+  double *jointRow;
+  double ratio;
+  double sum = 0.0;
+
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  for (j = 0; j < state.numSecondStates; j++) {
+    if (state.secondProbabilityVector[j] > 0) {
+      jointRow = state.jointProbabilityVector + j*state.numFirstStates;
+      for (i = 0; i < state.numFirstStates; i++) {
+        if (jointRow[i] > 0) {
+          ratio = jointRow[i] / (state.firstProbabilityVector[i] * state.secondProbabilityVector[j]);
+          if (alpha == 2.0) {
+            sum += jointRow[i] * ratio;
+          } else if (ratio > sum) {
+            sum = ratio;
+          }
+        }
+      }
+    }
+  }
+  INSTRUMENT_PHASE_END();
+
+  return log(sum) / log(LOG_BASE);
+}/*specialRenyiMI(JointProbabilityState,double)*/
+
+/*******************************************************************************
+** The same from the integer counts, where
+** D_2 = \log \sum c(x,y)^2 / (c(x)c(y)) and
+** D_\infty = \log n \max c(x,y) / (c(x)c(y)).
+*******************************************************************************/
+static double specialRenyiMIFromCounts(JointCounts counts, double alpha) {
+  double *firstCounts;
+  uint *jointRow;
+  double secondCount, jointCount, ratio;
+  double sum = 0.0;
+  int i, j;
+
+  if (counts.numSamples == 0) {
+    return 0.0;
+  }
+
+  firstCounts = (double *) checkedCalloc(counts.numFirstStates,sizeof(double));
+  for (j = 0; j < counts.numSecondStates; j++) {
+    jointRow = counts.jointCounts + j*counts.numFirstStates;
+    for (i = 0; i < counts.numFirstStates; i++) {
+      firstCounts[i] += jointRow[i];
+    }
+  }
+
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  for (j = 0; j < counts.numSecondStates; j++) {
+    jointRow = counts.jointCounts + j*counts.numFirstStates;
+    secondCount = 0.0;
+    for (i = 0; i < counts.numFirstStates; i++) {
+      secondCount += jointRow[i];
+    }
+    for (i = 0; i < counts.numFirstStates; i++) {
+      if (jointRow[i] > 0) {
+        jointCount = jointRow[i];
+        ratio = jointCount / (firstCounts[i] * secondCount);
+        if (alpha == 2.0) {
+          sum += jointCount * ratio;
+        } else if (ratio > sum) {
+          sum = ratio;
+        }
+      }
+    }
+  }
+  if (alpha != 2.0) {
+    sum *= counts.numSamples;
+  }
+  sum = log(sum) / log(LOG_BASE);
+  INSTRUMENT_PHASE_END();
+
+  FREE_FUNC(firstCounts);
+  firstCounts = NULL;
+
+  return sum;
+}/*specialRenyiMIFromCounts(JointCounts,double)*/
+
+double calcCollisionMIDivergence(uint *dataVector, uint *targetVector, int vectorLength) {
+  JointCounts counts;
+  double mutualInformation;
+
+  INSTRUMENT_ENTER("calcCollisionMIDivergence",vectorLength);
+  counts = calculateJointCounts(dataVector,targetVector,NULL,vectorLength);
+  mutualInformation = specialRenyiMIFromCounts(counts,2.0);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return mutualInformation;
+}/*calcCollisionMIDivergence(uint *, uint *, int)*/
+
+double calcMinMIDivergence(uint *dataVector, uint *targetVector, int vectorLength) {
+  JointCounts counts;
+  double mutualInformation;
+
+  INSTRUMENT_ENTER("calcMinMIDivergence",vectorLength);
+  counts = calculateJointCounts(dataVector,targetVector,NULL,vectorLength);
+  mutualInformation = specialRenyiMIFromCounts(counts,HUGE_VAL);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return mutualInformation;
+}/*calcMinMIDivergence(uint *, uint *, int)*/
 
 double renyiMI(JointProbabilityState state, double alpha) {
-  int firstIndex,secondIndex;
-  int i;
+  int i, j;
+  double *jointRow;
   double jointTemp, marginalTemp;
   double invAlpha = 1.0 - alpha;
   double mutualInformation = 0.0;
 
+  if ((alpha == 2.0) || (alpha == HUGE_VAL)) {
+    return specialRenyiMI(state,alpha);
+  }
+
   /* standard MI is D_KL(p(x,y)||p(x)p(y))
   ** which expands to
   ** D_KL(p(x,y)||p(x)p(y)) = sum(p(x,y) * log(p(x,y)/(p(x)p(y))))
@@ -37,17 +158,22 @@ double renyiMI(JointProbabilityState state, double alpha) {
   ** D_alpha(p(x,y)||p(x)p(y)) = 1/(alpha-1) * log(sum((p(x,y)^alpha)*((p(x)p(y))^(1-alpha))))
   */
   
-  for (i = 0; i < state.numJointStates; i++) {
-    firstIndex = i % state.numFirstStates;
-    secondIndex = i / state.numFirstStates;
-    
-    if ((state.jointProbabilityVector[i] > 0) && (state.firstProbabilityVector[firstIndex] > 0) && (state.secondProbabilityVector[secondIndex] > 0)) {
-      jointTemp = pow(state.jointProbabilityVector[i],alpha);
-      marginalTemp = state.firstProbabilityVector[firstIndex] * state.secondProbabilityVector[secondIndex];
-      marginalTemp = pow(marginalTemp,invAlpha);
-      mutualInformation += (jointTemp * marginalTemp);
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  /* walks the joint one row (state of Y) at a time to avoid the modulo and division */
+  for (j = 0; j < state.numSecondStates; j++) {
+    if (state.secondProbabilityVector[j] > 0) {
+      jointRow = state.jointProbabilityVector + j*state.numFirstStates;
+      for (i = 0; i < state.numFirstStates; i++) {
+        if ((jointRow[i] > 0) && (state.firstProbabilityVector[i] > 0)) {
+          jointTemp = alphaPower(jointRow[i],alpha);
+          marginalTemp = state.firstProbabilityVector[i] * state.secondProbabilityVector[j];
+          marginalTemp = alphaPower(marginalTemp,invAlpha);
+          mutualInformation += (jointTemp * marginalTemp);
+        }
+      }
     }
   }
+  INSTRUMENT_PHASE_END();
 
   mutualInformation = log(mutualInformation);
   mutualInformation /= log(LOG_BASE);  
@@ -57,38 +183,62 @@ double renyiMI(JointProbabilityState state, double alpha) {
 }
 
 double calcRenyiMIDivergence(double alpha, uint *dataVector, uint *targetVector, int vectorLength) {
-  JointProbabilityState state = calculateJointProbability(dataVector,targetVector,vectorLength);
-  double mutualInformation = renyiMI(state,alpha);
-  
+  JointProbabilityState state;
+  double mutualInformation;
+
+  if (alpha == 2.0) {
+    return calcCollisionMIDivergence(dataVector,targetVector,vectorLength);
+  } else if (alpha == HUGE_VAL) {
+    return calcMinMIDivergence(dataVector,targetVector,vectorLength);
+  }
+
+  INSTRUMENT_ENTER("calcRenyiMIDivergence",vectorLength);
+  state = calculateJointProbability(dataVector,targetVector,vectorLength);
+  mutualInformation = renyiMI(state,alpha);
+
   freeJointProbabilityState(state);
-  
+  INSTRUMENT_EXIT();
+
   return mutualInformation;
 }/*calcRenyiMIDivergence(double, uint *, uint *, int)*/
 
 double discAndCalcRenyiMIDivergence(double alpha, double *dataVector, double *targetVector, int vectorLength) {
-  JointProbabilityState state = discAndCalcJointProbability(dataVector,targetVector,vectorLength);
-  double mutualInformation = renyiMI(state,alpha);
-  
+  JointProbabilityState state;
+  double mutualInformation;
+
+  INSTRUMENT_ENTER("discAndCalcRenyiMIDivergence",vectorLength);
+  state = discAndCalcJointProbability(dataVector,targetVector,vectorLength);
+  mutualInformation = renyiMI(state,alpha);
+
   freeJointProbabilityState(state);
-  
+  INSTRUMENT_EXIT();
+
   return mutualInformation;
 }/*discAndCalcRenyiMIDivergence(double, double *, double *, int)*/
 
 double calcRenyiMIJoint(double alpha, uint *dataVector, uint *targetVector, int vectorLength) {
-  double hY = calcRenyiEntropy(alpha, targetVector, vectorLength);
-  double hX = calcRenyiEntropy(alpha, dataVector, vectorLength);
+  double hY, hX, hXY, answer;
+
+  INSTRUMENT_ENTER("calcRenyiMIJoint",vectorLength);
+  hY = calcRenyiEntropy(alpha, targetVector, vectorLength);
+  hX = calcRenyiEntropy(alpha, dataVector, vectorLength);
   
-  double hXY = calcJointRenyiEntropy(alpha, dataVector, targetVector, vectorLength);
+  hXY = calcJointRenyiEntropy(alpha, dataVector, targetVector, vectorLength);
   
-  double answer = hX + hY - hXY;
+  answer = hX + hY - hXY;
+  INSTRUMENT_EXIT();
   
   return answer;
 }/*calcRenyiMIJoint(double, uint*, uint*, int)*/
 
 double discAndCalcRenyiMIJoint(double alpha, double *dataVector, double *targetVector, int vectorLength) {
   double mi;
-  uint *dataNormVector = (uint *) checkedCalloc(vectorLength, sizeof(uint));
-  uint *targetNormVector = (uint *) checkedCalloc(vectorLength, sizeof(uint));
+  uint *dataNormVector;
+  uint *targetNormVector;
+
+  INSTRUMENT_ENTER("discAndCalcRenyiMIJoint",vectorLength);
+  dataNormVector = (uint *) checkedCalloc(vectorLength, sizeof(uint));
+  targetNormVector = (uint *) checkedCalloc(vectorLength, sizeof(uint));
 
   normaliseArray(dataVector,dataNormVector,vectorLength);
   normaliseArray(targetVector,targetNormVector,vectorLength);
@@ -99,6 +249,123 @@ double discAndCalcRenyiMIJoint(double alpha, double *dataVector, double *targetV
   FREE_FUNC(targetNormVector);
   dataNormVector = NULL;
   targetNormVector = NULL;
+  INSTRUMENT_EXIT();
 
   return mi;
 }/*discAndCalcRenyiMIJoint(double, double*, double*, int)*/
+
+void multiAlphaRenyiMI(JointProbabilityState state, double *alphas, int numAlphas, double *outputVector) {
+  int i, j, k;
+  double *jointRow;
+  double jointValue, marginalValue;
+  double maxRatio = 0.0;
+
+  for (k = 0; k < numAlphas; k++) {
+    outputVector[k] = 0.0;
+  }
+
+  /* D_alpha(p(x,y)||p(x)p(y)) = 1/(alpha-1) * log(sum((p(x,y)^alpha)*((p(x)p(y))^(1-alpha)))) */
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  for (j = 0; j < state.numSecondStates; j++) {
+    if (state.secondProbabilityVector[j] > 0) {
+      jointRow = state.jointProbabilityVector + j*state.numFirstStates;
+      for (i = 0; i < state.numFirstStates; i++) {
+        if ((jointRow[i] > 0) && (state.firstProbabilityVector[i] > 0)) {
+          jointValue = jointRow[i];
+          marginalValue = state.firstProbabilityVector[i] * state.secondProbabilityVector[j];
+          if (jointValue > maxRatio * marginalValue) {
+            maxRatio = jointValue / marginalValue;
+          }
+          for (k = 0; k < numAlphas; k++) {
+            if (alphas[k] != HUGE_VAL) {
+              outputVector[k] += alphaPower(jointValue,alphas[k]) * alphaPower(marginalValue,1.0-alphas[k]);
+            }
+          }
+        }
+      }
+    }
+  }
+  INSTRUMENT_PHASE_END();
+
+  for (k = 0; k < numAlphas; k++) {
+    if (alphas[k] == HUGE_VAL) {
+      outputVector[k] = log(maxRatio) / log(LOG_BASE);
+    } else {
+      outputVector[k] = log(outputVector[k]) / log(LOG_BASE) / (alphas[k]-1.0);
+    }
+  }
+}/*multiAlphaRenyiMI(JointProbabilityState,double*,int,double*)*/
+
+/*******************************************************************************
+** The marginal entropies are calculated from the marginals of the joint
+** state, so all three entropies come from one histogram.
+*******************************************************************************/
+void multiAlphaRenyiMIJoint(JointProbabilityState state, double *alphas, int numAlphas, double *outputVector) {
+  ProbabilityState marginal;
+  double *firstEntropies = (double *) checkedCalloc(numAlphas,sizeof(double));
+  double *secondEntropies = (double *) checkedCalloc(numAlphas,sizeof(double));
+  int k;
+
+  marginal.probabilityVector = state.firstProbabilityVector;
+  marginal.numStates = state.numFirstStates;
+  multiAlphaRenyiEntropy(marginal,alphas,numAlphas,firstEntropies);
+
+  marginal.probabilityVector = state.secondProbabilityVector;
+  marginal.numStates = state.numSecondStates;
+  multiAlphaRenyiEntropy(marginal,alphas,numAlphas,secondEntropies);
+
+  multiAlphaJointRenyiEntropy(state,alphas,numAlphas,outputVector);
+
+  for (k = 0; k < numAlphas; k++) {
+    outputVector[k] = firstEntropies[k] + secondEntropies[k] - outputVector[k];
+  }
+
+  FREE_FUNC(firstEntropies);
+  FREE_FUNC(secondEntropies);
+  firstEntropies = NULL;
+  secondEntropies = NULL;
+}/*multiAlphaRenyiMIJoint(JointProbabilityState,double*,int,double*)*/
+
+void calcMultiAlphaRenyiMIDivergence(double *alphas, int numAlphas, uint *dataVector, uint *targetVector, int vectorLength, double *outputVector) {
+  JointProbabilityState state;
+
+  INSTRUMENT_ENTER("calcMultiAlphaRenyiMIDivergence",vectorLength);
+  state = calculateJointProbability(dataVector,targetVector,vectorLength);
+  multiAlphaRenyiMI(state,alphas,numAlphas,outputVector);
+
+  freeJointProbabilityState(state);
+  INSTRUMENT_EXIT();
+}/*calcMultiAlphaRenyiMIDivergence(double*,int,uint*,uint*,int,double*)*/
+
+void discAndCalcMultiAlphaRenyiMIDivergence(double *alphas, int numAlphas, double *dataVector, double *targetVector, int vectorLength, double *outputVector) {
+  JointProbabilityState state;
+
+  INSTRUMENT_ENTER("discAndCalcMultiAlphaRenyiMIDivergence",vectorLength);
+  state = discAndCalcJointProbability(dataVector,targetVector,vectorLength);
+  multiAlphaRenyiMI(state,alphas,numAlphas,outputVector);
+
+  freeJointProbabilityState(state);
+  INSTRUMENT_EXIT();
+}/*discAndCalcMultiAlphaRenyiMIDivergence(double*,int,double*,double*,int,double*)*/
+
+void calcMultiAlphaRenyiMIJoint(double *alphas, int numAlphas, uint *dataVector, uint *targetVector, int vectorLength, double *outputVector) {
+  JointProbabilityState state;
+
+  INSTRUMENT_ENTER("calcMultiAlphaRenyiMIJoint",vectorLength);
+  state = calculateJointProbability(dataVector,targetVector,vectorLength);
+  multiAlphaRenyiMIJoint(state,alphas,numAlphas,outputVector);
+
+  freeJointProbabilityState(state);
+  INSTRUMENT_EXIT();
+}/*calcMultiAlphaRenyiMIJoint(double*,int,uint*,uint*,int,double*)*/
+
+void discAndCalcMultiAlphaRenyiMIJoint(double *alphas, int numAlphas, double *dataVector, double *targetVector, int vectorLength, double *outputVector) {
+  JointProbabilityState state;
+
+  INSTRUMENT_ENTER("discAndCalcMultiAlphaRenyiMIJoint",vectorLength);
+  state = discAndCalcJointProbability(dataVector,targetVector,vectorLength);
+  multiAlphaRenyiMIJoint(state,alphas,numAlphas,outputVector);
+
+  freeJointProbabilityState(state);
+  INSTRUMENT_EXIT();
+}/*discAndCalcMultiAlphaRenyiMIJoint(double*,int,double*,double*,int,double*)*/
@@ -0,0 +1,375 @@
+/*******************************************************************************
+** Resampling.c
+** Part of the mutual information toolbox
+**
+** Contains permutation tests for the mutual information, and bootstrap
+** confidence intervals for the entropy, mutual information and conditional
+** mutual information. The marginal histograms are unchanged by permuting a
+** variable, so each permutation only recounts the joint histogram, and each
+** bootstrap replicate redraws the counts of the occupied joint states
+** without touching the samples. Replicates are generated from a seeded
+** generator and run in parallel when compiled with OpenMP, and a given seed
+** gives the same answer for any number of threads.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include <stdint.h>
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/JointCounts.h"
+#include "MIToolbox/Resampling.h"
+#include "MIToolbox/Instrumentation.h"
+#include "CountSums.h"
+
+/* Replicates run between checks of the stopping rule */
+#define PERMUTATION_BLOCK 64
+/* Standard errors the p-value must be from the threshold to stop early */
+#define STOPPING_ERRORS 3.0
+/* Relative tolerance when comparing a replicate with the observed value */
+#define TIE_TOLERANCE 1e-12
+/* Means below this are drawn by multiplying uniforms, above by rejection */
+#define SMALL_POISSON_MEAN 10.0
+
+#define UINT64_CONSTANT(high,low) (((uint64_t) (high) << 32) | (uint64_t) (low))
+
+/*******************************************************************************
+** splitmix64, seeded per replicate so each replicate is the same whichever
+** thread runs it.
+*******************************************************************************/
+static uint64_t nextRandom(uint64_t *state) {
+  uint64_t z;
+
+  *state += UINT64_CONSTANT(0x9e3779b9UL,0x7f4a7c15UL);
+  z = *state;
+  z = (z ^ (z >> 30)) * UINT64_CONSTANT(0xbf58476dUL,0x1ce4e5b9UL);
+  z = (z ^ (z >> 27)) * UINT64_CONSTANT(0x94d049bbUL,0x133111ebUL);
+  return z ^ (z >> 31);
+}/*nextRandom(uint64_t *)*/
+
+static uint64_t replicateSeed(unsigned long seed, int replicate) {
+  uint64_t state = seed;
+
+  state = nextRandom(&state) + (uint64_t) replicate;
+  return nextRandom(&state);
+}/*replicateSeed(unsigned long,int)*/
+
+/* Fisher-Yates shuffle, using the high bits of each draw to pick in [0,i] */
+static void shuffle(uint *vector, int vectorLength, uint64_t state) {
+  uint temp;
+  int i, j;
+
+  for (i = vectorLength - 1; i > 0; i--) {
+    j = (int) (((nextRandom(&state) >> 32) * (uint64_t) (i + 1)) >> 32);
+    temp = vector[i];
+    vector[i] = vector[j];
+    vector[j] = temp;
+  }
+}/*shuffle(uint *,int,uint64_t)*/
+
+/*******************************************************************************
+** \sum c(x,y) \log c(x,y), the only count sum in I(X;Y) which changes when
+** Y is permuted.
+*******************************************************************************/
+static double jointSum(uint *dataVector, uint *targetVector, int numFirstStates, int numJointStates,
+                       int vectorLength, int *jointCounts) {
+  int i;
+
+  memset(jointCounts,0,numJointStates * sizeof(int));
+  for (i = 0; i < vectorLength; i++) {
+    jointCounts[dataVector[i] + numFirstStates * targetVector[i]]++;
+  }
+
+  return sumCountLogCount(jointCounts,numJointStates);
+}/*jointSum(uint *,uint *,int,int,int,int *)*/
+
+PermutationTest calcMutualInformationPermutationTest(uint *dataVector, uint *targetVector, int vectorLength,
+                                                     int numPermutations, double threshold, unsigned long seed) {
+  PermutationTest result;
+  double length = vectorLength;
+  double observedSum, firstSum, secondSum, tolerance;
+  double pValue, standardError;
+  int *jointCounts, *firstCounts, *secondCounts;
+  int numFirstStates, numSecondStates, numJointStates;
+  int exceeded = 0;
+  int completed = 0;
+  int blockEnd, i;
+
+  INSTRUMENT_ENTER("calcMutualInformationPermutationTest",vectorLength);
+  result.mutualInformation = 0.0;
+  result.pValue = 1.0;
+  result.numPermutations = 0;
+  if (vectorLength == 0) {
+    INSTRUMENT_EXIT();
+    return result;
+  }
+
+  numFirstStates = maxState(dataVector,vectorLength);
+  numSecondStates = maxState(targetVector,vectorLength);
+  numJointStates = numFirstStates * numSecondStates;
+  jointCounts = (int *) checkedCalloc(numJointStates,sizeof(int));
+  firstCounts = (int *) checkedCalloc(numFirstStates,sizeof(int));
+  secondCounts = (int *) checkedCalloc(numSecondStates,sizeof(int));
+
+  for (i = 0; i < vectorLength; i++) {
+    firstCounts[dataVector[i]]++;
+    secondCounts[targetVector[i]]++;
+  }
+  firstSum = sumCountLogCount(firstCounts,numFirstStates);
+  secondSum = sumCountLogCount(secondCounts,numSecondStates);
+  observedSum = jointSum(dataVector,targetVector,numFirstStates,numJointStates,vectorLength,jointCounts);
+  tolerance = TIE_TOLERANCE * (fabs(observedSum) + 1.0);
+
+  result.mutualInformation = mutualInformationFromSums(length,observedSum,firstSum,secondSum);
+
+  while (completed < numPermutations) {
+    blockEnd = completed + PERMUTATION_BLOCK < numPermutations ? completed + PERMUTATION_BLOCK : numPermutations;
+
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+      int *replicateCounts = (int *) checkedCalloc(numJointStates,sizeof(int));
+      uint *permutedVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
+      int replicate;
+
+#ifdef _OPENMP
+      #pragma omp for schedule(dynamic,1) reduction(+:exceeded)
+#endif
+      for (replicate = completed; replicate < blockEnd; replicate++) {
+        memcpy(permutedVector,targetVector,vectorLength * sizeof(uint));
+        shuffle(permutedVector,vectorLength,replicateSeed(seed,replicate));
+        if (jointSum(dataVector,permutedVector,numFirstStates,numJointStates,vectorLength,replicateCounts) >= observedSum - tolerance) {
+          exceeded++;
+        }
+      }
+
+      FREE_FUNC(replicateCounts);
+      FREE_FUNC(permutedVector);
+    }
+    completed = blockEnd;
+
+    pValue = (1.0 + exceeded) / (1.0 + completed);
+    standardError = sqrt(pValue * (1.0 - pValue) / completed);
+    if ((threshold > 0) && (fabs(pValue - threshold) > STOPPING_ERRORS * standardError)) {
+      break;
+    }
+  }
+
+  result.pValue = (1.0 + exceeded) / (1.0 + completed);
+  result.numPermutations = completed;
+
+  FREE_FUNC(jointCounts);
+  FREE_FUNC(firstCounts);
+  FREE_FUNC(secondCounts);
+  jointCounts = NULL;
+  firstCounts = NULL;
+  secondCounts = NULL;
+  INSTRUMENT_EXIT();
+
+  return result;
+}/*calcMutualInformationPermutationTest(uint *,uint *,int,int,double,unsigned long)*/
+
+/* uniform on [0,1) from the top 53 bits */
+static double nextUniform(uint64_t *state) {
+  return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}/*nextUniform(uint64_t *)*/
+
+/*******************************************************************************
+** \log k!, using Stirling's series above 16 where it is accurate to double
+** precision.
+*******************************************************************************/
+static double logFactorial(double k) {
+  double sum = 0.0;
+  double i;
+
+  if (k < 16) {
+    for (i = 2; i <= k; i++) {
+      sum += log(i);
+    }
+    return sum;
+  }
+  k += 1.0;
+  return (k - 0.5) * log(k) - k + 0.91893853320467274178
+         + 1.0 / (12.0 * k) - 1.0 / (360.0 * k * k * k) + 1.0 / (1260.0 * k * k * k * k * k);
+}/*logFactorial(double)*/
+
+/*******************************************************************************
+** Draws from a Poisson distribution, by Knuth's product of uniforms for small
+** means and Hormann's transformed rejection (PTRS) for large ones.
+*******************************************************************************/
+static uint poissonDraw(double mean, uint64_t *state) {
+  double limit, product, k;
+  double root, logMean, a, b, invAlpha, vr, u, v, us;
+
+  if (mean < SMALL_POISSON_MEAN) {
+    limit = exp(-mean);
+    product = nextUniform(state);
+    k = 0;
+    while (product > limit) {
+      product *= nextUniform(state);
+      k++;
+    }
+    return (uint) k;
+  }
+
+  root = sqrt(mean);
+  logMean = log(mean);
+  b = 0.931 + 2.53 * root;
+  a = -0.059 + 0.02483 * b;
+  invAlpha = 1.1239 + 1.1328 / (b - 3.4);
+  vr = 0.9277 - 3.6224 / (b - 2.0);
+  for (;;) {
+    u = nextUniform(state) - 0.5;
+    v = nextUniform(state);
+    us = 0.5 - fabs(u);
+    k = floor((2.0 * a / us + b) * u + mean + 0.43);
+    if ((us >= 0.07) && (v <= vr)) {
+      return (uint) k;
+    }
+    if ((k < 0) || ((us < 0.013) && (v > us))) {
+      continue;
+    }
+    if (log(v) + log(invAlpha) - log(a / (us * us) + b) <= -mean + k * logMean - logFactorial(k)) {
+      return (uint) k;
+    }
+  }
+}/*poissonDraw(double,uint64_t *)*/
+
+static int compareDoubles(const void *first, const void *second) {
+  double a = *(const double *) first;
+  double b = *(const double *) second;
+
+  return a < b ? -1 : (a > b ? 1 : 0);
+}/*compareDoubles(const void *,const void *)*/
+
+/* the linearly interpolated quantile of sorted values */
+static double quantile(double *sortedValues, int numValues, double probability) {
+  double position = probability * (numValues - 1);
+  int index = (int) floor(position);
+
+  if (index >= numValues - 1) {
+    return sortedValues[numValues - 1];
+  }
+  return sortedValues[index] + (position - index) * (sortedValues[index + 1] - sortedValues[index]);
+}/*quantile(double *,int,double)*/
+
+typedef double (*CountsStatistic)(JointCounts counts);
+
+/*******************************************************************************
+** Runs the bootstrap for one of the counts functions from JointCounts.h.
+** Each thread keeps a JointCounts whose unoccupied states stay zero, and
+** redraws only the occupied states for each replicate.
+*******************************************************************************/
+static ConfidenceInterval bootstrapCounts(JointCounts counts, CountsStatistic statistic,
+                                          int numReplicates, double confidence, unsigned long seed) {
+  ConfidenceInterval interval;
+  double *replicates;
+  int *occupied;
+  int numOccupied = 0;
+  int i;
+
+  interval.estimate = statistic(counts);
+  interval.lower = interval.estimate;
+  interval.upper = interval.estimate;
+  if ((numReplicates < 1) || (counts.numSamples == 0) || !((confidence > 0.0) && (confidence < 1.0))) {
+    return interval;
+  }
+
+  occupied = (int *) checkedCalloc(counts.numJointStates,sizeof(int));
+  for (i = 0; i < counts.numJointStates; i++) {
+    if (counts.jointCounts[i] > 0) {
+      occupied[numOccupied++] = i;
+    }
+  }
+  replicates = (double *) checkedCalloc(numReplicates,sizeof(double));
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    JointCounts replicateCounts = counts;
+    uint64_t state;
+    int replicate, j;
+
+    replicateCounts.jointCounts = (uint *) checkedCalloc(counts.numJointStates,sizeof(uint));
+
+#ifdef _OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (replicate = 0; replicate < numReplicates; replicate++) {
+      state = replicateSeed(seed,replicate);
+      replicateCounts.numSamples = 0;
+      for (j = 0; j < numOccupied; j++) {
+        replicateCounts.jointCounts[occupied[j]] = poissonDraw(counts.jointCounts[occupied[j]],&state);
+        replicateCounts.numSamples += replicateCounts.jointCounts[occupied[j]];
+      }
+      replicates[replicate] = statistic(replicateCounts);
+    }
+
+    FREE_FUNC(replicateCounts.jointCounts);
+  }
+
+  qsort(replicates,numReplicates,sizeof(double),compareDoubles);
+  interval.lower = quantile(replicates,numReplicates,(1.0 - confidence) / 2.0);
+  interval.upper = quantile(replicates,numReplicates,1.0 - (1.0 - confidence) / 2.0);
+
+  FREE_FUNC(occupied);
+  FREE_FUNC(replicates);
+  occupied = NULL;
+  replicates = NULL;
+
+  return interval;
+}/*bootstrapCounts(JointCounts,CountsStatistic,int,double,unsigned long)*/
+
+ConfidenceInterval calcEntropyBootstrap(uint *dataVector, int vectorLength,
+                                        int numReplicates, double confidence, unsigned long seed) {
+  ConfidenceInterval interval;
+  JointCounts counts;
+
+  INSTRUMENT_ENTER("calcEntropyBootstrap",vectorLength);
+  counts = calculateJointCounts(dataVector,NULL,NULL,vectorLength);
+  interval = bootstrapCounts(counts,countsEntropy,numReplicates,confidence,seed);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return interval;
+}/*calcEntropyBootstrap(uint *,int,int,double,unsigned long)*/
+
+ConfidenceInterval calcMutualInformationBootstrap(uint *dataVector, uint *targetVector, int vectorLength,
+                                                  int numReplicates, double confidence, unsigned long seed) {
+  ConfidenceInterval interval;
+  JointCounts counts;
+
+  INSTRUMENT_ENTER("calcMutualInformationBootstrap",vectorLength);
+  counts = calculateJointCounts(dataVector,targetVector,NULL,vectorLength);
+  interval = bootstrapCounts(counts,countsMutualInformation,numReplicates,confidence,seed);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return interval;
+}/*calcMutualInformationBootstrap(uint *,uint *,int,int,double,unsigned long)*/
+
+ConfidenceInterval calcConditionalMutualInformationBootstrap(uint *dataVector, uint *targetVector, uint *conditionVector,
+                                                             int vectorLength, int numReplicates, double confidence,
+                                                             unsigned long seed) {
+  ConfidenceInterval interval;
+  JointCounts counts;
+
+  INSTRUMENT_ENTER("calcConditionalMutualInformationBootstrap",vectorLength);
+  counts = calculateJointCounts(dataVector,targetVector,conditionVector,vectorLength);
+  interval = bootstrapCounts(counts,countsConditionalMutualInformation,numReplicates,confidence,seed);
+
+  freeJointCounts(counts);
+  INSTRUMENT_EXIT();
+
+  return interval;
+}/*calcConditionalMutualInformationBootstrap(uint *,uint *,uint *,int,int,double,unsigned long)*/
@@ -0,0 +1,285 @@
+/*******************************************************************************
+** SegmentedInformation.c
+** Part of the mutual information toolbox
+**
+** Contains functions to calculate H(X), I(X;Y) and H(X|Y) separately within
+** each segment of the samples, given a vector of segment ids (e.g. a
+** customer segment). All the segments are counted in a single pass over the
+** data, and the values are calculated in parallel across segments when
+** compiled with OpenMP.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/Instrumentation.h"
+#include "MIToolbox/SegmentedInformation.h"
+#include "CountSums.h"
+
+/*******************************************************************************
+** A segment-major histogram has numSegments * numJointStates cells, most of
+** which are empty when there are many segments. Above this many cells per
+** sample (or MIN_DENSE_CELLS) the samples are grouped by segment instead.
+*******************************************************************************/
+#define DENSE_CELLS_PER_SAMPLE 2.0
+#define MIN_DENSE_CELLS 65536.0
+
+/*******************************************************************************
+** The \sum c \log c terms of each segment, and its number of samples.
+*******************************************************************************/
+typedef struct ssState
+{
+  double *jointSums;
+  double *firstSums;
+  double *secondSums;
+  double *lengths;
+} SegmentSums;
+
+/*******************************************************************************
+** Counts every segment into one histogram, with the joint state (x,y) of
+** segment s stored at counts[x + numFirstStates*(y + numSecondStates*s)].
+*******************************************************************************/
+static void denseSegmentSums(uint *firstVector, uint *secondVector, uint *segmentVector, int vectorLength,
+                             int numFirstStates, int numSecondStates, int numSegments, SegmentSums sums) {
+  size_t numJointStates = (size_t) numFirstStates * numSecondStates;
+  int *counts = (int *) checkedCalloc(numJointStates * numSegments,sizeof(int));
+  int i;
+
+  INSTRUMENT_PHASE_BEGIN(COUNTING_PHASE);
+  for (i = 0; i < vectorLength; i++) {
+    counts[firstVector[i] + numFirstStates * (secondVector == NULL ? 0 : secondVector[i]) + numJointStates * segmentVector[i]]++;
+    sums.lengths[segmentVector[i]] += 1.0;
+  }
+  INSTRUMENT_PHASE_END();
+
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    int *firstCounts = (int *) checkedCalloc(numFirstStates,sizeof(int));
+    int *row;
+    double jointSum, secondSum;
+    int s, x, y, rowCount;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic,4)
+#endif
+    for (s = 0; s < numSegments; s++) {
+      memset(firstCounts,0,numFirstStates * sizeof(int));
+      jointSum = 0.0;
+      secondSum = 0.0;
+      for (y = 0; y < numSecondStates; y++) {
+        row = counts + numJointStates * s + (size_t) numFirstStates * y;
+        rowCount = 0;
+        for (x = 0; x < numFirstStates; x++) {
+          jointSum += countLogCount(row[x]);
+          firstCounts[x] += row[x];
+          rowCount += row[x];
+        }
+        secondSum += countLogCount(rowCount);
+      }
+      sums.jointSums[s] = jointSum;
+      sums.firstSums[s] = sumCountLogCount(firstCounts,numFirstStates);
+      sums.secondSums[s] = secondSum;
+    }
+
+    FREE_FUNC(firstCounts);
+  }
+  INSTRUMENT_PHASE_END();
+
+  FREE_FUNC(counts);
+  counts = NULL;
+}/*denseSegmentSums(uint *,uint *,uint *,int,int,int,int,SegmentSums)*/
+
+/*******************************************************************************
+** Sorts the joint states by segment with a counting sort, then counts each
+** segment into a histogram shared by the thread. Each count is added to the
+** sums and reset the first time its state is seen in a second pass over the
+** segment, so a segment costs O(samples in the segment).
+*******************************************************************************/
+static void groupedSegmentSums(uint *firstVector, uint *secondVector, uint *segmentVector, int vectorLength,
+                               int numFirstStates, int numSecondStates, int numSegments, SegmentSums sums) {
+  int *segmentStarts = (int *) checkedCalloc((size_t) numSegments + 1,sizeof(int));
+  uint *groupedStates = (uint *) checkedCalloc(vectorLength > 0 ? vectorLength : 1,sizeof(uint));
+  int i, s;
+
+  INSTRUMENT_PHASE_BEGIN(COUNTING_PHASE);
+  for (i = 0; i < vectorLength; i++) {
+    segmentStarts[segmentVector[i] + 1]++;
+  }
+  for (s = 0; s < numSegments; s++) {
+    sums.lengths[s] = segmentStarts[s + 1];
+    segmentStarts[s + 1] += segmentStarts[s];
+  }
+  for (i = 0; i < vectorLength; i++) {
+    groupedStates[segmentStarts[segmentVector[i]]++] = firstVector[i] + numFirstStates * (secondVector == NULL ? 0 : secondVector[i]);
+  }
+  /* the scatter advanced each start to the next segment's start */
+  for (s = numSegments; s > 0; s--) {
+    segmentStarts[s] = segmentStarts[s - 1];
+  }
+  segmentStarts[0] = 0;
+  INSTRUMENT_PHASE_END();
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    int *jointCounts = (int *) checkedCalloc((size_t) numFirstStates * numSecondStates,sizeof(int));
+    int *firstCounts = (int *) checkedCalloc(numFirstStates,sizeof(int));
+    int *secondCounts = (int *) checkedCalloc(numSecondStates,sizeof(int));
+    double jointSum, firstSum, secondSum;
+    uint state;
+    int i, s, x, y;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic,4)
+#endif
+    for (s = 0; s < numSegments; s++) {
+      for (i = segmentStarts[s]; i < segmentStarts[s + 1]; i++) {
+        state = groupedStates[i];
+        jointCounts[state]++;
+        firstCounts[state % numFirstStates]++;
+        secondCounts[state / numFirstStates]++;
+      }
+      jointSum = 0.0;
+      firstSum = 0.0;
+      secondSum = 0.0;
+      for (i = segmentStarts[s]; i < segmentStarts[s + 1]; i++) {
+        state = groupedStates[i];
+        x = state % numFirstStates;
+        y = state / numFirstStates;
+        jointSum += countLogCount(jointCounts[state]);
+        firstSum += countLogCount(firstCounts[x]);
+        secondSum += countLogCount(secondCounts[y]);
+        jointCounts[state] = 0;
+        firstCounts[x] = 0;
+        secondCounts[y] = 0;
+      }
+      sums.jointSums[s] = jointSum;
+      sums.firstSums[s] = firstSum;
+      sums.secondSums[s] = secondSum;
+    }
+
+    FREE_FUNC(jointCounts);
+    FREE_FUNC(firstCounts);
+    FREE_FUNC(secondCounts);
+  }
+
+  FREE_FUNC(segmentStarts);
+  FREE_FUNC(groupedStates);
+  segmentStarts = NULL;
+  groupedStates = NULL;
+}/*groupedSegmentSums(uint *,uint *,uint *,int,int,int,int,SegmentSums)*/
+
+/*******************************************************************************
+** Calculates the \sum c \log c terms of the X, Y and XY histograms of each
+** segment. secondVector may be NULL, in which case Y has a single state.
+*******************************************************************************/
+static SegmentSums calculateSegmentSums(uint *firstVector, uint *secondVector, uint *segmentVector,
+                                        int vectorLength, int numSegments) {
+  SegmentSums sums;
+  int numFirstStates, numSecondStates;
+  double numCells;
+
+  INSTRUMENT_PHASE_BEGIN(MAX_STATE_PHASE);
+  numFirstStates = maxState(firstVector,vectorLength);
+  numSecondStates = secondVector == NULL ? 1 : maxState(secondVector,vectorLength);
+  INSTRUMENT_PHASE_END();
+  if (numFirstStates < 1) {
+    numFirstStates = 1;
+  }
+  if (numSecondStates < 1) {
+    numSecondStates = 1;
+  }
+
+  sums.jointSums = (double *) checkedCalloc(numSegments,sizeof(double));
+  sums.firstSums = (double *) checkedCalloc(numSegments,sizeof(double));
+  sums.secondSums = (double *) checkedCalloc(numSegments,sizeof(double));
+  sums.lengths = (double *) checkedCalloc(numSegments,sizeof(double));
+
+  numCells = (double) numFirstStates * numSecondStates * numSegments;
+  INSTRUMENT_CELLS(numCells);
+  if ((numCells <= MIN_DENSE_CELLS) || (numCells <= DENSE_CELLS_PER_SAMPLE * vectorLength)) {
+    denseSegmentSums(firstVector,secondVector,segmentVector,vectorLength,numFirstStates,numSecondStates,numSegments,sums);
+  } else {
+    groupedSegmentSums(firstVector,secondVector,segmentVector,vectorLength,numFirstStates,numSecondStates,numSegments,sums);
+  }
+
+  return sums;
+}/*calculateSegmentSums(uint *,uint *,uint *,int,int)*/
+
+static void freeSegmentSums(SegmentSums sums) {
+  FREE_FUNC(sums.jointSums);
+  FREE_FUNC(sums.firstSums);
+  FREE_FUNC(sums.secondSums);
+  FREE_FUNC(sums.lengths);
+}/*freeSegmentSums(SegmentSums)*/
+
+void calcSegmentedEntropy(uint *dataVector, uint *segmentVector, int vectorLength,
+                          int numSegments, double *outputVector) {
+  SegmentSums sums;
+  int s;
+
+  if (numSegments < 1) {
+    return;
+  }
+
+  INSTRUMENT_ENTER("calcSegmentedEntropy",vectorLength);
+  sums = calculateSegmentSums(dataVector,NULL,segmentVector,vectorLength,numSegments);
+
+  for (s = 0; s < numSegments; s++) {
+    outputVector[s] = entropyFromSums(sums.lengths[s],sums.jointSums[s]);
+  }
+
+  freeSegmentSums(sums);
+  INSTRUMENT_EXIT();
+}/*calcSegmentedEntropy(uint *,uint *,int,int,double *)*/
+
+void calcSegmentedMutualInformation(uint *dataVector, uint *targetVector, uint *segmentVector, int vectorLength,
+                                    int numSegments, double *outputVector) {
+  SegmentSums sums;
+  int s;
+
+  if (numSegments < 1) {
+    return;
+  }
+
+  INSTRUMENT_ENTER("calcSegmentedMutualInformation",vectorLength);
+  sums = calculateSegmentSums(dataVector,targetVector,segmentVector,vectorLength,numSegments);
+
+  for (s = 0; s < numSegments; s++) {
+    outputVector[s] = mutualInformationFromSums(sums.lengths[s],sums.jointSums[s],sums.firstSums[s],sums.secondSums[s]);
+  }
+
+  freeSegmentSums(sums);
+  INSTRUMENT_EXIT();
+}/*calcSegmentedMutualInformation(uint *,uint *,uint *,int,int,double *)*/
+
+void calcSegmentedConditionalEntropy(uint *dataVector, uint *conditionVector, uint *segmentVector, int vectorLength,
+                                     int numSegments, double *outputVector) {
+  SegmentSums sums;
+  int s;
+
+  if (numSegments < 1) {
+    return;
+  }
+
+  INSTRUMENT_ENTER("calcSegmentedConditionalEntropy",vectorLength);
+  sums = calculateSegmentSums(dataVector,conditionVector,segmentVector,vectorLength,numSegments);
+
+  for (s = 0; s < numSegments; s++) {
+    outputVector[s] = conditionalEntropyFromSums(sums.lengths[s],sums.jointSums[s],sums.secondSums[s]);
+  }
+
+  freeSegmentSums(sums);
+  INSTRUMENT_EXIT();
+}/*calcSegmentedConditionalEntropy(uint *,uint *,uint *,int,int,double *)*/
@@ -0,0 +1,275 @@
+/*******************************************************************************
+** SparseMatrix.c
+** Part of the mutual information toolbox
+**
+** Contains a compressed sparse column (CSC) matrix of discrete features, and
+** functions to calculate the mutual information of sparse features with a
+** dense target, and between pairs of sparse features. State 0 is implicit,
+** so the cost is proportional to the number of non-zeros rather than the
+** number of samples.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/SparseMatrix.h"
+#include "CountSums.h"
+
+static int sparseColumnStates(SparseMatrix matrix, int column) {
+  return maxState(matrix.values + matrix.columnPointers[column],matrix.columnPointers[column+1] - matrix.columnPointers[column]);
+}
+
+SparseMatrix compressSparseMatrix(uint *featureMatrix, int numRows, int numColumns) {
+  SparseMatrix matrix;
+  size_t i, numNonZeros = 0;
+  int row, column, index;
+
+  for (i = 0; i < (size_t) numRows * numColumns; i++) {
+    if (featureMatrix[i] != 0) {
+      numNonZeros++;
+    }
+  }
+
+  matrix.numRows = numRows;
+  matrix.numColumns = numColumns;
+  matrix.values = (uint *) checkedCalloc(numNonZeros + 1,sizeof(uint));
+  matrix.rowIndices = (int *) checkedCalloc(numNonZeros + 1,sizeof(int));
+  matrix.columnPointers = (int *) checkedCalloc(numColumns + 1,sizeof(int));
+
+  index = 0;
+  for (column = 0; column < numColumns; column++) {
+    matrix.columnPointers[column] = index;
+    for (row = 0; row < numRows; row++) {
+      if (featureMatrix[(size_t) column * numRows + row] != 0) {
+        matrix.values[index] = featureMatrix[(size_t) column * numRows + row];
+        matrix.rowIndices[index] = row;
+        index++;
+      }
+    }
+  }
+  matrix.columnPointers[numColumns] = index;
+
+  return matrix;
+}/*compressSparseMatrix(uint *,int,int)*/
+
+/*******************************************************************************
+** Calculates I(X;Y) for a sparse column against a dense target using the
+** precomputed target counts. jointCounts and firstCounts are scratch space
+** of at least numFirstStates * numTargetStates and numFirstStates elements.
+**
+** Only the non-zero rows are counted, the counts for state 0 are the target
+** marginal minus the non-zero counts.
+*******************************************************************************/
+static double sparseTargetMI(SparseMatrix matrix, int column, uint *targetVector, uint *targetCounts, int numTargetStates, double targetSum, uint *jointCounts, uint *firstCounts) {
+  int start = matrix.columnPointers[column];
+  int end = matrix.columnPointers[column+1];
+  int numFirstStates = sparseColumnStates(matrix,column);
+  int i, y;
+  uint value;
+  double jointSum, firstSum;
+
+  memset(jointCounts,0,(size_t) numFirstStates * numTargetStates * sizeof(uint));
+  memset(firstCounts,0,numFirstStates * sizeof(uint));
+
+  for (i = start; i < end; i++) {
+    value = matrix.values[i];
+    jointCounts[value + numFirstStates * targetVector[matrix.rowIndices[i]]] += 1;
+    firstCounts[value] += 1;
+  }
+
+  firstCounts[0] = matrix.numRows - (end - start);
+  for (y = 0; y < numTargetStates; y++) {
+    jointCounts[numFirstStates * y] = targetCounts[y];
+    for (i = 1; i < numFirstStates; i++) {
+      jointCounts[numFirstStates * y] -= jointCounts[i + numFirstStates * y];
+    }
+  }
+
+  jointSum = sumUintCountLogCount(jointCounts,numFirstStates * numTargetStates);
+  firstSum = sumUintCountLogCount(firstCounts,numFirstStates);
+
+  return mutualInformationFromSums(matrix.numRows,jointSum,firstSum,targetSum);
+}/*sparseTargetMI(SparseMatrix,int,uint *,uint *,int,double,uint *,uint *)*/
+
+double calcSparseMutualInformation(SparseMatrix matrix, int column, uint *targetVector) {
+  double mutualInformation;
+  double targetSum;
+  uint *targetCounts, *jointCounts, *firstCounts;
+  int numTargetStates = maxState(targetVector,matrix.numRows);
+  int numFirstStates = sparseColumnStates(matrix,column);
+  int i;
+
+  targetCounts = (uint *) checkedCalloc(numTargetStates,sizeof(uint));
+  jointCounts = (uint *) checkedCalloc((size_t) numFirstStates * numTargetStates,sizeof(uint));
+  firstCounts = (uint *) checkedCalloc(numFirstStates,sizeof(uint));
+
+  for (i = 0; i < matrix.numRows; i++) {
+    targetCounts[targetVector[i]] += 1;
+  }
+  targetSum = sumUintCountLogCount(targetCounts,numTargetStates);
+
+  mutualInformation = sparseTargetMI(matrix,column,targetVector,targetCounts,numTargetStates,targetSum,jointCounts,firstCounts);
+
+  FREE_FUNC(targetCounts);
+  FREE_FUNC(jointCounts);
+  FREE_FUNC(firstCounts);
+  targetCounts = NULL;
+  jointCounts = NULL;
+  firstCounts = NULL;
+
+  return mutualInformation;
+}/*calcSparseMutualInformation(SparseMatrix,int,uint *)*/
+
+void calcSparseMutualInformationTarget(SparseMatrix matrix, uint *targetVector, double *outputVector) {
+  double targetSum;
+  uint *targetCounts;
+  int numTargetStates = maxState(targetVector,matrix.numRows);
+  int maxFirstStates = maxState(matrix.values,matrix.columnPointers[matrix.numColumns]);
+  int i;
+
+  targetCounts = (uint *) checkedCalloc(numTargetStates,sizeof(uint));
+  for (i = 0; i < matrix.numRows; i++) {
+    targetCounts[targetVector[i]] += 1;
+  }
+  targetSum = sumUintCountLogCount(targetCounts,numTargetStates);
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    uint *jointCounts = (uint *) checkedCalloc((size_t) maxFirstStates * numTargetStates,sizeof(uint));
+    uint *firstCounts = (uint *) checkedCalloc(maxFirstStates,sizeof(uint));
+    int j;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic,16)
+#endif
+    for (j = 0; j < matrix.numColumns; j++) {
+      outputVector[j] = sparseTargetMI(matrix,j,targetVector,targetCounts,numTargetStates,targetSum,jointCounts,firstCounts);
+    }
+
+    FREE_FUNC(jointCounts);
+    FREE_FUNC(firstCounts);
+  }
+
+  FREE_FUNC(targetCounts);
+  targetCounts = NULL;
+}/*calcSparseMutualInformationTarget(SparseMatrix,uint *,double *)*/
+
+/*******************************************************************************
+** Calculates I(X_i;X_j) by merging the two sorted row lists. Rows present in
+** neither column are the (0,0) state. jointCounts, firstCounts and
+** secondCounts are scratch space large enough for the two columns.
+*******************************************************************************/
+static double sparsePairMI(SparseMatrix matrix, int firstColumn, int secondColumn, uint *jointCounts, uint *firstCounts, uint *secondCounts) {
+  int firstIndex = matrix.columnPointers[firstColumn];
+  int firstEnd = matrix.columnPointers[firstColumn+1];
+  int secondIndex = matrix.columnPointers[secondColumn];
+  int secondEnd = matrix.columnPointers[secondColumn+1];
+  int numFirstStates = sparseColumnStates(matrix,firstColumn);
+  int numSecondStates = sparseColumnStates(matrix,secondColumn);
+  int numUnion = 0;
+  int firstRow, secondRow;
+  double jointSum, firstSum, secondSum;
+
+  memset(jointCounts,0,(size_t) numFirstStates * numSecondStates * sizeof(uint));
+  memset(firstCounts,0,numFirstStates * sizeof(uint));
+  memset(secondCounts,0,numSecondStates * sizeof(uint));
+
+  while ((firstIndex < firstEnd) || (secondIndex < secondEnd)) {
+    firstRow = firstIndex < firstEnd ? matrix.rowIndices[firstIndex] : matrix.numRows;
+    secondRow = secondIndex < secondEnd ? matrix.rowIndices[secondIndex] : matrix.numRows;
+    if (firstRow == secondRow) {
+      jointCounts[matrix.values[firstIndex] + numFirstStates * matrix.values[secondIndex]] += 1;
+      firstCounts[matrix.values[firstIndex]] += 1;
+      secondCounts[matrix.values[secondIndex]] += 1;
+      firstIndex++;
+      secondIndex++;
+    } else if (firstRow < secondRow) {
+      jointCounts[matrix.values[firstIndex]] += 1;
+      firstCounts[matrix.values[firstIndex]] += 1;
+      firstIndex++;
+    } else {
+      jointCounts[numFirstStates * matrix.values[secondIndex]] += 1;
+      secondCounts[matrix.values[secondIndex]] += 1;
+      secondIndex++;
+    }
+    numUnion++;
+  }
+
+  jointCounts[0] = matrix.numRows - numUnion;
+  firstCounts[0] = matrix.numRows - (firstEnd - matrix.columnPointers[firstColumn]);
+  secondCounts[0] = matrix.numRows - (secondEnd - matrix.columnPointers[secondColumn]);
+
+  jointSum = sumUintCountLogCount(jointCounts,numFirstStates * numSecondStates);
+  firstSum = sumUintCountLogCount(firstCounts,numFirstStates);
+  secondSum = sumUintCountLogCount(secondCounts,numSecondStates);
+
+  return mutualInformationFromSums(matrix.numRows,jointSum,firstSum,secondSum);
+}/*sparsePairMI(SparseMatrix,int,int,uint *,uint *,uint *)*/
+
+double calcSparsePairwiseMutualInformation(SparseMatrix matrix, int firstColumn, int secondColumn) {
+  double mutualInformation;
+  int numFirstStates = sparseColumnStates(matrix,firstColumn);
+  int numSecondStates = sparseColumnStates(matrix,secondColumn);
+  uint *jointCounts = (uint *) checkedCalloc((size_t) numFirstStates * numSecondStates,sizeof(uint));
+  uint *firstCounts = (uint *) checkedCalloc(numFirstStates,sizeof(uint));
+  uint *secondCounts = (uint *) checkedCalloc(numSecondStates,sizeof(uint));
+
+  mutualInformation = sparsePairMI(matrix,firstColumn,secondColumn,jointCounts,firstCounts,secondCounts);
+
+  FREE_FUNC(jointCounts);
+  FREE_FUNC(firstCounts);
+  FREE_FUNC(secondCounts);
+  jointCounts = NULL;
+  firstCounts = NULL;
+  secondCounts = NULL;
+
+  return mutualInformation;
+}/*calcSparsePairwiseMutualInformation(SparseMatrix,int,int)*/
+
+void calcSparsePairwiseMutualInformationMatrix(SparseMatrix matrix, double *outputMatrix) {
+  int maxStates = maxState(matrix.values,matrix.columnPointers[matrix.numColumns]);
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    uint *jointCounts = (uint *) checkedCalloc((size_t) maxStates * maxStates,sizeof(uint));
+    uint *firstCounts = (uint *) checkedCalloc(maxStates,sizeof(uint));
+    uint *secondCounts = (uint *) checkedCalloc(maxStates,sizeof(uint));
+    int i, j;
+    double value;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic,1)
+#endif
+    for (i = 0; i < matrix.numColumns; i++) {
+      for (j = i; j < matrix.numColumns; j++) {
+        value = sparsePairMI(matrix,i,j,jointCounts,firstCounts,secondCounts);
+        outputMatrix[(size_t) i * matrix.numColumns + j] = value;
+        outputMatrix[(size_t) j * matrix.numColumns + i] = value;
+      }
+    }
+
+    FREE_FUNC(jointCounts);
+    FREE_FUNC(firstCounts);
+    FREE_FUNC(secondCounts);
+  }
+}/*calcSparsePairwiseMutualInformationMatrix(SparseMatrix,double *)*/
+
+void freeSparseMatrix(SparseMatrix matrix) {
+  FREE_FUNC(matrix.values);
+  matrix.values = NULL;
+  FREE_FUNC(matrix.rowIndices);
+  matrix.rowIndices = NULL;
+  FREE_FUNC(matrix.columnPointers);
+  matrix.columnPointers = NULL;
+}
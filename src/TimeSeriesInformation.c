@@ -0,0 +1,176 @@
+/*******************************************************************************
+** TimeSeriesInformation.c
+** Part of the mutual information toolbox
+**
+** Contains functions to calculate the time lagged mutual information
+** I(X_{t-l};Y_t) and the transfer entropy from X to Y of two time series.
+** The lagged variables are read at an offset into the series rather than
+** copied, and a sweep over many lags counts every lag's histogram in one
+** blocked pass over the series, in parallel across lags when compiled with
+** OpenMP.
+**
+** Author: Adam Pocock
+** Created 18/10/2026
+**
+** Copyright 2010-2026 Adam Pocock, The University Of Manchester
+** www.cs.manchester.ac.uk
+**
+** This file is part of MIToolbox, licensed under the 3-clause BSD license.
+*******************************************************************************/
+
+#include "MIToolbox/MIToolbox.h"
+#include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/Instrumentation.h"
+#include "MIToolbox/MutualInformation.h"
+#include "MIToolbox/TimeSeriesInformation.h"
+#include "CountSums.h"
+
+/* The sweep gives each task LAG_BLOCK lags, and streams the series in
+** blocks of SAMPLE_BLOCK times */
+#define LAG_BLOCK 8
+#define SAMPLE_BLOCK 4096
+
+/*******************************************************************************
+** The pairs (X_{t-lag},Y_t) are the first vectorLength - lag values of X
+** against Y from time lag.
+*******************************************************************************/
+double calcLaggedMutualInformation(uint *sourceVector, uint *targetVector, int vectorLength, int lag) {
+  double mutualInformation;
+
+  if ((lag < 0) || (lag >= vectorLength)) {
+    return 0.0;
+  }
+
+  INSTRUMENT_ENTER("calcLaggedMutualInformation",vectorLength);
+  mutualInformation = calcMutualInformation(sourceVector,targetVector + lag,vectorLength - lag);
+  INSTRUMENT_EXIT();
+
+  return mutualInformation;
+}/*calcLaggedMutualInformation(uint *,uint *,int,int)*/
+
+/*******************************************************************************
+** The histogram of lag l is stored at
+** jointCounts[x + numSourceStates*(y + numTargetStates*(l - firstLag))]
+** within each task. A block of the target series, and the window of the
+** source series its lags read, stay in cache while every lag of the task is
+** updated from them.
+*******************************************************************************/
+void calcLaggedMutualInformationSweep(uint *sourceVector, uint *targetVector, int vectorLength, int maxLag,
+                                      double *outputVector) {
+  int numSourceStates, numTargetStates, numJointStates, numLagBlocks;
+
+  if (maxLag < 1) {
+    return;
+  }
+
+  INSTRUMENT_ENTER("calcLaggedMutualInformationSweep",vectorLength);
+  INSTRUMENT_PHASE_BEGIN(MAX_STATE_PHASE);
+  numSourceStates = maxState(sourceVector,vectorLength);
+  numTargetStates = maxState(targetVector,vectorLength);
+  INSTRUMENT_PHASE_END();
+  if (numSourceStates < 1) {
+    numSourceStates = 1;
+  }
+  if (numTargetStates < 1) {
+    numTargetStates = 1;
+  }
+  numJointStates = numSourceStates * numTargetStates;
+  numLagBlocks = (maxLag + LAG_BLOCK - 1) / LAG_BLOCK;
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    int *jointCounts = (int *) checkedCalloc((size_t) numJointStates * LAG_BLOCK,sizeof(int));
+    int *sourceCounts = (int *) checkedCalloc(numSourceStates,sizeof(int));
+    int *targetCounts = (int *) checkedCalloc(numTargetStates,sizeof(int));
+    int *table;
+    double jointSum, sourceSum, targetSum, length;
+    int task, firstLag, lastLag, lag, blockStart, blockEnd, t, x, y;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic,1)
+#endif
+    for (task = 0; task < numLagBlocks; task++) {
+      firstLag = task * LAG_BLOCK + 1;
+      lastLag = firstLag + LAG_BLOCK - 1 < maxLag ? firstLag + LAG_BLOCK - 1 : maxLag;
+      memset(jointCounts,0,(size_t) numJointStates * LAG_BLOCK * sizeof(int));
+
+      for (blockStart = firstLag; blockStart < vectorLength; blockStart += SAMPLE_BLOCK) {
+        blockEnd = blockStart + SAMPLE_BLOCK < vectorLength ? blockStart + SAMPLE_BLOCK : vectorLength;
+        for (lag = firstLag; lag <= lastLag; lag++) {
+          table = jointCounts + (size_t) numJointStates * (lag - firstLag);
+          for (t = blockStart > lag ? blockStart : lag; t < blockEnd; t++) {
+            table[sourceVector[t - lag] + numSourceStates * targetVector[t]]++;
+          }
+        }
+      }
+
+      for (lag = firstLag; lag <= lastLag; lag++) {
+        length = vectorLength - lag;
+        if (length <= 0) {
+          outputVector[lag - 1] = 0.0;
+          continue;
+        }
+        /* the marginals are summed out of the lag's histogram */
+        table = jointCounts + (size_t) numJointStates * (lag - firstLag);
+        memset(sourceCounts,0,numSourceStates * sizeof(int));
+        memset(targetCounts,0,numTargetStates * sizeof(int));
+        jointSum = 0.0;
+        for (y = 0; y < numTargetStates; y++) {
+          for (x = 0; x < numSourceStates; x++) {
+            jointSum += countLogCount(table[x + numSourceStates * y]);
+            sourceCounts[x] += table[x + numSourceStates * y];
+            targetCounts[y] += table[x + numSourceStates * y];
+          }
+        }
+        sourceSum = sumCountLogCount(sourceCounts,numSourceStates);
+        targetSum = sumCountLogCount(targetCounts,numTargetStates);
+
+        outputVector[lag - 1] = mutualInformationFromSums(length,jointSum,sourceSum,targetSum);
+      }
+    }
+
+    FREE_FUNC(jointCounts);
+    FREE_FUNC(sourceCounts);
+    FREE_FUNC(targetCounts);
+  }
+
+  INSTRUMENT_EXIT();
+}/*calcLaggedMutualInformationSweep(uint *,uint *,int,int,double *)*/
+
+/*******************************************************************************
+** Time t is sample t - start, where start is the first time with a full
+** history. The history state is built by merging Y_{t-1} with each older
+** value in turn, reading Y at an offset for each.
+*******************************************************************************/
+double calcTransferEntropy(uint *sourceVector, uint *targetVector, int vectorLength, int sourceLag, int historyLength) {
+  double transferEntropy;
+  uint *historyVector;
+  int start, numTimes, j;
+
+  if ((sourceLag < 1) || (historyLength < 1)) {
+    return 0.0;
+  }
+  start = sourceLag > historyLength ? sourceLag : historyLength;
+  if (start >= vectorLength) {
+    return 0.0;
+  }
+  numTimes = vectorLength - start;
+
+  INSTRUMENT_ENTER("calcTransferEntropy",vectorLength);
+  historyVector = (uint *) checkedCalloc(numTimes,sizeof(uint));
+  memcpy(historyVector,targetVector + start - 1,numTimes * sizeof(uint));
+  for (j = 2; j <= historyLength; j++) {
+    compactMergeArrays(historyVector,targetVector + start - j,historyVector,numTimes);
+  }
+
+  transferEntropy = calcConditionalMutualInformation(targetVector + start,sourceVector + start - sourceLag,
+                                                     historyVector,numTimes);
+
+  FREE_FUNC(historyVector);
+  historyVector = NULL;
+  INSTRUMENT_EXIT();
+
+  return transferEntropy;
+}/*calcTransferEntropy(uint *,uint *,int,int,int)*/
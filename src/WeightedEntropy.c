@@ -18,19 +18,16 @@
 #include "MIToolbox/MIToolbox.h"
 #include "MIToolbox/CalculateProbability.h"
 #include "MIToolbox/WeightedEntropy.h"
+#include "MIToolbox/Instrumentation.h"
+#include "MIToolbox/Kernels.h"
 
 double wEntropy(WeightedProbState state) {
   double entropy = 0.0;
-  double tempValue = 0.0;
-  int i;
   
   /*H_w(X) = - \sum_x w(x)p(x) \log p(x)*/
-  for (i = 0; i < state.numStates; i++) {
-    tempValue = state.probabilityVector[i];
-    if (tempValue > 0) {
-      entropy -= state.stateWeightVector[i] * tempValue * log(tempValue);
-    }
-  }
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  entropy = activeKernels->weightedEntropySum(state.probabilityVector,state.stateWeightVector,state.numStates);
+  INSTRUMENT_PHASE_END();
   
   entropy /= log(LOG_BASE);
 
@@ -38,35 +35,40 @@ double wEntropy(WeightedProbState state) {
 }
 
 double calcWeightedEntropy(uint *dataVector, double *weightVector, int vectorLength) {
-  WeightedProbState state = calculateWeightedProbability(dataVector,weightVector,vectorLength);
-  double entropy = wEntropy(state);
-  
+  WeightedProbState state;
+  double entropy;
+
+  INSTRUMENT_ENTER("calcWeightedEntropy",vectorLength);
+  state = calculateWeightedProbability(dataVector,weightVector,vectorLength);
+  entropy = wEntropy(state);
+
   freeWeightedProbState(state);
-  
+  INSTRUMENT_EXIT();
+
   return entropy;
 }/*calcWeightedEntropy(uint *,double *,int)*/
 
 double discAndCalcWeightedEntropy(double *dataVector, double *weightVector, int vectorLength) {
-  WeightedProbState state = discAndCalcWeightedProbability(dataVector,weightVector,vectorLength);
-  double entropy = wEntropy(state);
-  
+  WeightedProbState state;
+  double entropy;
+
+  INSTRUMENT_ENTER("discAndCalcWeightedEntropy",vectorLength);
+  state = discAndCalcWeightedProbability(dataVector,weightVector,vectorLength);
+  entropy = wEntropy(state);
+
   freeWeightedProbState(state);
-  
+  INSTRUMENT_EXIT();
+
   return entropy;
 }/*discAndCalcWeightedEntropy(double *,double *,int)*/
 
 double wJointEntropy(WeightedJointProbState state) {
   double jointEntropy = 0.0;  
-  double tempValue = 0.0;
-  int i;
 
   /*H_w(X,Y) = - \sum_x \sum_y w(x,y) p(x,y) \log p(x,y)*/
-  for (i = 0; i < state.numJointStates; i++) {
-    tempValue = state.jointProbabilityVector[i];
-    if (tempValue > 0) {
-      jointEntropy -= state.jointWeightVector[i] * tempValue * log(tempValue);
-    }
-  }
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  jointEntropy = activeKernels->weightedEntropySum(state.jointProbabilityVector,state.jointWeightVector,state.numJointStates);
+  INSTRUMENT_PHASE_END();
   
   jointEntropy /= log(LOG_BASE);
 
@@ -74,40 +76,41 @@ double wJointEntropy(WeightedJointProbState state) {
 }
 
 double calcWeightedJointEntropy(uint *firstVector, uint *secondVector, double *weightVector, int vectorLength) {
-  WeightedJointProbState state = calculateWeightedJointProbability(firstVector,secondVector,weightVector,vectorLength);
-  double jointEntropy = wJointEntropy(state);
-  
+  WeightedJointProbState state;
+  double jointEntropy;
+
+  INSTRUMENT_ENTER("calcWeightedJointEntropy",vectorLength);
+  state = calculateWeightedJointProbability(firstVector,secondVector,weightVector,vectorLength);
+  jointEntropy = wJointEntropy(state);
+
   freeWeightedJointProbState(state);
-  
+  INSTRUMENT_EXIT();
+
   return jointEntropy;
 }/*calcWeightedJointEntropy(uint *,uint *,double *,int)*/
 
 double discAndCalcWeightedJointEntropy(double *firstVector, double *secondVector, double *weightVector, int vectorLength) {
-  WeightedJointProbState state = discAndCalcWeightedJointProbability(firstVector,secondVector,weightVector,vectorLength);
-  double jointEntropy = wJointEntropy(state);
-  
+  WeightedJointProbState state;
+  double jointEntropy;
+
+  INSTRUMENT_ENTER("discAndCalcWeightedJointEntropy",vectorLength);
+  state = discAndCalcWeightedJointProbability(firstVector,secondVector,weightVector,vectorLength);
+  jointEntropy = wJointEntropy(state);
+
   freeWeightedJointProbState(state);
-  
+  INSTRUMENT_EXIT();
+
   return jointEntropy;
 }/*discAndCalcWeightedJointEntropy(double *,double *,double *,int)*/
 
 double wCondEntropy(WeightedJointProbState state) {
   double condEntropy = 0.0;  
-  double jointValue = 0.0;
-  double condValue = 0.0;
-  int i;
   
   /*H_w(X|Y) = - \sum_x \sum_y w(x,y)p(x,y) \log (p(x,y)/p(y))*/
-  /* to index by numFirstStates use modulus of i
-  ** to index by numSecondStates use integer division of i by numFirstStates
-  */
-  for (i = 0; i < state.numJointStates; i++) {
-    jointValue = state.jointProbabilityVector[i];
-    condValue = state.secondProbabilityVector[i / state.numFirstStates];
-    if ((jointValue > 0) && (condValue > 0)) {
-      condEntropy -= state.jointWeightVector[i] * jointValue * log(jointValue / condValue);
-    }
-  }
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  condEntropy = activeKernels->weightedCondEntropySum(state.jointProbabilityVector,state.jointWeightVector,
+                                                      state.secondProbabilityVector,state.numFirstStates,state.numJointStates);
+  INSTRUMENT_PHASE_END();
   
   condEntropy /= log(LOG_BASE);
   
@@ -115,19 +118,89 @@ double wCondEntropy(WeightedJointProbState state) {
 }
 
 double calcWeightedConditionalEntropy(uint *dataVector, uint *conditionVector, double *weightVector, int vectorLength) {
-  WeightedJointProbState state = calculateWeightedJointProbability(dataVector,conditionVector,weightVector,vectorLength);
-  double condEntropy = wCondEntropy(state);
-  
+  WeightedJointProbState state;
+  double condEntropy;
+
+  INSTRUMENT_ENTER("calcWeightedConditionalEntropy",vectorLength);
+  state = calculateWeightedJointProbability(dataVector,conditionVector,weightVector,vectorLength);
+  condEntropy = wCondEntropy(state);
+
   freeWeightedJointProbState(state);
-  
+  INSTRUMENT_EXIT();
+
   return condEntropy;
 }/*calcWeightedConditionalEntropy(uint *,uint *,double *,int)*/
 
 double discAndCalcWeightedConditionalEntropy(double *dataVector, double *conditionVector, double *weightVector, int vectorLength) {
-  WeightedJointProbState state = discAndCalcWeightedJointProbability(dataVector,conditionVector,weightVector,vectorLength);
-  double condEntropy = wCondEntropy(state);
-  
+  WeightedJointProbState state;
+  double condEntropy;
+
+  INSTRUMENT_ENTER("discAndCalcWeightedConditionalEntropy",vectorLength);
+  state = discAndCalcWeightedJointProbability(dataVector,conditionVector,weightVector,vectorLength);
+  condEntropy = wCondEntropy(state);
+
   freeWeightedJointProbState(state);
-  
+  INSTRUMENT_EXIT();
+
   return condEntropy;
 }/*discAndCalcWeightedConditionalEntropy(double *,double *,double *,int)*/
+
+double workspaceWEntropy(WeightedWorkspace workspace) {
+  double entropy, totalWeight;
+
+  if (workspace.length == 0) {
+    return 0.0;
+  }
+
+  /*H_w(X) = 1/n (\sum_x W(x) \log n - \sum_x W(x) \log c(x)), where W(x) is the weight sum*/
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  entropy = -sumWeightLogCount(workspace.firstStates,workspace.numFirstStates,&totalWeight);
+  entropy += totalWeight * log(workspace.length);
+  INSTRUMENT_PHASE_END();
+
+  entropy /= workspace.length;
+  entropy /= log(LOG_BASE);
+
+  return entropy;
+}/*workspaceWEntropy(WeightedWorkspace)*/
+
+double calcWorkspaceWeightedEntropy(WeightedWorkspace *workspace, uint *dataVector, double *weightVector, int vectorLength) {
+  double entropy;
+
+  INSTRUMENT_ENTER("calcWorkspaceWeightedEntropy",vectorLength);
+  calculateWeightedWorkspace(workspace,dataVector,NULL,weightVector,vectorLength);
+  entropy = workspaceWEntropy(*workspace);
+  INSTRUMENT_EXIT();
+
+  return entropy;
+}/*calcWorkspaceWeightedEntropy(WeightedWorkspace *,uint *,double *,int)*/
+
+double workspaceWCondEntropy(WeightedWorkspace workspace) {
+  double condEntropy;
+
+  if (workspace.length == 0) {
+    return 0.0;
+  }
+
+  /*H_w(X|Y) = 1/n (\sum_y W(y) \log c(y) - \sum_x \sum_y W(x,y) \log c(x,y))*/
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  condEntropy = sumWeightLogCount(workspace.secondStates,workspace.numSecondStates,NULL);
+  condEntropy -= sumWeightLogCount(workspace.jointStates,workspace.numJointStates,NULL);
+  INSTRUMENT_PHASE_END();
+
+  condEntropy /= workspace.length;
+  condEntropy /= log(LOG_BASE);
+
+  return condEntropy;
+}/*workspaceWCondEntropy(WeightedWorkspace)*/
+
+double calcWorkspaceWeightedConditionalEntropy(WeightedWorkspace *workspace, uint *dataVector, uint *conditionVector, double *weightVector, int vectorLength) {
+  double condEntropy;
+
+  INSTRUMENT_ENTER("calcWorkspaceWeightedConditionalEntropy",vectorLength);
+  calculateWeightedWorkspace(workspace,dataVector,conditionVector,weightVector,vectorLength);
+  condEntropy = workspaceWCondEntropy(*workspace);
+  INSTRUMENT_EXIT();
+
+  return condEntropy;
+}/*calcWorkspaceWeightedConditionalEntropy(WeightedWorkspace *,uint *,uint *,double *,int)*/
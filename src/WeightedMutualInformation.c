@@ -22,23 +22,20 @@
 #include "MIToolbox/CalculateProbability.h"
 #include "MIToolbox/WeightedEntropy.h"
 #include "MIToolbox/WeightedMutualInformation.h"
+#include "MIToolbox/Instrumentation.h"
+#include "MIToolbox/Kernels.h"
 
 double wmi(WeightedJointProbState state) {
   double mutualInformation = 0.0;
-  int firstIndex,secondIndex;
-  int i;
   
   /*
   ** I_w(X;Y) = \sum_x \sum_y w(x,y)p(x,y) * \log (p(x,y)/p(x)p(y))
   */
-  for (i = 0; i < state.numJointStates; i++) {
-    firstIndex = i % state.numFirstStates;
-    secondIndex = i / state.numFirstStates;
-    
-    if ((state.jointProbabilityVector[i] > 0) && (state.firstProbabilityVector[firstIndex] > 0) && (state.secondProbabilityVector[secondIndex] > 0)) {
-      mutualInformation += state.jointWeightVector[i] * state.jointProbabilityVector[i] * log(state.jointProbabilityVector[i] / state.firstProbabilityVector[firstIndex] / state.secondProbabilityVector[secondIndex]);
-    }
-  }
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  mutualInformation = activeKernels->weightedMISum(state.jointProbabilityVector,state.jointWeightVector,
+                                                   state.firstProbabilityVector,state.secondProbabilityVector,
+                                                   state.numFirstStates,state.numJointStates);
+  INSTRUMENT_PHASE_END();
   
   mutualInformation /= log(LOG_BASE);
 
@@ -46,27 +43,40 @@ double wmi(WeightedJointProbState state) {
 }
 
 double calcWeightedMutualInformation(uint *dataVector, uint *targetVector, double *weightVector, int vectorLength) {
-  WeightedJointProbState state = calculateWeightedJointProbability(dataVector,targetVector,weightVector,vectorLength);
-  double mutualInformation = wmi(state);
-    
+  WeightedJointProbState state;
+  double mutualInformation;
+
+  INSTRUMENT_ENTER("calcWeightedMutualInformation",vectorLength);
+  state = calculateWeightedJointProbability(dataVector,targetVector,weightVector,vectorLength);
+  mutualInformation = wmi(state);
+
   freeWeightedJointProbState(state);
-  
+  INSTRUMENT_EXIT();
+
   return mutualInformation;
 }/*calcWeightedMutualInformation(uint *,uint *,double *,int)*/
 
 double discAndCalcWeightedMutualInformation(double *dataVector, double *targetVector, double *weightVector, int vectorLength) {
-  WeightedJointProbState state = discAndCalcWeightedJointProbability(dataVector,targetVector,weightVector,vectorLength);
-  double mutualInformation = wmi(state);
-    
+  WeightedJointProbState state;
+  double mutualInformation;
+
+  INSTRUMENT_ENTER("discAndCalcWeightedMutualInformation",vectorLength);
+  state = discAndCalcWeightedJointProbability(dataVector,targetVector,weightVector,vectorLength);
+  mutualInformation = wmi(state);
+
   freeWeightedJointProbState(state);
-  
+  INSTRUMENT_EXIT();
+
   return mutualInformation;
 }/*discAndCalcWeightedMutualInformation(double *,double *,double *,int)*/
 
 double calcWeightedConditionalMutualInformation(uint *dataVector, uint *targetVector, uint *conditionVector, double *weightVector, int vectorLength) {
   double mutualInformation = 0.0;
   double firstCondition, secondCondition;
-  uint *mergedVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
+  uint *mergedVector;
+
+  INSTRUMENT_ENTER("calcWeightedConditionalMutualInformation",vectorLength);
+  mergedVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
   
   mergeArrays(targetVector,conditionVector,mergedVector,vectorLength);
   
@@ -79,17 +89,24 @@ double calcWeightedConditionalMutualInformation(uint *dataVector, uint *targetVe
   
   FREE_FUNC(mergedVector);
   mergedVector = NULL;
-  
+  INSTRUMENT_EXIT();
+
   return mutualInformation;
 }/*calcWeightedConditionalMutualInformation(double *,double *,double *,double *,int)*/
 
 double discAndCalcWeightedConditionalMutualInformation(double *dataVector, double *targetVector, double *conditionVector, double *weightVector, int vectorLength) {
   double mutualInformation = 0.0;
   double firstCondition, secondCondition;
-  uint *dataNormVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
-  uint *targetNormVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
-  uint *conditionNormVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
-  uint *mergedVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
+  uint *dataNormVector;
+  uint *targetNormVector;
+  uint *conditionNormVector;
+  uint *mergedVector;
+
+  INSTRUMENT_ENTER("discAndCalcWeightedConditionalMutualInformation",vectorLength);
+  dataNormVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
+  targetNormVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
+  conditionNormVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
+  mergedVector = (uint *) checkedCalloc(vectorLength,sizeof(uint));
   
   normaliseArray(dataVector,dataNormVector,vectorLength);
   normaliseArray(targetVector,targetNormVector,vectorLength);
@@ -111,6 +128,161 @@ double discAndCalcWeightedConditionalMutualInformation(double *dataVector, doubl
   targetNormVector = NULL;
   conditionNormVector = NULL;
   mergedVector = NULL;
-  
+  INSTRUMENT_EXIT();
+
   return mutualInformation;
 }/*discAndCalcWeightedConditionalMutualInformation(double *,double *,double *,double *,int)*/
+
+double workspaceWMI(WeightedWorkspace workspace) {
+  double mutualInformation, totalWeight;
+
+  if (workspace.length == 0) {
+    return 0.0;
+  }
+
+  /*
+  ** I_w(X;Y) = 1/n (\sum_x \sum_y W(x,y) \log c(x,y) - \sum_x W(x) \log c(x)
+  **                 - \sum_y W(y) \log c(y) + \sum_x \sum_y W(x,y) \log n)
+  ** where W is the weight sum of each state
+  */
+  INSTRUMENT_PHASE_BEGIN(LOG_PHASE);
+  mutualInformation = sumWeightLogCount(workspace.jointStates,workspace.numJointStates,&totalWeight);
+  mutualInformation -= sumWeightLogCount(workspace.firstStates,workspace.numFirstStates,NULL);
+  mutualInformation -= sumWeightLogCount(workspace.secondStates,workspace.numSecondStates,NULL);
+  mutualInformation += totalWeight * log(workspace.length);
+  INSTRUMENT_PHASE_END();
+
+  mutualInformation /= workspace.length;
+  mutualInformation /= log(LOG_BASE);
+
+  return mutualInformation;
+}/*workspaceWMI(WeightedWorkspace)*/
+
+double calcWorkspaceWeightedMutualInformation(WeightedWorkspace *workspace, uint *dataVector, uint *targetVector, double *weightVector, int vectorLength) {
+  double mutualInformation;
+
+  INSTRUMENT_ENTER("calcWorkspaceWeightedMutualInformation",vectorLength);
+  calculateWeightedWorkspace(workspace,dataVector,targetVector,weightVector,vectorLength);
+  mutualInformation = workspaceWMI(*workspace);
+  INSTRUMENT_EXIT();
+
+  return mutualInformation;
+}/*calcWorkspaceWeightedMutualInformation(WeightedWorkspace *,uint *,uint *,double *,int)*/
+
+/*******************************************************************************
+** I_w(X;Y) = 1/n \sum_i w_i \log (n c(x_i,y_i) / (c(x_i)c(y_i))), so once the
+** log of each joint state is tabulated a round needs no logs at all.
+*******************************************************************************/
+static void fillPointwiseMI(int *jointCounts, int *firstCounts, int *secondCounts, int numFirstStates, int numSecondStates,
+                            double length, double *pointwiseMI) {
+  int i, j;
+  int *jointRow;
+  double *tableRow;
+
+  for (j = 0; j < numSecondStates; j++) {
+    jointRow = jointCounts + j*numFirstStates;
+    tableRow = pointwiseMI + j*numFirstStates;
+    for (i = 0; i < numFirstStates; i++) {
+      if (jointRow[i] > 0) {
+        tableRow[i] = log(length * jointRow[i] / ((double) firstCounts[i] * secondCounts[j]));
+      }
+    }
+  }
+}/*fillPointwiseMI(int *,int *,int *,int,int,double,double *)*/
+
+WeightedMIBatch createWeightedMIBatch(uint *featureMatrix, uint *targetVector, int numSamples, int numFeatures) {
+  WeightedMIBatch batch;
+  int *firstStates = (int *) checkedCalloc(numFeatures,sizeof(int));
+  int numTargetStates = maxState(targetVector,numSamples);
+  int maxFirstStates = 1;
+  int j;
+
+  batch.numSamples = numSamples;
+  batch.numFeatures = numFeatures;
+  batch.tableOffsets = (size_t *) checkedCalloc(numFeatures + 1,sizeof(size_t));
+  batch.jointIndices = (uint *) checkedCalloc((size_t) numSamples * numFeatures + 1,sizeof(uint));
+
+  for (j = 0; j < numFeatures; j++) {
+    firstStates[j] = maxState(featureMatrix + (size_t) j * numSamples,numSamples);
+    if (firstStates[j] > maxFirstStates) {
+      maxFirstStates = firstStates[j];
+    }
+    batch.tableOffsets[j+1] = batch.tableOffsets[j] + (size_t) firstStates[j] * numTargetStates;
+  }
+  batch.pointwiseMI = (double *) checkedCalloc(batch.tableOffsets[numFeatures] + 1,sizeof(double));
+
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    int *jointCounts = (int *) checkedCalloc((size_t) maxFirstStates * numTargetStates,sizeof(int));
+    int *firstCounts = (int *) checkedCalloc(maxFirstStates,sizeof(int));
+    int *secondCounts = (int *) checkedCalloc(numTargetStates,sizeof(int));
+    uint *featureVector;
+    uint *jointIndices;
+    int numJointStates, f;
+
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic,4)
+#endif
+    for (f = 0; f < numFeatures; f++) {
+      featureVector = featureMatrix + (size_t) f * numSamples;
+      jointIndices = batch.jointIndices + (size_t) f * numSamples;
+      numJointStates = firstStates[f] * numTargetStates;
+
+      memset(jointCounts,0,numJointStates * sizeof(int));
+      memset(firstCounts,0,firstStates[f] * sizeof(int));
+      memset(secondCounts,0,numTargetStates * sizeof(int));
+      activeKernels->jointIndices(featureVector,targetVector,firstStates[f],jointIndices,numSamples);
+      activeKernels->countJointStates(featureVector,targetVector,firstStates[f],numSamples,firstCounts,secondCounts,jointCounts);
+      fillPointwiseMI(jointCounts,firstCounts,secondCounts,firstStates[f],numTargetStates,numSamples,
+                      batch.pointwiseMI + batch.tableOffsets[f]);
+    }
+
+    FREE_FUNC(jointCounts);
+    FREE_FUNC(firstCounts);
+    FREE_FUNC(secondCounts);
+  }
+
+  FREE_FUNC(firstStates);
+  firstStates = NULL;
+
+  return batch;
+}/*createWeightedMIBatch(uint *,uint *,int,int)*/
+
+void calcWeightedMIBatch(WeightedMIBatch batch, double *weightVector, double *outputVector) {
+  int j;
+
+  INSTRUMENT_ENTER("calcWeightedMIBatch",batch.numSamples);
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic,4)
+#endif
+  for (j = 0; j < batch.numFeatures; j++) {
+    uint *jointIndices = batch.jointIndices + (size_t) j * batch.numSamples;
+    double *pointwiseMI = batch.pointwiseMI + batch.tableOffsets[j];
+    double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+    int i;
+
+    for (i = 0; i + 3 < batch.numSamples; i += 4) {
+      sum0 += weightVector[i] * pointwiseMI[jointIndices[i]];
+      sum1 += weightVector[i+1] * pointwiseMI[jointIndices[i+1]];
+      sum2 += weightVector[i+2] * pointwiseMI[jointIndices[i+2]];
+      sum3 += weightVector[i+3] * pointwiseMI[jointIndices[i+3]];
+    }
+    for (; i < batch.numSamples; i++) {
+      sum0 += weightVector[i] * pointwiseMI[jointIndices[i]];
+    }
+
+    outputVector[j] = batch.numSamples > 0 ? ((sum0 + sum1) + (sum2 + sum3)) / batch.numSamples / log(LOG_BASE) : 0.0;
+  }
+  INSTRUMENT_EXIT();
+}/*calcWeightedMIBatch(WeightedMIBatch,double *,double *)*/
+
+void freeWeightedMIBatch(WeightedMIBatch batch) {
+  FREE_FUNC(batch.jointIndices);
+  batch.jointIndices = NULL;
+  FREE_FUNC(batch.pointwiseMI);
+  batch.pointwiseMI = NULL;
+  FREE_FUNC(batch.tableOffsets);
+  batch.tableOffsets = NULL;
+}
@@ -1,14 +1,1457 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include <sys/time.h>
 
 #include "MIToolbox/ArrayOperations.h"
+#include "MIToolbox/BatchInformation.h"
+#include "MIToolbox/BiasCorrection.h"
+#include "MIToolbox/ChowLiuTree.h"
+#include "MIToolbox/DataReader.h"
+#include "MIToolbox/DiscreteMatrix.h"
 #include "MIToolbox/Entropy.h"
+#include "MIToolbox/Instrumentation.h"
+#include "MIToolbox/JointCounts.h"
+#include "MIToolbox/Kernels.h"
+#include "MIToolbox/MultiInformation.h"
 #include "MIToolbox/MutualInformation.h"
+#include "MIToolbox/OnlineInformation.h"
+#include "MIToolbox/RenyiEntropy.h"
+#include "MIToolbox/RenyiMutualInformation.h"
+#include "MIToolbox/Resampling.h"
+#include "MIToolbox/SegmentedInformation.h"
+#include "MIToolbox/SparseMatrix.h"
+#include "MIToolbox/TimeSeriesInformation.h"
+#include "MIToolbox/WeightedEntropy.h"
+#include "MIToolbox/WeightedMutualInformation.h"
 
-int main(int argc, char *argv[])
+#define TOLERANCE 1e-9
+
+/* Prints the result of a check and returns 1 if it failed. */
+static int checkClose(const char *name, double actual, double expected)
+{
+  double difference = actual - expected;
+
+  if ((difference > TOLERANCE) || (difference < -TOLERANCE))
+  {
+    printf("FAIL %s: got %.12f, expected %.12f\n",name,actual,expected);
+    return 1;
+  }
+  printf("PASS %s\n",name);
+  return 0;
+}/*checkClose(const char *,double,double)*/
+
+static int checkInt(const char *name, int actual, int expected)
+{
+  if (actual != expected)
+  {
+    printf("FAIL %s: got %d, expected %d\n",name,actual,expected);
+    return 1;
+  }
+  printf("PASS %s\n",name);
+  return 0;
+}/*checkInt(const char *,int,int)*/
+
+/* Returns the larger of currentError and |actual - expected|. */
+static double maxError(double currentError, double actual, double expected)
+{
+  double error = actual > expected ? actual - expected : expected - actual;
+
+  return error > currentError ? error : currentError;
+}/*maxError(double,double,double)*/
+
+/* A fixed linear congruential generator so the checks are repeatable. */
+static uint randomState(unsigned long *seed, int numStates)
+{
+  *seed = (*seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+  return (uint) ((*seed >> 8) % numStates);
+}/*randomState(unsigned long *,int)*/
+
+/* Fills a vector which is a noisy copy of sourceVector, or uniform if it is NULL. */
+static void fillVector(unsigned long *seed, uint *sourceVector, uint *outputVector, int numStates, int vectorLength)
 {
   int i;
+
+  for (i = 0; i < vectorLength; i++)
+  {
+    if ((sourceVector != NULL) && (randomState(seed,4) != 0))
+    {
+      outputVector[i] = (sourceVector[i] + randomState(seed,2)) % numStates;
+    }
+    else
+    {
+      outputVector[i] = randomState(seed,numStates);
+    }
+  }
+}/*fillVector(unsigned long *,uint *,uint *,int,int)*/
+
+static int testJointCounts(uint *firstVector, uint *secondVector, uint *thirdVector, int vectorLength)
+{
+  int failures = 0;
+  int half = vectorLength / 2;
+  uint bigVector[1] = {65536};
+  uint wideVector[2] = {70000, 0};
+  JointCounts counts, firstHalf, secondHalf, copy, tooBig;
+  unsigned char *buffer;
+  size_t bufferLength;
+
+  counts = calculateJointCounts(firstVector,secondVector,thirdVector,vectorLength);
+  failures += checkClose("countsEntropy",countsEntropy(counts),calcEntropy(firstVector,vectorLength));
+  failures += checkClose("countsJointEntropy",countsJointEntropy(counts),calcJointEntropy(firstVector,secondVector,vectorLength));
+  failures += checkClose("countsConditionalEntropy",countsConditionalEntropy(counts),calcConditionalEntropy(firstVector,secondVector,vectorLength));
+  failures += checkClose("countsMutualInformation",countsMutualInformation(counts),calcMutualInformation(firstVector,secondVector,vectorLength));
+  failures += checkClose("countsConditionalMutualInformation",countsConditionalMutualInformation(counts),
+                         calcConditionalMutualInformation(firstVector,secondVector,thirdVector,vectorLength));
+
+  firstHalf = calculateJointCounts(firstVector,secondVector,thirdVector,half);
+  failures += checkInt("accumulateJointCounts",accumulateJointCounts(&firstHalf,firstVector+half,secondVector+half,thirdVector+half,vectorLength-half),0);
+  failures += checkClose("accumulateJointCounts value",countsConditionalMutualInformation(firstHalf),countsConditionalMutualInformation(counts));
+  freeJointCounts(firstHalf);
+
+  firstHalf = calculateJointCounts(firstVector,secondVector,thirdVector,half);
+  secondHalf = calculateJointCounts(firstVector+half,secondVector+half,thirdVector+half,vectorLength-half);
+  failures += checkInt("mergeJointCounts",mergeJointCounts(&firstHalf,secondHalf),0);
+  failures += checkClose("mergeJointCounts value",countsConditionalMutualInformation(firstHalf),countsConditionalMutualInformation(counts));
+  freeJointCounts(firstHalf);
+  freeJointCounts(secondHalf);
+
+  bufferLength = serialisedJointCountsSize(counts);
+  buffer = (unsigned char *) calloc(bufferLength,sizeof(unsigned char));
+  failures += checkInt("serialiseJointCounts",(int) serialiseJointCounts(counts,buffer),(int) bufferLength);
+  failures += checkInt("deserialiseJointCounts",deserialiseJointCounts(buffer,bufferLength,&copy),0);
+  failures += checkClose("deserialiseJointCounts value",countsConditionalMutualInformation(copy),countsConditionalMutualInformation(counts));
+  freeJointCounts(copy);
+  failures += checkInt("deserialiseJointCounts truncated",deserialiseJointCounts(buffer,bufferLength-1,&copy),-1);
+  buffer[0] ^= 0xFF;
+  failures += checkInt("deserialiseJointCounts bad magic",deserialiseJointCounts(buffer,bufferLength,&copy),-1);
+  buffer[0] ^= 0xFF;
+  buffer[24] ^= 0x01;
+  failures += checkInt("deserialiseJointCounts bad sum",deserialiseJointCounts(buffer,bufferLength,&copy),-1);
+  free(buffer);
+
+  /* A single cell holding UINT_MAX - 1 samples, which can't take two more. */
+  tooBig = calculateJointCounts(NULL,NULL,NULL,0);
+  buffer = (unsigned char *) calloc(serialisedJointCountsSize(tooBig),sizeof(unsigned char));
+  serialiseJointCounts(tooBig,buffer);
+  buffer[20] = buffer[24] = 0xFE;
+  buffer[21] = buffer[22] = buffer[23] = buffer[25] = buffer[26] = buffer[27] = 0xFF;
+  failures += checkInt("deserialiseJointCounts full",deserialiseJointCounts(buffer,serialisedJointCountsSize(tooBig),&copy),0);
+  failures += checkInt("accumulateJointCounts sample overflow",accumulateJointCounts(&copy,NULL,NULL,NULL,2),-1);
+  failures += checkInt("mergeJointCounts sample overflow",mergeJointCounts(&copy,counts),-1);
+  failures += checkInt("mergeJointCounts sample overflow unchanged",copy.numSamples == 0xFFFFFFFEU,1);
+  free(buffer);
+  freeJointCounts(copy);
+  freeJointCounts(tooBig);
+
+  tooBig = calculateJointCounts(bigVector,bigVector,NULL,1);
+  failures += checkInt("calculateJointCounts overflow",tooBig.numJointStates,0);
+  failures += checkClose("calculateJointCounts overflow value",countsMutualInformation(tooBig),0.0);
+  failures += checkInt("accumulateJointCounts overflow",accumulateJointCounts(&counts,bigVector,bigVector,bigVector,1),-1);
+  failures += checkInt("accumulateJointCounts overflow unchanged",(int) counts.numSamples,vectorLength);
+  failures += checkInt("mergeJointCounts empty",mergeJointCounts(&counts,tooBig),0);
+  failures += checkClose("mergeJointCounts empty value",countsConditionalMutualInformation(counts),
+                         calcConditionalMutualInformation(firstVector,secondVector,thirdVector,vectorLength));
+  buffer = (unsigned char *) calloc(serialisedJointCountsSize(tooBig),sizeof(unsigned char));
+  serialiseJointCounts(tooBig,buffer);
+  failures += checkInt("deserialiseJointCounts empty",deserialiseJointCounts(buffer,serialisedJointCountsSize(tooBig),&copy),0);
+  failures += checkInt("deserialiseJointCounts empty states",copy.numJointStates,0);
+  free(buffer);
+  freeJointCounts(copy);
+  freeJointCounts(tooBig);
+
+  tooBig = calculateJointCounts(wideVector,wideVector,NULL,2);
+  failures += checkInt("calculateJointCounts overflow states",tooBig.numFirstStates + tooBig.numSecondStates + tooBig.numConditionStates,0);
+  failures += checkInt("accumulateJointCounts into empty",accumulateJointCounts(&tooBig,firstVector,secondVector,NULL,vectorLength),0);
+  failures += checkClose("accumulateJointCounts into empty value",countsMutualInformation(tooBig),
+                         calcMutualInformation(firstVector,secondVector,vectorLength));
+  freeJointCounts(tooBig);
+  freeJointCounts(counts);
+
+  return failures;
+}/*testJointCounts(uint *,uint *,uint *,int)*/
+
+static int testOnlineInformation(uint *firstVector, uint *secondVector, uint *thirdVector, int vectorLength)
+{
+  int failures = 0;
+  int windowLength = 200;
+  int i, start;
+  double entropyError = 0.0, miError = 0.0, cmiError = 0.0;
+  OnlineEntropy entropy = createOnlineEntropy(2);
+  OnlineMI mi = createOnlineMI(2,2);
+  OnlineCMI cmi = createOnlineCMI(2,2,2);
+
+  for (i = 0; i < vectorLength; i++)
+  {
+    onlineEntropyAdd(&entropy,firstVector[i]);
+    onlineMIAdd(&mi,firstVector[i],secondVector[i]);
+    onlineCMIAdd(&cmi,firstVector[i],secondVector[i],thirdVector[i]);
+    if (i >= windowLength)
+    {
+      onlineEntropyRemove(&entropy,firstVector[i-windowLength]);
+      onlineMIRemove(&mi,firstVector[i-windowLength],secondVector[i-windowLength]);
+      onlineCMIRemove(&cmi,firstVector[i-windowLength],secondVector[i-windowLength],thirdVector[i-windowLength]);
+    }
+    if (i % 97 == 0)
+    {
+      start = (i >= windowLength) ? i - windowLength + 1 : 0;
+      entropyError = maxError(entropyError,onlineEntropyValue(&entropy),calcEntropy(firstVector+start,i-start+1));
+      miError = maxError(miError,onlineMIValue(&mi),calcMutualInformation(firstVector+start,secondVector+start,i-start+1));
+      cmiError = maxError(cmiError,onlineCMIValue(&cmi),
+                          calcConditionalMutualInformation(firstVector+start,secondVector+start,thirdVector+start,i-start+1));
+    }
+  }
+  failures += checkClose("onlineEntropy window",entropyError,0.0);
+  failures += checkClose("onlineMI window",miError,0.0);
+  failures += checkClose("onlineCMI window",cmiError,0.0);
+
+  failures += checkInt("onlineEntropyRemove missing",onlineEntropyRemove(&entropy,1000),-1);
+  failures += checkInt("onlineMIRemove missing",onlineMIRemove(&mi,1000,0),-1);
+  failures += checkInt("onlineCMIRemove missing",onlineCMIRemove(&cmi,0,0,1000),-1);
+  failures += checkInt("onlineEntropyAdd oversize",onlineEntropyAdd(&entropy,0x7FFFFFFF),-1);
+  failures += checkInt("onlineMIAdd oversize",onlineMIAdd(&mi,65536,65536),-1);
+  failures += checkInt("onlineCMIAdd oversize",onlineCMIAdd(&cmi,2048,2048,2048),-1);
+  start = vectorLength - windowLength;
+  failures += checkClose("onlineMI unchanged after failure",onlineMIValue(&mi),
+                         calcMutualInformation(firstVector+start,secondVector+start,windowLength));
+
+  freeOnlineEntropy(entropy);
+  freeOnlineMI(mi);
+  freeOnlineCMI(cmi);
+
+  return failures;
+}/*testOnlineInformation(uint *,uint *,uint *,int)*/
+
+/* Writes contents to fileName, returning 0 on success. */
+static int writeFile(const char *fileName, const char *contents, size_t length)
+{
+  FILE *file = fopen(fileName,"wb");
+
+  if (file == NULL)
+  {
+    return -1;
+  }
+  fwrite(contents,1,length,file);
+  fclose(file);
+  return 0;
+}/*writeFile(const char *,const char *,size_t)*/
+
+static int testDiscreteMatrix(void)
+{
+  int failures = 0;
+  int arities[3] = {3, 300, 70000};
+  int i, j, compact, matches;
+  long offset = 0;
+  DiscreteMatrix matrix;
+  MappedMatrix mapped;
+  uint *column = (uint *) calloc(100,sizeof(uint));
+  FILE *file;
+
+  matrix.numSamples = 100;
+  matrix.numFeatures = 3;
+  matrix.arities = arities;
+  matrix.matrix = (uint *) calloc(300,sizeof(uint));
+  for (i = 0; i < 100; i++)
+  {
+    matrix.matrix[i] = i % 3;
+    matrix.matrix[100 + i] = i * 2;
+    matrix.matrix[200 + i] = i * 600;
+  }
+
+  for (compact = 0; compact < 2; compact++)
+  {
+    failures += checkInt("writeDiscreteMatrix",writeDiscreteMatrix("testMIToolbox.bin",matrix,compact),0);
+    failures += checkInt("mapDiscreteMatrix",mapDiscreteMatrix("testMIToolbox.bin",&mapped),0);
+    matches = (mapped.numSamples == 100) && (mapped.numFeatures == 3);
+    for (j = 0; j < 3 && matches; j++)
+    {
+      copyMappedColumn(mapped,j,column);
+      for (i = 0; i < 100; i++)
+      {
+        matches = matches && (column[i] == matrix.matrix[j*100 + i]);
+      }
+      matches = matches && (mapped.arities[j] == arities[j]);
+    }
+    failures += checkInt("mapDiscreteMatrix round trip",matches,1);
+    if (compact)
+    {
+      failures += checkInt("mappedColumnUint8",mappedColumnUint8(mapped,0) != NULL && mappedColumnUint8(mapped,0)[5] == 2,1);
+      failures += checkInt("mappedColumnUint16",mappedColumnUint16(mapped,1) != NULL && mappedColumnUint16(mapped,1)[99] == 198,1);
+      failures += checkInt("mappedColumn narrow",mappedColumn(mapped,0) == NULL,1);
+    }
+    else
+    {
+      failures += checkInt("mappedColumn",mappedColumn(mapped,2) != NULL && mappedColumn(mapped,2)[99] == 59400,1);
+    }
+    offset = (long) (mapped.columns[0] - mapped.mapping);
+    unmapDiscreteMatrix(mapped);
+  }
+
+  /* Corrupt a code of the 1 byte column so it is outside the arity. */
+  file = fopen("testMIToolbox.bin","r+b");
+  fseek(file,offset + 5,SEEK_SET);
+  fputc(7,file);
+  fclose(file);
+  failures += checkInt("mapDiscreteMatrix bad code",mapDiscreteMatrix("testMIToolbox.bin",&mapped),-1);
+  failures += checkInt("mapDiscreteMatrixUnvalidated bad code",mapDiscreteMatrixUnvalidated("testMIToolbox.bin",&mapped),0);
+  unmapDiscreteMatrix(mapped);
+
+  /* Code 256 in the arity 3 column, which a 1 byte column would narrow to 0. */
+  matrix.matrix[5] = 256;
+  failures += checkInt("writeDiscreteMatrix code above arity",writeDiscreteMatrix("testMIToolbox.bin",matrix,1),-1);
+  matrix.matrix[5] = 2;
+
+  /* Corrupt a code of a 4 byte column to 0xFFFFFFFF, which wraps to 0 if it is incremented. */
+  writeDiscreteMatrix("testMIToolbox.bin",matrix,0);
+  mapDiscreteMatrix("testMIToolbox.bin",&mapped);
+  offset = (long) (mapped.columns[2] - mapped.mapping);
+  unmapDiscreteMatrix(mapped);
+  file = fopen("testMIToolbox.bin","r+b");
+  fseek(file,offset + 4*50,SEEK_SET);
+  for (i = 0; i < 4; i++)
+  {
+    fputc(0xFF,file);
+  }
+  fclose(file);
+  failures += checkInt("mapDiscreteMatrix bad uint code",mapDiscreteMatrix("testMIToolbox.bin",&mapped),-1);
+
+  writeFile("testMIToolbox.bin","MITXDMAT",8);
+  failures += checkInt("mapDiscreteMatrix truncated",mapDiscreteMatrix("testMIToolbox.bin",&mapped),-1);
+  writeFile("testMIToolbox.bin","NOTAMATRIXNOTAMATRIXNOTAMATRIX!!",32);
+  failures += checkInt("mapDiscreteMatrix bad magic",mapDiscreteMatrix("testMIToolbox.bin",&mapped),-1);
+  remove("testMIToolbox.bin");
+
+  free(matrix.matrix);
+  free(column);
+
+  return failures;
+}/*testDiscreteMatrix(void)*/
+
+static int testDataReader(void)
+{
+  int failures = 0;
+  const char *csvContents = "colour,size,label\nred, 1,yes\nblue,2,no\nred,3 ,no\ngreen,1,yes\n";
+  const char *badCSVContents = "a,b\n1,2\n3\n";
+  const char *svmContents = "+1 1:0.5 3:2\n-1 2:7\n+1 1:0.5\n";
+  const char *badSVMContents = "1 a:b\n";
+  DiscreteMatrix matrix;
+
+  writeFile("testMIToolbox.csv",csvContents,strlen(csvContents));
+  failures += checkInt("readCSVFile",readCSVFile("testMIToolbox.csv",',',1,&matrix),0);
+  failures += checkInt("readCSVFile samples",matrix.numSamples,4);
+  failures += checkInt("readCSVFile features",matrix.numFeatures,3);
+  failures += checkInt("readCSVFile arities",matrix.arities[0]*100 + matrix.arities[1]*10 + matrix.arities[2],332);
+  failures += checkInt("readCSVFile codes",matrix.matrix[0]*1000 + matrix.matrix[1]*100 + matrix.matrix[2]*10 + matrix.matrix[3],102);
+  failures += checkInt("readCSVFile trimmed",matrix.matrix[4]*1000 + matrix.matrix[5]*100 + matrix.matrix[6]*10 + matrix.matrix[7],120);
+  freeDiscreteMatrix(matrix);
+
+  writeFile("testMIToolbox.csv",badCSVContents,strlen(badCSVContents));
+  failures += checkInt("readCSVFile ragged rows",readCSVFile("testMIToolbox.csv",',',1,&matrix),-1);
+  remove("testMIToolbox.csv");
+  failures += checkInt("readCSVFile missing file",readCSVFile("testMIToolbox.csv",',',1,&matrix),-1);
+
+  writeFile("testMIToolbox.svm",svmContents,strlen(svmContents));
+  failures += checkInt("readLibSVMFile",readLibSVMFile("testMIToolbox.svm",&matrix),0);
+  failures += checkInt("readLibSVMFile samples",matrix.numSamples,3);
+  failures += checkInt("readLibSVMFile features",matrix.numFeatures,4);
+  failures += checkInt("readLibSVMFile labels",matrix.matrix[0]*100 + matrix.matrix[1]*10 + matrix.matrix[2],10);
+  failures += checkInt("readLibSVMFile zeros",matrix.matrix[3]*100 + matrix.matrix[4]*10 + matrix.matrix[5],101);
+  freeDiscreteMatrix(matrix);
+
+  writeFile("testMIToolbox.svm",badSVMContents,strlen(badSVMContents));
+  failures += checkInt("readLibSVMFile malformed",readLibSVMFile("testMIToolbox.svm",&matrix),-1);
+  remove("testMIToolbox.svm");
+
+  return failures;
+}/*testDataReader(void)*/
+
+static int testSparseMatrix(unsigned long *seed)
+{
+  int failures = 0;
+  int numRows = 300, numColumns = 5;
+  int i, j, k;
+  double targetError = 0.0, pairError = 0.0;
+  uint *featureMatrix = (uint *) calloc(numRows*numColumns,sizeof(uint));
+  uint *targetVector = (uint *) calloc(numRows,sizeof(uint));
+  double *outputVector = (double *) calloc(numColumns,sizeof(double));
+  double *outputMatrix = (double *) calloc(numColumns*numColumns,sizeof(double));
+  SparseMatrix matrix;
+
+  fillVector(seed,NULL,targetVector,3,numRows);
+  for (i = 0; i < numRows*numColumns; i++)
+  {
+    featureMatrix[i] = (randomState(seed,5) == 0) ? (targetVector[i % numRows] + randomState(seed,2)) % 3 + 1 : 0;
+  }
+
+  matrix = compressSparseMatrix(featureMatrix,numRows,numColumns);
+  calcSparseMutualInformationTarget(matrix,targetVector,outputVector);
+  calcSparsePairwiseMutualInformationMatrix(matrix,outputMatrix);
+  for (j = 0; j < numColumns; j++)
+  {
+    targetError = maxError(targetError,outputVector[j],calcMutualInformation(featureMatrix+j*numRows,targetVector,numRows));
+    for (k = 0; k < numColumns; k++)
+    {
+      pairError = maxError(pairError,outputMatrix[j + numColumns*k],
+                           calcMutualInformation(featureMatrix+j*numRows,featureMatrix+k*numRows,numRows));
+    }
+  }
+  failures += checkClose("calcSparseMutualInformationTarget",targetError,0.0);
+  failures += checkClose("calcSparsePairwiseMutualInformationMatrix",pairError,0.0);
+  failures += checkClose("calcSparseMutualInformation",calcSparseMutualInformation(matrix,2,targetVector),
+                         calcMutualInformation(featureMatrix+2*numRows,targetVector,numRows));
+  failures += checkClose("calcSparsePairwiseMutualInformation",calcSparsePairwiseMutualInformation(matrix,1,3),
+                         calcMutualInformation(featureMatrix+numRows,featureMatrix+3*numRows,numRows));
+
+  freeSparseMatrix(matrix);
+  free(featureMatrix);
+  free(targetVector);
+  free(outputVector);
+  free(outputMatrix);
+
+  return failures;
+}/*testSparseMatrix(unsigned long *)*/
+
+typedef struct
+{
+  int numCalls;
+  int lastNameMatched;
+  double lastSamples;
+} CallbackRecord;
+
+static void recordCallback(const char *functionName, const InstrumentCounters *callCounters, void *userData)
+{
+  CallbackRecord *record = (CallbackRecord *) userData;
+
+  record->numCalls++;
+  record->lastNameMatched = strcmp(functionName,"calcConditionalMutualInformation") == 0;
+  record->lastSamples = callCounters->samples;
+}/*recordCallback(const char *,const InstrumentCounters *,void *)*/
+
+/* The counters are only live when the library is built with make instrument,
+** otherwise they must stay at zero and the callback must never run. */
+static int testInstrumentation(uint *firstVector, uint *secondVector, uint *thirdVector, int vectorLength)
+{
+  int failures = 0;
+  int live;
+  CallbackRecord record = {0, 0, 0.0};
+  InstrumentCounters counters;
+
+  resetInstrumentCounters();
+  snapshotInstrumentCounters(&counters);
+  failures += checkInt("resetInstrumentCounters calls",(int) counters.calls,0);
+  failures += checkClose("resetInstrumentCounters samples",counters.samples,0.0);
+
+  setInstrumentCallback(recordCallback,&record);
+  calcConditionalMutualInformation(firstVector,secondVector,thirdVector,vectorLength);
+  setInstrumentCallback(NULL,NULL);
+  calcEntropy(firstVector,vectorLength);
+  snapshotInstrumentCounters(&counters);
+  live = counters.calls != 0;
+  printf("Instrumentation is %s\n",live ? "compiled in" : "not compiled in");
+
+  if (live)
+  {
+    /* the nested calcConditionalEntropy calls are not counted separately */
+    failures += checkInt("instrument calls",(int) counters.calls,2);
+    failures += checkClose("instrument samples",counters.samples,2.0*vectorLength);
+    failures += checkInt("instrument cells",counters.cells > 0.0,1);
+    failures += checkInt("instrument callback calls",record.numCalls,1);
+    failures += checkInt("instrument callback name",record.lastNameMatched,1);
+    failures += checkClose("instrument callback samples",record.lastSamples,vectorLength);
+  }
+  else
+  {
+    failures += checkClose("instrument samples",counters.samples,0.0);
+    failures += checkClose("instrument cells",counters.cells,0.0);
+    failures += checkInt("instrument callback calls",record.numCalls,0);
+  }
+
+  resetInstrumentCounters();
+  snapshotInstrumentCounters(&counters);
+  failures += checkInt("resetInstrumentCounters after calls",(int) counters.calls,0);
+  failures += checkClose("resetInstrumentCounters after samples",counters.samples,0.0);
+  failures += checkClose("resetInstrumentCounters after cells",counters.cells,0.0);
+
+  return failures;
+}/*testInstrumentation(uint *,uint *,uint *,int)*/
+
+#define NUM_KERNEL_RESULTS 8
+
+/* Calculates every quantity which goes through the kernel table. */
+static void kernelResults(uint *firstVector, uint *secondVector, uint *thirdVector, double *doubleVector,
+                          double *weightVector, int vectorLength, double *results)
+{
+  results[0] = calcEntropy(firstVector,vectorLength);
+  results[1] = calcJointEntropy(firstVector,secondVector,vectorLength);
+  results[2] = calcConditionalEntropy(firstVector,secondVector,vectorLength);
+  results[3] = calcMutualInformation(firstVector,secondVector,vectorLength);
+  results[4] = calcConditionalMutualInformation(firstVector,secondVector,thirdVector,vectorLength);
+  results[5] = discAndCalcMutualInformation(doubleVector,doubleVector+vectorLength,vectorLength);
+  results[6] = calcWeightedMutualInformation(firstVector,secondVector,weightVector,vectorLength);
+  results[7] = calcWeightedConditionalMutualInformation(firstVector,secondVector,thirdVector,weightVector,vectorLength);
+}/*kernelResults(uint *,uint *,uint *,double *,double *,int,double *)*/
+
+/* Every variant the CPU supports must agree with the scalar loops. The odd
+** length leaves a remainder after the vector loops. */
+static int testKernelVariants(uint *firstVector, uint *secondVector, uint *thirdVector, int vectorLength)
+{
+  int failures = 0;
+  int oddLength = vectorLength - 3;
+  int i, j;
+  const char *variants[4] = {"sse4.2", "avx2", "avx512f", "scalar"};
+  const char *originalVariant = kernelVariant();
+  double scalarResults[NUM_KERNEL_RESULTS], variantResults[NUM_KERNEL_RESULTS];
+  double error;
+  double *doubleVector = (double *) calloc(2*oddLength,sizeof(double));
+  double *weightVector = (double *) calloc(oddLength,sizeof(double));
+  char name[64];
+
+  for (i = 0; i < oddLength; i++)
+  {
+    doubleVector[i] = firstVector[i] - 2.5;
+    doubleVector[oddLength+i] = secondVector[i] + 0.75;
+    weightVector[i] = 0.5 + thirdVector[i];
+  }
+
+  failures += checkInt("setKernelVariant unknown",setKernelVariant("mmx"),-1);
+  failures += checkInt("setKernelVariant scalar",setKernelVariant("scalar"),0);
+  failures += checkInt("kernelVariant scalar",strcmp(kernelVariant(),"scalar"),0);
+  kernelResults(firstVector,secondVector,thirdVector,doubleVector,weightVector,oddLength,scalarResults);
+
+  for (i = 0; i < 4; i++)
+  {
+    if (setKernelVariant(variants[i]) != 0)
+    {
+      printf("Kernel variant %s is not available\n",variants[i]);
+      continue;
+    }
+    kernelResults(firstVector,secondVector,thirdVector,doubleVector,weightVector,oddLength,variantResults);
+    error = 0.0;
+    for (j = 0; j < NUM_KERNEL_RESULTS; j++)
+    {
+      error = maxError(error,variantResults[j],scalarResults[j]);
+    }
+    sprintf(name,"kernel variant %s",variants[i]);
+    failures += checkClose(name,error,0.0);
+  }
+
+  failures += checkInt("restore kernelVariant",setKernelVariant(originalVariant),0);
+
+  free(doubleVector);
+  free(weightVector);
+
+  return failures;
+}/*testKernelVariants(uint *,uint *,uint *,int)*/
+
+#define NUM_TEST_ALPHAS 6
+
+/* Each multi alpha result must match the single alpha call, including the
+** integer, collision and min-entropy special cases. */
+static int testMultiAlphaRenyi(uint *firstVector, uint *secondVector, int vectorLength)
+{
+  int failures = 0;
+  int i;
+  double alphas[NUM_TEST_ALPHAS] = {0.5, 1.5, 2.0, 3.0, 7.25, HUGE_VAL};
+  double outputVector[NUM_TEST_ALPHAS];
+  double entropyError = 0.0, jointError = 0.0, divergenceError = 0.0, miJointError = 0.0, discError = 0.0;
+  double *doubleVector = (double *) calloc(vectorLength,sizeof(double));
+
+  for (i = 0; i < vectorLength; i++)
+  {
+    doubleVector[i] = firstVector[i] - 1.5;
+  }
+
+  calcMultiAlphaRenyiEntropy(alphas,NUM_TEST_ALPHAS,firstVector,vectorLength,outputVector);
+  for (i = 0; i < NUM_TEST_ALPHAS; i++)
+  {
+    entropyError = maxError(entropyError,outputVector[i],calcRenyiEntropy(alphas[i],firstVector,vectorLength));
+  }
+  calcMultiAlphaJointRenyiEntropy(alphas,NUM_TEST_ALPHAS,firstVector,secondVector,vectorLength,outputVector);
+  for (i = 0; i < NUM_TEST_ALPHAS; i++)
+  {
+    jointError = maxError(jointError,outputVector[i],calcJointRenyiEntropy(alphas[i],firstVector,secondVector,vectorLength));
+  }
+  calcMultiAlphaRenyiMIDivergence(alphas,NUM_TEST_ALPHAS,firstVector,secondVector,vectorLength,outputVector);
+  for (i = 0; i < NUM_TEST_ALPHAS; i++)
+  {
+    divergenceError = maxError(divergenceError,outputVector[i],calcRenyiMIDivergence(alphas[i],firstVector,secondVector,vectorLength));
+  }
+  calcMultiAlphaRenyiMIJoint(alphas,NUM_TEST_ALPHAS,firstVector,secondVector,vectorLength,outputVector);
+  for (i = 0; i < NUM_TEST_ALPHAS; i++)
+  {
+    miJointError = maxError(miJointError,outputVector[i],calcRenyiMIJoint(alphas[i],firstVector,secondVector,vectorLength));
+  }
+  discAndCalcMultiAlphaRenyiEntropy(alphas,NUM_TEST_ALPHAS,doubleVector,vectorLength,outputVector);
+  for (i = 0; i < NUM_TEST_ALPHAS; i++)
+  {
+    discError = maxError(discError,outputVector[i],calcRenyiEntropy(alphas[i],firstVector,vectorLength));
+  }
+
+  failures += checkClose("calcMultiAlphaRenyiEntropy",entropyError,0.0);
+  failures += checkClose("calcMultiAlphaJointRenyiEntropy",jointError,0.0);
+  failures += checkClose("calcMultiAlphaRenyiMIDivergence",divergenceError,0.0);
+  failures += checkClose("calcMultiAlphaRenyiMIJoint",miJointError,0.0);
+  failures += checkClose("discAndCalcMultiAlphaRenyiEntropy",discError,0.0);
+
+  free(doubleVector);
+
+  return failures;
+}/*testMultiAlphaRenyi(uint *,uint *,int)*/
+
+#define TEST_FIRST_STATES 6
+#define TEST_SECOND_STATES 5
+
+/* H_2 = -log sum p^2, H_inf = -log max p, and the divergences
+** D_2 = log sum p(x,y)^2/(p(x)p(y)), D_inf = log max p(x,y)/(p(x)p(y)),
+** summed directly over the state counts. */
+static int testSpecialRenyi(uint *firstVector, uint *secondVector, int vectorLength)
+{
+  int failures = 0;
+  int i, j;
+  double firstCounts[TEST_FIRST_STATES] = {0.0};
+  double secondCounts[TEST_SECOND_STATES] = {0.0};
+  double jointCounts[TEST_FIRST_STATES*TEST_SECOND_STATES] = {0.0};
+  double n = vectorLength, p, ratio;
+  double firstSquares = 0.0, firstMax = 0.0, jointSquares = 0.0, jointMax = 0.0;
+  double ratioSum = 0.0, ratioMax = 0.0;
+  double *firstDouble = (double *) calloc(vectorLength,sizeof(double));
+  double *secondDouble = (double *) calloc(vectorLength,sizeof(double));
+
+  for (i = 0; i < vectorLength; i++)
+  {
+    firstCounts[firstVector[i]]++;
+    secondCounts[secondVector[i]]++;
+    jointCounts[firstVector[i] + TEST_FIRST_STATES*secondVector[i]]++;
+    firstDouble[i] = firstVector[i];
+    secondDouble[i] = secondVector[i];
+  }
+  for (i = 0; i < TEST_FIRST_STATES; i++)
+  {
+    p = firstCounts[i] / n;
+    firstSquares += p * p;
+    firstMax = p > firstMax ? p : firstMax;
+  }
+  for (j = 0; j < TEST_SECOND_STATES; j++)
+  {
+    for (i = 0; i < TEST_FIRST_STATES; i++)
+    {
+      p = jointCounts[i + TEST_FIRST_STATES*j] / n;
+      if (p > 0.0)
+      {
+        ratio = p / ((firstCounts[i] / n) * (secondCounts[j] / n));
+        jointSquares += p * p;
+        jointMax = p > jointMax ? p : jointMax;
+        ratioSum += p * ratio;
+        ratioMax = ratio > ratioMax ? ratio : ratioMax;
+      }
+    }
+  }
+
+  failures += checkClose("calcCollisionEntropy",calcCollisionEntropy(firstVector,vectorLength),-log(firstSquares)/log(LOG_BASE));
+  failures += checkClose("calcMinEntropy",calcMinEntropy(firstVector,vectorLength),-log(firstMax)/log(LOG_BASE));
+  failures += checkClose("calcJointCollisionEntropy",calcJointCollisionEntropy(firstVector,secondVector,vectorLength),
+                         -log(jointSquares)/log(LOG_BASE));
+  failures += checkClose("calcJointMinEntropy",calcJointMinEntropy(firstVector,secondVector,vectorLength),-log(jointMax)/log(LOG_BASE));
+  failures += checkClose("calcCollisionMIDivergence",calcCollisionMIDivergence(firstVector,secondVector,vectorLength),
+                         log(ratioSum)/log(LOG_BASE));
+  failures += checkClose("calcMinMIDivergence",calcMinMIDivergence(firstVector,secondVector,vectorLength),log(ratioMax)/log(LOG_BASE));
+
+  /* the alpha functions route to the same values, from counts or probabilities */
+  failures += checkClose("calcRenyiEntropy alpha 2",calcRenyiEntropy(2.0,firstVector,vectorLength),-log(firstSquares)/log(LOG_BASE));
+  failures += checkClose("calcJointRenyiEntropy alpha inf",calcJointRenyiEntropy(HUGE_VAL,firstVector,secondVector,vectorLength),
+                         -log(jointMax)/log(LOG_BASE));
+  failures += checkClose("discAndCalcRenyiMIDivergence alpha 2",discAndCalcRenyiMIDivergence(2.0,firstDouble,secondDouble,vectorLength),
+                         log(ratioSum)/log(LOG_BASE));
+  failures += checkClose("discAndCalcRenyiMIDivergence alpha inf",discAndCalcRenyiMIDivergence(HUGE_VAL,firstDouble,secondDouble,vectorLength),
+                         log(ratioMax)/log(LOG_BASE));
+
+  free(firstDouble);
+  free(secondDouble);
+
+  return failures;
+}/*testSpecialRenyi(uint *,uint *,int)*/
+
+/* Reuses one workspace over several rounds of weights, with the smaller
+** variables first so the workspace has to grow, as it would in boosting. */
+static int testWeightedWorkspace(unsigned long *seed, uint *firstVector, uint *secondVector, uint *thirdVector, int vectorLength)
+{
+  int failures = 0;
+  int round, i;
+  double miError = 0.0, entropyError = 0.0, condError = 0.0;
+  double *weightVector = (double *) calloc(vectorLength,sizeof(double));
+  WeightedWorkspace workspace = createWeightedWorkspace();
+
+  for (round = 0; round < 4; round++)
+  {
+    for (i = 0; i < vectorLength; i++)
+    {
+      weightVector[i] = 0.25 + randomState(seed,8) / 4.0;
+    }
+    miError = maxError(miError,calcWorkspaceWeightedMutualInformation(&workspace,thirdVector,secondVector,weightVector,vectorLength),
+                       calcWeightedMutualInformation(thirdVector,secondVector,weightVector,vectorLength));
+    miError = maxError(miError,calcWorkspaceWeightedMutualInformation(&workspace,firstVector,secondVector,weightVector,vectorLength-round),
+                       calcWeightedMutualInformation(firstVector,secondVector,weightVector,vectorLength-round));
+    entropyError = maxError(entropyError,calcWorkspaceWeightedEntropy(&workspace,firstVector,weightVector,vectorLength),
+                            calcWeightedEntropy(firstVector,weightVector,vectorLength));
+    condError = maxError(condError,calcWorkspaceWeightedConditionalEntropy(&workspace,firstVector,thirdVector,weightVector,vectorLength),
+                         calcWeightedConditionalEntropy(firstVector,thirdVector,weightVector,vectorLength));
+  }
+
+  failures += checkClose("calcWorkspaceWeightedMutualInformation",miError,0.0);
+  failures += checkClose("calcWorkspaceWeightedEntropy",entropyError,0.0);
+  failures += checkClose("calcWorkspaceWeightedConditionalEntropy",condError,0.0);
+
+  freeWeightedWorkspace(workspace);
+  free(weightVector);
+
+  return failures;
+}/*testWeightedWorkspace(unsigned long *,uint *,uint *,uint *,int)*/
+
+/* Each round of weights must give every feature the same value as
+** calcWeightedMutualInformation, with some samples given zero weight. */
+static int testWeightedMIBatch(unsigned long *seed, uint *firstVector, uint *secondVector, uint *thirdVector, int vectorLength)
+{
+  int failures = 0;
+  int numFeatures = 3;
+  int round, i, j;
+  double error = 0.0;
+  uint *featureMatrix = (uint *) calloc((size_t) vectorLength*numFeatures,sizeof(uint));
+  double *weightVector = (double *) calloc(vectorLength,sizeof(double));
+  double outputVector[3];
+  WeightedMIBatch batch;
+
+  for (i = 0; i < vectorLength; i++)
+  {
+    featureMatrix[i] = secondVector[i];
+    featureMatrix[vectorLength+i] = thirdVector[i];
+    featureMatrix[2*vectorLength+i] = (firstVector[i] + thirdVector[i]) % 4;
+  }
+  batch = createWeightedMIBatch(featureMatrix,firstVector,vectorLength,numFeatures);
+
+  for (round = 0; round < 4; round++)
+  {
+    for (i = 0; i < vectorLength; i++)
+    {
+      weightVector[i] = randomState(seed,5) / 2.0;
+    }
+    calcWeightedMIBatch(batch,weightVector,outputVector);
+    for (j = 0; j < numFeatures; j++)
+    {
+      error = maxError(error,outputVector[j],
+                       calcWeightedMutualInformation(featureMatrix+(size_t)j*vectorLength,firstVector,weightVector,vectorLength));
+    }
+  }
+
+  failures += checkClose("calcWeightedMIBatch",error,0.0);
+
+  freeWeightedMIBatch(batch);
+  free(featureMatrix);
+  free(weightVector);
+
+  return failures;
+}/*testWeightedMIBatch(unsigned long *,uint *,uint *,uint *,int)*/
+
+static int testCompactMerge(uint *firstVector, uint *secondVector, uint *thirdVector, int vectorLength)
+{
+  int failures = 0;
+  int numStates = 0, numMultipleStates = 0, numMerged, numMultipleMerged, i;
+  int *seen = (int *) calloc(6*6*6,sizeof(int));
+  int *seenMultiple = (int *) calloc(6*6*6,sizeof(int));
+  uint *mergedVector = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *inputMatrix = (uint *) calloc(3*vectorLength,sizeof(uint));
+
+  for (i = 0; i < vectorLength; i++)
+  {
+    if (seen[firstVector[i] + 6*secondVector[i]]++ == 0)
+    {
+      numStates++;
+    }
+    if (seenMultiple[firstVector[i] + 6*(secondVector[i] + 6*thirdVector[i])]++ == 0)
+    {
+      numMultipleStates++;
+    }
+    inputMatrix[i] = firstVector[i];
+    inputMatrix[vectorLength + i] = secondVector[i];
+    inputMatrix[2*vectorLength + i] = thirdVector[i];
+  }
+
+  numMerged = compactMergeArrays(firstVector,secondVector,mergedVector,vectorLength);
+  failures += checkInt("compactMergeArrays states",numMerged,numStates);
+  failures += checkInt("compactMergeArrays codes",maxState(mergedVector,vectorLength),numStates);
+  failures += checkClose("compactMergeArrays entropy",calcEntropy(mergedVector,vectorLength),
+                         calcJointEntropy(firstVector,secondVector,vectorLength));
+
+  numMultipleMerged = compactMergeMultipleArrays(inputMatrix,mergedVector,3,vectorLength);
+  failures += checkInt("compactMergeMultipleArrays states",numMultipleMerged,numMultipleStates);
+  failures += checkInt("compactMergeMultipleArrays codes",maxState(mergedVector,vectorLength),numMultipleStates);
+
+  free(seen);
+  free(seenMultiple);
+  free(mergedVector);
+  free(inputMatrix);
+
+  return failures;
+}/*testCompactMerge(uint *,uint *,uint *,int)*/
+
+/* Fills numTargets uniform columns, then numFeatures noisy copies of them. */
+static void fillMatrices(unsigned long *seed, uint *featureMatrix, int numFeatures, uint *targetMatrix, int numTargets,
+                         int numStates, int numSamples)
+{
+  int j;
+
+  for (j = 0; j < numTargets; j++)
+  {
+    fillVector(seed,NULL,targetMatrix+j*numSamples,numStates,numSamples);
+  }
+  for (j = 0; j < numFeatures; j++)
+  {
+    fillVector(seed,targetMatrix+(j % numTargets)*numSamples,featureMatrix+j*numSamples,numStates,numSamples);
+  }
+}/*fillMatrices(unsigned long *,uint *,int,uint *,int,int,int)*/
+
+static int testBatchInformation(unsigned long *seed)
+{
+  int failures = 0;
+  int numSamples = 1000, numFeatures = 7;
+  int j;
+  double miError = 0.0, cmiError = 0.0;
+  uint *featureMatrix = (uint *) calloc(numSamples*numFeatures,sizeof(uint));
+  uint *targetMatrix = (uint *) calloc(numSamples*2,sizeof(uint));
+  uint *conditionVector = targetMatrix + numSamples;
+  double *outputVector = (double *) calloc(numFeatures,sizeof(double));
+
+  fillMatrices(seed,featureMatrix,numFeatures,targetMatrix,2,4,numSamples);
+
+  calcMutualInformationBatch(featureMatrix,targetMatrix,numSamples,numFeatures,outputVector);
+  for (j = 0; j < numFeatures; j++)
+  {
+    miError = maxError(miError,outputVector[j],calcMutualInformation(featureMatrix+j*numSamples,targetMatrix,numSamples));
+  }
+  failures += checkClose("calcMutualInformationBatch",miError,0.0);
+
+  calcConditionalMutualInformationBatch(featureMatrix,targetMatrix,conditionVector,numSamples,numFeatures,outputVector);
+  for (j = 0; j < numFeatures; j++)
+  {
+    cmiError = maxError(cmiError,outputVector[j],
+                        calcConditionalMutualInformation(featureMatrix+j*numSamples,targetMatrix,conditionVector,numSamples));
+  }
+  failures += checkClose("calcConditionalMutualInformationBatch",cmiError,0.0);
+
+  free(featureMatrix);
+  free(targetMatrix);
+  free(outputVector);
+
+  return failures;
+}/*testBatchInformation(unsigned long *)*/
+
+/* The thread counts used to check that a seed gives the same result however
+** the replicates are scheduled. Without OpenMP only the default is run. */
+#ifdef _OPENMP
+  #include <omp.h>
+  #define NUM_TEST_THREAD_COUNTS 3
+#else
+  #define NUM_TEST_THREAD_COUNTS 1
+#endif
+
+static void setTestThreads(int index)
+{
+#ifdef _OPENMP
+  int threadCounts[NUM_TEST_THREAD_COUNTS] = {1, 2, 5};
+  omp_set_num_threads(threadCounts[index]);
+#else
+  (void) index;
+#endif
+}/*setTestThreads(int)*/
+
+/* Returns 1 if pValue is (1 + r) / (1 + m) for some 0 <= r <= m. */
+static int validPValue(PermutationTest result)
+{
+  double exceeded = result.pValue * (1.0 + result.numPermutations) - 1.0;
+  double rounded = floor(exceeded + 0.5);
+
+  return (result.pValue > 0.0) && (result.pValue <= 1.0) && (rounded >= 0.0)
+      && (rounded <= result.numPermutations) && (fabs(exceeded - rounded) < 1e-6);
+}/*validPValue(PermutationTest)*/
+
+static int testPermutationTest(unsigned long *seed, uint *firstVector, uint *secondVector, int vectorLength)
+{
+  int failures = 0;
+  int sameResult = 1;
+  int i;
+  uint *independentVector = (uint *) calloc(vectorLength,sizeof(uint));
+  PermutationTest dependent, independent, repeat, stopped;
+
+  fillVector(seed,NULL,independentVector,4,vectorLength);
+
+  dependent = calcMutualInformationPermutationTest(firstVector,secondVector,vectorLength,200,0.0,11);
+  independent = calcMutualInformationPermutationTest(firstVector,independentVector,vectorLength,200,0.0,11);
+  failures += checkClose("calcMutualInformationPermutationTest mutualInformation",dependent.mutualInformation,
+                         calcMutualInformation(firstVector,secondVector,vectorLength));
+  failures += checkInt("calcMutualInformationPermutationTest numPermutations",dependent.numPermutations,200);
+  failures += checkInt("calcMutualInformationPermutationTest valid pValue",validPValue(dependent) && validPValue(independent),1);
+  failures += checkClose("calcMutualInformationPermutationTest dependent pValue",dependent.pValue,1.0/201.0);
+  failures += checkInt("calcMutualInformationPermutationTest independent pValue",independent.pValue > 0.05,1);
+
+  for (i = 0; i < NUM_TEST_THREAD_COUNTS; i++)
+  {
+    setTestThreads(i);
+    repeat = calcMutualInformationPermutationTest(firstVector,independentVector,vectorLength,200,0.0,11);
+    sameResult &= (repeat.pValue == independent.pValue) && (repeat.numPermutations == independent.numPermutations)
+                  && (repeat.mutualInformation == independent.mutualInformation);
+  }
+  failures += checkInt("calcMutualInformationPermutationTest same seed",sameResult,1);
+
+  /* a clearly dependent pair stops after the first block */
+  stopped = calcMutualInformationPermutationTest(firstVector,secondVector,vectorLength,100000,0.05,11);
+  failures += checkInt("calcMutualInformationPermutationTest early stop",stopped.numPermutations < 100000,1);
+  failures += checkInt("calcMutualInformationPermutationTest early stop pValue",validPValue(stopped) && (stopped.pValue < 0.05),1);
+
+  free(independentVector);
+
+  return failures;
+}/*testPermutationTest(unsigned long *,uint *,uint *,int)*/
+
+static int testBootstrap(uint *firstVector, uint *secondVector, uint *thirdVector, int vectorLength)
+{
+  int failures = 0;
+  int sameResult = 1, ordered = 1;
+  int i;
+  ConfidenceInterval interval, entropyInterval, miInterval, cmiInterval, repeat;
+
+  interval = calcMutualInformationBootstrap(firstVector,secondVector,vectorLength,50,1.5,7);
+  failures += checkClose("calcMutualInformationBootstrap confidence above 1",interval.upper - interval.lower,0.0);
+  interval = calcEntropyBootstrap(firstVector,vectorLength,50,0.0,7);
+  failures += checkClose("calcEntropyBootstrap confidence 0",interval.upper - interval.lower,0.0);
+  failures += checkClose("calcEntropyBootstrap confidence 0 estimate",interval.estimate,calcEntropy(firstVector,vectorLength));
+  interval = calcConditionalMutualInformationBootstrap(firstVector,secondVector,thirdVector,vectorLength,50,-0.5,7);
+  failures += checkClose("calcConditionalMutualInformationBootstrap negative confidence",interval.upper - interval.lower,0.0);
+
+  entropyInterval = calcEntropyBootstrap(firstVector,vectorLength,200,0.95,7);
+  miInterval = calcMutualInformationBootstrap(firstVector,secondVector,vectorLength,200,0.95,7);
+  cmiInterval = calcConditionalMutualInformationBootstrap(firstVector,secondVector,thirdVector,vectorLength,200,0.95,7);
+  failures += checkClose("calcEntropyBootstrap estimate",entropyInterval.estimate,calcEntropy(firstVector,vectorLength));
+  failures += checkClose("calcMutualInformationBootstrap estimate",miInterval.estimate,
+                         calcMutualInformation(firstVector,secondVector,vectorLength));
+  failures += checkClose("calcConditionalMutualInformationBootstrap estimate",cmiInterval.estimate,
+                         calcConditionalMutualInformation(firstVector,secondVector,thirdVector,vectorLength));
+
+  /* the plug-in estimate sits inside a 95% interval on 2000 samples, and
+  ** the interval is not degenerate */
+  ordered &= (entropyInterval.lower <= entropyInterval.estimate) && (entropyInterval.estimate <= entropyInterval.upper);
+  ordered &= (miInterval.lower <= miInterval.estimate) && (miInterval.estimate <= miInterval.upper);
+  ordered &= (cmiInterval.lower <= cmiInterval.estimate) && (cmiInterval.estimate <= cmiInterval.upper);
+  ordered &= (entropyInterval.lower < entropyInterval.upper) && (miInterval.lower < miInterval.upper);
+  ordered &= (cmiInterval.lower >= 0.0) && (miInterval.lower > 0.0);
+  failures += checkInt("bootstrap interval contains estimate",ordered,1);
+
+  for (i = 0; i < NUM_TEST_THREAD_COUNTS; i++)
+  {
+    setTestThreads(i);
+    repeat = calcMutualInformationBootstrap(firstVector,secondVector,vectorLength,200,0.95,7);
+    sameResult &= (repeat.lower == miInterval.lower) && (repeat.upper == miInterval.upper);
+    repeat = calcConditionalMutualInformationBootstrap(firstVector,secondVector,thirdVector,vectorLength,200,0.95,7);
+    sameResult &= (repeat.lower == cmiInterval.lower) && (repeat.upper == cmiInterval.upper);
+  }
+  failures += checkInt("bootstrap same seed",sameResult,1);
+  repeat = calcMutualInformationBootstrap(firstVector,secondVector,vectorLength,200,0.95,8);
+  failures += checkInt("bootstrap different seed",(repeat.lower != miInterval.lower) || (repeat.upper != miInterval.upper),1);
+
+  return failures;
+}/*testBootstrap(uint *,uint *,uint *,int)*/
+
+/* Copies vector without element skip, the brute force leave-one-out sample. */
+static void leaveOneOut(uint *vector, uint *outputVector, int vectorLength, int skip)
+{
+  int i, k = 0;
+
+  for (i = 0; i < vectorLength; i++)
+  {
+    if (i != skip)
+    {
+      outputVector[k++] = vector[i];
+    }
+  }
+}/*leaveOneOut(uint *,uint *,int,int)*/
+
+/* Counts the distinct states of a variable whose states are below numStates. */
+static double occupiedStates(uint *vector, int numStates, int vectorLength)
+{
+  int i;
+  double occupied = 0.0;
+  char *seen = (char *) calloc(numStates,sizeof(char));
+
+  for (i = 0; i < vectorLength; i++)
+  {
+    if (!seen[vector[i]])
+    {
+      seen[vector[i]] = 1;
+      occupied++;
+    }
+  }
+  free(seen);
+
+  return occupied;
+}/*occupiedStates(uint *,int,int)*/
+
+/* The Miller-Madow corrections in closed form, in nats over log(LOG_BASE).
+** Short vectors leave some of the joint states empty. */
+static int testMillerMadow(uint *firstVector, uint *secondVector, uint *thirdVector, int vectorLength)
+{
+  int failures = 0;
+  int i;
+  double scale = 2.0 * vectorLength * log(LOG_BASE);
+  double mX, mY, mZ, mXY, mXZ, mYZ, mXYZ;
+  uint *xy = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *xz = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *yz = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *xyz = (uint *) calloc(vectorLength,sizeof(uint));
+
+  for (i = 0; i < vectorLength; i++)
+  {
+    xy[i] = firstVector[i] + 6*secondVector[i];
+    xz[i] = firstVector[i] + 6*thirdVector[i];
+    yz[i] = secondVector[i] + 5*thirdVector[i];
+    xyz[i] = xy[i] + 30*thirdVector[i];
+  }
+  mX = occupiedStates(firstVector,6,vectorLength);
+  mY = occupiedStates(secondVector,5,vectorLength);
+  mZ = occupiedStates(thirdVector,3,vectorLength);
+  mXY = occupiedStates(xy,30,vectorLength);
+  mXZ = occupiedStates(xz,18,vectorLength);
+  mYZ = occupiedStates(yz,15,vectorLength);
+  mXYZ = occupiedStates(xyz,90,vectorLength);
+
+  failures += checkClose("calcMillerMadowEntropy",calcMillerMadowEntropy(firstVector,vectorLength),
+                         calcEntropy(firstVector,vectorLength) + (mX - 1.0)/scale);
+  failures += checkClose("calcMillerMadowMutualInformation",calcMillerMadowMutualInformation(firstVector,secondVector,vectorLength),
+                         calcMutualInformation(firstVector,secondVector,vectorLength) + (mX + mY - mXY - 1.0)/scale);
+  failures += checkClose("calcMillerMadowConditionalMutualInformation",
+                         calcMillerMadowConditionalMutualInformation(firstVector,secondVector,thirdVector,vectorLength),
+                         calcConditionalMutualInformation(firstVector,secondVector,thirdVector,vectorLength)
+                         + (mXZ + mYZ - mXYZ - mZ)/scale);
+  failures += checkClose("calcMillerMadowEntropy one sample",calcMillerMadowEntropy(firstVector,1),0.0);
+
+  free(xy);
+  free(xz);
+  free(yz);
+  free(xyz);
+
+  return failures;
+}/*testMillerMadow(uint *,uint *,uint *,int)*/
+
+static int testBiasCorrection(uint *firstVector, uint *secondVector, uint *thirdVector)
+{
+  int failures = 0;
+  int vectorLength = 40;
+  int i;
+  double entropySum = 0.0, miSum = 0.0, cmiSum = 0.0, n = vectorLength;
+  uint *firstLOO = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *secondLOO = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *thirdLOO = (uint *) calloc(vectorLength,sizeof(uint));
+  JointCounts counts;
+
+  for (i = 0; i < vectorLength; i++)
+  {
+    leaveOneOut(firstVector,firstLOO,vectorLength,i);
+    leaveOneOut(secondVector,secondLOO,vectorLength,i);
+    leaveOneOut(thirdVector,thirdLOO,vectorLength,i);
+    entropySum += calcEntropy(firstLOO,vectorLength-1);
+    miSum += calcMutualInformation(firstLOO,secondLOO,vectorLength-1);
+    cmiSum += calcConditionalMutualInformation(firstLOO,secondLOO,thirdLOO,vectorLength-1);
+  }
+
+  failures += checkClose("calcJackknifeEntropy",calcJackknifeEntropy(firstVector,vectorLength),
+                         n*calcEntropy(firstVector,vectorLength) - (n-1)*entropySum/n);
+  failures += checkClose("calcJackknifeMutualInformation",calcJackknifeMutualInformation(firstVector,secondVector,vectorLength),
+                         n*calcMutualInformation(firstVector,secondVector,vectorLength) - (n-1)*miSum/n);
+  failures += checkClose("calcJackknifeConditionalMutualInformation",
+                         calcJackknifeConditionalMutualInformation(firstVector,secondVector,thirdVector,vectorLength),
+                         n*calcConditionalMutualInformation(firstVector,secondVector,thirdVector,vectorLength) - (n-1)*cmiSum/n);
+
+  counts = calculateJointCounts(firstVector,secondVector,thirdVector,vectorLength);
+  failures += checkClose("countsJackknifeConditionalMutualInformation",countsJackknifeConditionalMutualInformation(counts),
+                         calcJackknifeConditionalMutualInformation(firstVector,secondVector,thirdVector,vectorLength));
+  freeJointCounts(counts);
+
+  free(firstLOO);
+  free(secondLOO);
+  free(thirdLOO);
+
+  return failures;
+}/*testBiasCorrection(uint *,uint *,uint *)*/
+
+static int testFoldInformation(unsigned long *seed)
+{
+  int failures = 0;
+  int numSamples = 1000, numFeatures = 5, numFolds = 4;
+  int i, j, k, numTraining;
+  double foldError = 0.0;
+  uint *featureMatrix = (uint *) calloc(numSamples*numFeatures,sizeof(uint));
+  uint *targetVector = (uint *) calloc(numSamples,sizeof(uint));
+  uint *foldVector = (uint *) calloc(numSamples,sizeof(uint));
+  uint *trainingFeature = (uint *) calloc(numSamples,sizeof(uint));
+  uint *trainingTarget = (uint *) calloc(numSamples,sizeof(uint));
+  double *outputMatrix = (double *) calloc(numFolds*numFeatures,sizeof(double));
+
+  fillMatrices(seed,featureMatrix,numFeatures,targetVector,1,4,numSamples);
+  fillVector(seed,NULL,foldVector,numFolds,numSamples);
+
+  calcMutualInformationFoldBatch(featureMatrix,targetVector,foldVector,numSamples,numFeatures,numFolds,outputMatrix);
+  for (j = 0; j < numFeatures; j++)
+  {
+    for (k = 0; k < numFolds; k++)
+    {
+      numTraining = 0;
+      for (i = 0; i < numSamples; i++)
+      {
+        if ((int) foldVector[i] != k)
+        {
+          trainingFeature[numTraining] = featureMatrix[j*numSamples + i];
+          trainingTarget[numTraining++] = targetVector[i];
+        }
+      }
+      foldError = maxError(foldError,outputMatrix[k + numFolds*j],calcMutualInformation(trainingFeature,trainingTarget,numTraining));
+    }
+  }
+  failures += checkClose("calcMutualInformationFoldBatch",foldError,0.0);
+
+  free(featureMatrix);
+  free(targetVector);
+  free(foldVector);
+  free(trainingFeature);
+  free(trainingTarget);
+  free(outputMatrix);
+
+  return failures;
+}/*testFoldInformation(unsigned long *)*/
+
+static int testSegmentedInformation(uint *firstVector, uint *secondVector, uint *segmentVector, int vectorLength)
+{
+  int failures = 0;
+  int numSegments = 3;
+  int i, s, segmentLength;
+  double entropyError = 0.0, miError = 0.0, conditionalError = 0.0;
+  double *entropyVector = (double *) calloc(numSegments,sizeof(double));
+  double *miVector = (double *) calloc(numSegments,sizeof(double));
+  double *conditionalVector = (double *) calloc(numSegments,sizeof(double));
+  uint *firstSegment = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *secondSegment = (uint *) calloc(vectorLength,sizeof(uint));
+
+  calcSegmentedEntropy(firstVector,segmentVector,vectorLength,numSegments,entropyVector);
+  calcSegmentedMutualInformation(firstVector,secondVector,segmentVector,vectorLength,numSegments,miVector);
+  calcSegmentedConditionalEntropy(firstVector,secondVector,segmentVector,vectorLength,numSegments,conditionalVector);
+  for (s = 0; s < numSegments; s++)
+  {
+    segmentLength = 0;
+    for (i = 0; i < vectorLength; i++)
+    {
+      if ((int) segmentVector[i] == s)
+      {
+        firstSegment[segmentLength] = firstVector[i];
+        secondSegment[segmentLength++] = secondVector[i];
+      }
+    }
+    entropyError = maxError(entropyError,entropyVector[s],calcEntropy(firstSegment,segmentLength));
+    miError = maxError(miError,miVector[s],calcMutualInformation(firstSegment,secondSegment,segmentLength));
+    conditionalError = maxError(conditionalError,conditionalVector[s],calcConditionalEntropy(firstSegment,secondSegment,segmentLength));
+  }
+  failures += checkClose("calcSegmentedEntropy",entropyError,0.0);
+  failures += checkClose("calcSegmentedMutualInformation",miError,0.0);
+  failures += checkClose("calcSegmentedConditionalEntropy",conditionalError,0.0);
+
+  free(entropyVector);
+  free(miVector);
+  free(conditionalVector);
+  free(firstSegment);
+  free(secondSegment);
+
+  return failures;
+}/*testSegmentedInformation(uint *,uint *,uint *,int)*/
+
+/* An arity of 3000 is too large for the grouped histograms, so it is counted pair by pair. */
+static int testMultiTargetInformation(unsigned long *seed, int numStates)
+{
+  int failures = 0;
+  int numSamples = 1000, numFeatures = 5, numTargets = 3;
+  int j, t;
+  double multiError = 0.0, batchError = 0.0;
+  uint *featureMatrix = (uint *) calloc(numSamples*numFeatures,sizeof(uint));
+  uint *targetMatrix = (uint *) calloc(numSamples*numTargets,sizeof(uint));
+  uint *targetVectors[3];
+  double *outputVector = (double *) calloc(numTargets,sizeof(double));
+  double *outputMatrix = (double *) calloc(numFeatures*numTargets,sizeof(double));
+  char name[64];
+
+  fillMatrices(seed,featureMatrix,numFeatures,targetMatrix,numTargets,numStates,numSamples);
+  for (t = 0; t < numTargets; t++)
+  {
+    targetVectors[t] = targetMatrix + t*numSamples;
+  }
+
+  calcMutualInformationMultiTarget(featureMatrix,targetVectors,numTargets,numSamples,outputVector);
+  for (t = 0; t < numTargets; t++)
+  {
+    multiError = maxError(multiError,outputVector[t],calcMutualInformation(featureMatrix,targetVectors[t],numSamples));
+  }
+  sprintf(name,"calcMutualInformationMultiTarget arity %d",numStates);
+  failures += checkClose(name,multiError,0.0);
+
+  calcMutualInformationMultiTargetBatch(featureMatrix,targetMatrix,numSamples,numFeatures,numTargets,outputMatrix);
+  for (j = 0; j < numFeatures; j++)
+  {
+    for (t = 0; t < numTargets; t++)
+    {
+      batchError = maxError(batchError,outputMatrix[j + numFeatures*t],
+                            calcMutualInformation(featureMatrix+j*numSamples,targetVectors[t],numSamples));
+    }
+  }
+  sprintf(name,"calcMutualInformationMultiTargetBatch arity %d",numStates);
+  failures += checkClose(name,batchError,0.0);
+
+  free(featureMatrix);
+  free(targetMatrix);
+  free(outputVector);
+  free(outputMatrix);
+
+  return failures;
+}/*testMultiTargetInformation(unsigned long *,int)*/
+
+static int testPairwiseInformation(unsigned long *seed, int numStates)
+{
+  int failures = 0;
+  int numSamples = 1000, numFeatures = 5;
+  int j, k;
+  double pairError = 0.0;
+  uint *featureMatrix = (uint *) calloc(numSamples*numFeatures,sizeof(uint));
+  uint *targetVector = (uint *) calloc(numSamples,sizeof(uint));
+  double *outputMatrix = (double *) calloc(numFeatures*numFeatures,sizeof(double));
+  char name[64];
+
+  fillMatrices(seed,featureMatrix,numFeatures,targetVector,1,numStates,numSamples);
+
+  calcPairwiseMutualInformation(featureMatrix,numSamples,numFeatures,outputMatrix);
+  for (j = 0; j < numFeatures; j++)
+  {
+    for (k = 0; k < numFeatures; k++)
+    {
+      pairError = maxError(pairError,outputMatrix[j + numFeatures*k],
+                           calcMutualInformation(featureMatrix+j*numSamples,featureMatrix+k*numSamples,numSamples));
+    }
+  }
+  sprintf(name,"calcPairwiseMutualInformation arity %d",numStates);
+  failures += checkClose(name,pairError,0.0);
+
+  free(featureMatrix);
+  free(targetVector);
+  free(outputMatrix);
+
+  return failures;
+}/*testPairwiseInformation(unsigned long *,int)*/
+
+static int testChowLiuTree(unsigned long *seed)
+{
+  int failures = 0;
+  int numSamples = 500, numFeatures = 9;
+  int j, validParents = 1;
+  double primWeight, boruvkaWeight, edgeWeight = 0.0;
+  uint *featureMatrix = (uint *) calloc(numSamples*numFeatures,sizeof(uint));
+  int *primParents = (int *) calloc(numFeatures,sizeof(int));
+  int *boruvkaParents = (int *) calloc(numFeatures,sizeof(int));
+
+  fillVector(seed,NULL,featureMatrix,4,numSamples);
+  for (j = 1; j < numFeatures; j++)
+  {
+    fillVector(seed,featureMatrix+(j/2)*numSamples,featureMatrix+j*numSamples,4,numSamples);
+  }
+
+  primWeight = calcChowLiuTree(featureMatrix,numSamples,numFeatures,primParents);
+  boruvkaWeight = calcChowLiuTreeStreaming(featureMatrix,numSamples,numFeatures,2,boruvkaParents);
+  for (j = 1; j < numFeatures; j++)
+  {
+    if ((primParents[j] < 0) || (primParents[j] >= numFeatures))
+    {
+      validParents = 0;
+    }
+    else
+    {
+      edgeWeight += calcMutualInformation(featureMatrix+j*numSamples,featureMatrix+primParents[j]*numSamples,numSamples);
+    }
+  }
+
+  failures += checkInt("calcChowLiuTree root",primParents[0],-1);
+  failures += checkInt("calcChowLiuTree parents",validParents,1);
+  failures += checkClose("calcChowLiuTree weight",primWeight,edgeWeight);
+  failures += checkInt("calcChowLiuTreeStreaming root",boruvkaParents[0],-1);
+  failures += checkClose("calcChowLiuTreeStreaming weight",boruvkaWeight,primWeight);
+
+  free(featureMatrix);
+  free(primParents);
+  free(boruvkaParents);
+
+  return failures;
+}/*testChowLiuTree(unsigned long *)*/
+
+static int testMultiInformation(uint *firstVector, uint *secondVector, uint *thirdVector, int vectorLength)
+{
+  int failures = 0;
+  int i;
+  double sums[3];
+  uint *dataMatrix = (uint *) calloc(3*vectorLength,sizeof(uint));
+  uint *mergedVector = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *allVector = (uint *) calloc(vectorLength,sizeof(uint));
+
+  for (i = 0; i < vectorLength; i++)
+  {
+    dataMatrix[i] = firstVector[i];
+    dataMatrix[vectorLength + i] = secondVector[i];
+    dataMatrix[2*vectorLength + i] = thirdVector[i];
+  }
+  mergeArrays(firstVector,secondVector,mergedVector,vectorLength);
+  mergeArrays(mergedVector,thirdVector,allVector,vectorLength);
+
+  failures += checkClose("calcMultiInformation two variables",calcMultiInformation(dataMatrix,vectorLength,2),
+                         calcMutualInformation(firstVector,secondVector,vectorLength));
+  failures += checkClose("calcMultiInformation",calcMultiInformation(dataMatrix,vectorLength,3),
+                         calcEntropy(firstVector,vectorLength) + calcEntropy(secondVector,vectorLength)
+                         + calcEntropy(thirdVector,vectorLength) - calcEntropy(allVector,vectorLength));
+
+  failures += checkClose("calcInteractionInformation two variables",calcInteractionInformation(dataMatrix,vectorLength,2),
+                         calcMutualInformation(firstVector,secondVector,vectorLength));
+  failures += checkClose("calcInteractionInformation",calcInteractionInformation(dataMatrix,vectorLength,3),
+                         calcMutualInformation(firstVector,secondVector,vectorLength)
+                         - calcConditionalMutualInformation(firstVector,secondVector,thirdVector,vectorLength));
+
+  calcSubsetEntropySums(dataMatrix,vectorLength,3,sums);
+  failures += checkClose("calcSubsetEntropySums singles",sums[0],calcEntropy(firstVector,vectorLength)
+                         + calcEntropy(secondVector,vectorLength) + calcEntropy(thirdVector,vectorLength));
+  failures += checkClose("calcSubsetEntropySums pairs",sums[1],calcJointEntropy(firstVector,secondVector,vectorLength)
+                         + calcJointEntropy(firstVector,thirdVector,vectorLength)
+                         + calcJointEntropy(secondVector,thirdVector,vectorLength));
+  failures += checkClose("calcSubsetEntropySums all",sums[2],calcEntropy(allVector,vectorLength));
+
+  free(dataMatrix);
+  free(mergedVector);
+  free(allVector);
+
+  return failures;
+}/*testMultiInformation(uint *,uint *,uint *,int)*/
+
+/* Widens each variable to around 60 states, so the three way histogram has
+** too many cells to be dense. */
+static int testSparseMultiInformation(uint *firstVector, uint *secondVector, uint *thirdVector, int vectorLength)
+{
+  int failures;
+  int i;
+  uint *wideFirst = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *wideSecond = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *wideThird = (uint *) calloc(vectorLength,sizeof(uint));
+
+  for (i = 0; i < vectorLength; i++)
+  {
+    wideFirst[i] = firstVector[i] + 6*(i % 10);
+    wideSecond[i] = secondVector[i] + 5*(i % 13);
+    wideThird[i] = thirdVector[i] + 3*(i % 17);
+  }
+  failures = testMultiInformation(wideFirst,wideSecond,wideThird,vectorLength);
+
+  free(wideFirst);
+  free(wideSecond);
+  free(wideThird);
+
+  return failures;
+}/*testSparseMultiInformation(uint *,uint *,uint *,int)*/
+
+static int testTimeSeriesInformation(uint *sourceVector, uint *noiseVector, int vectorLength)
+{
+  int failures = 0;
+  int maxLag = 5, delay = 3;
+  int i, lag;
+  double sweepError = 0.0;
+  double *outputVector = (double *) calloc(maxLag,sizeof(double));
+  uint *historyVector = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *targetVector = (uint *) calloc(vectorLength,sizeof(uint));
+
+  /* The target is the source delayed by 3 steps, with noise. */
+  for (i = 0; i < vectorLength; i++)
+  {
+    targetVector[i] = (i >= delay) ? (sourceVector[i-delay] + (noiseVector[i] % 2)) % 6 : noiseVector[i];
+  }
+
+  calcLaggedMutualInformationSweep(sourceVector,targetVector,vectorLength,maxLag,outputVector);
+  for (lag = 1; lag <= maxLag; lag++)
+  {
+    sweepError = maxError(sweepError,outputVector[lag-1],calcMutualInformation(sourceVector,targetVector+lag,vectorLength-lag));
+  }
+  failures += checkClose("calcLaggedMutualInformationSweep",sweepError,0.0);
+  failures += checkClose("calcLaggedMutualInformation",calcLaggedMutualInformation(sourceVector,targetVector,vectorLength,delay),
+                         calcMutualInformation(sourceVector,targetVector+delay,vectorLength-delay));
+
+  /* TE with a source lag of 3 and a history of 2 is I(Y_t;X_{t-3}|Y_{t-1},Y_{t-2}) for t >= 3. */
+  mergeArrays(targetVector+delay-1,targetVector+delay-2,historyVector,vectorLength-delay);
+  failures += checkClose("calcTransferEntropy",calcTransferEntropy(sourceVector,targetVector,vectorLength,delay,2),
+                         calcConditionalMutualInformation(targetVector+delay,sourceVector,historyVector,vectorLength-delay));
+  failures += checkClose("calcTransferEntropy invalid lag",calcTransferEntropy(sourceVector,targetVector,vectorLength,0,2),0.0);
+
+  free(outputVector);
+  free(historyVector);
+  free(targetVector);
+
+  return failures;
+}/*testTimeSeriesInformation(uint *,uint *,int)*/
+
+/* Checks each function against brute force recalculation with the basic functions. */
+static int runChecks(void)
+{
+  int failures = 0;
+  int vectorLength = 2000;
+  unsigned long seed = 42;
+  uint *firstVector = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *secondVector = (uint *) calloc(vectorLength,sizeof(uint));
+  uint *thirdVector = (uint *) calloc(vectorLength,sizeof(uint));
+
+  fillVector(&seed,NULL,firstVector,6,vectorLength);
+  fillVector(&seed,firstVector,secondVector,5,vectorLength);
+  fillVector(&seed,secondVector,thirdVector,3,vectorLength);
+
+  failures += testJointCounts(firstVector,secondVector,thirdVector,vectorLength);
+  failures += testOnlineInformation(firstVector,secondVector,thirdVector,vectorLength);
+  failures += testDiscreteMatrix();
+  failures += testDataReader();
+  failures += testSparseMatrix(&seed);
+  failures += testInstrumentation(firstVector,secondVector,thirdVector,vectorLength);
+  failures += testKernelVariants(firstVector,secondVector,thirdVector,vectorLength);
+  failures += testMultiAlphaRenyi(firstVector,secondVector,vectorLength);
+  failures += testSpecialRenyi(firstVector,secondVector,vectorLength);
+  failures += testWeightedWorkspace(&seed,firstVector,secondVector,thirdVector,vectorLength);
+  failures += testWeightedMIBatch(&seed,firstVector,secondVector,thirdVector,vectorLength);
+  failures += testCompactMerge(firstVector,secondVector,thirdVector,vectorLength);
+  failures += testBatchInformation(&seed);
+  failures += testPermutationTest(&seed,firstVector,secondVector,vectorLength);
+  failures += testBootstrap(firstVector,secondVector,thirdVector,vectorLength);
+  failures += testBiasCorrection(firstVector,secondVector,thirdVector);
+  failures += testMillerMadow(firstVector,secondVector,thirdVector,vectorLength);
+  failures += testMillerMadow(firstVector,secondVector,thirdVector,20);
+  failures += testFoldInformation(&seed);
+  failures += testSegmentedInformation(firstVector,secondVector,thirdVector,vectorLength);
+  failures += testMultiTargetInformation(&seed,4);
+  failures += testMultiTargetInformation(&seed,3000);
+  failures += testPairwiseInformation(&seed,4);
+  failures += testPairwiseInformation(&seed,3000);
+  failures += testChowLiuTree(&seed);
+  failures += testMultiInformation(firstVector,secondVector,thirdVector,vectorLength);
+  failures += testSparseMultiInformation(firstVector,secondVector,thirdVector,vectorLength);
+  failures += testTimeSeriesInformation(firstVector,secondVector,vectorLength);
+
+  free(firstVector);
+  free(secondVector);
+  free(thirdVector);
+
+  return failures;
+}/*runChecks(void)*/
+
+int main(int argc, char *argv[])
+{
+  int i, failures = 0;
   double length, miTarget, entropyTarget, cmiTarget;
   double firstEntropy, secondEntropy, thirdEntropy, targetEntropy;
   double firstMItarget, secondMItarget, thirdMItarget, targetMItarget;
@@ -87,4 +1530,9 @@ int main(int argc, char *argv[])
   length = length + (end.tv_usec - start.tv_usec) / 1000000.0;
   
   printf("Time taken for a thousand I(X;Y), H(X), I(X;Y|Z), merge(X,Y) is %lf seconds\n",length);
+
+  failures += runChecks();
+  printf("%d checks failed\n",failures);
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }/*main(int, char **)*/